@@ -0,0 +1,191 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "bench.h"
+
+bench_format_t bench_format = BENCH_JSON;
+unsigned long bench_seed = 88172645463325252UL;
+
+/*
+ * auxiliar function;
+ * monotonic time in nanoseconds
+ */
+double bench_now (void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1e9 + ts.tv_nsec;
+}
+
+/*
+ * auxiliar function;
+ * compares two doubles for qsort
+ */
+int bench_compare (const void* a, const void* b)
+{
+	double x = *(const double*)a, y = *(const double*)b;
+	return (x > y) - (x < y);
+}
+
+/*
+ * auxiliar function;
+ * the `q` quantile of the sorted samples of `b`
+ */
+double bench_percentile (bench_t* b, double q)
+{
+	if( !b->n_samples ) return 0.0;
+	return b->samples[(size_t)(q*(b->n_samples - 1) + 0.5)];
+}
+
+/*
+ * auxiliar function;
+ * restarts the peak resident memory of the process from the
+ * memory resident now, so `ru_maxrss` at `bench_end` is the
+ * peak of one benchmark. This is Linux only; elsewhere the
+ * peak stays the one of the process of the configuration.
+ */
+void bench_reset_peak_rss (void)
+{
+	FILE* f = fopen("/proc/self/clear_refs", "w");
+
+	if( !f ) return;
+	fputs("5", f);
+	fclose(f);
+}
+
+/** Starts the benchmark `b` of the operation `op` of `suite`
+  * over `n` elements of `member_size` bytes.
+  */
+void bench_begin (bench_t* b, const char* suite, const char* op, size_t member_size, size_t n)
+{
+	b->suite = suite;
+	b->op = op;
+	b->member_size = member_size;
+	b->n = n;
+	b->n_samples = 0;
+	b->capacity = 1024;
+	b->samples = (double*) malloc(b->capacity*sizeof(double));
+	b->total_ns = 0.0;
+	b->total_ops = 0;
+
+	bench_reset_peak_rss();
+}
+
+/** Starts a sample of `b`.
+  */
+void bench_start (bench_t* b)
+{
+	b->start = bench_now();
+}
+
+/** Ends the sample of `b` started by `bench_start`, that ran
+  * `ops` operations.
+  */
+void bench_stop (bench_t* b, size_t ops)
+{
+	double ns = bench_now() - b->start;
+
+	if( !ops ) return;
+	if( b->n_samples == b->capacity ){
+		b->capacity *= 2;
+		b->samples = (double*) realloc(b->samples, b->capacity*sizeof(double));
+	}
+
+	b->samples[b->n_samples++] = ns/ops;
+	b->total_ns += ns;
+	b->total_ops += ops;
+}
+
+/** Prints the header of the CSV format.
+  */
+void bench_print_header (void)
+{
+	if( bench_format == BENCH_CSV )
+		printf("suite,op,member_size,n,ops,ops_per_sec,"
+			"ns_p50,ns_p90,ns_p99,ns_max,peak_rss_kb\n");
+}
+
+/** Prints the report of `b` and frees its samples.
+  */
+void bench_end (bench_t* b)
+{
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	qsort(b->samples, b->n_samples, sizeof(double), bench_compare);
+
+	double ops_per_sec = b->total_ns > 0.0? b->total_ops*1e9/b->total_ns : 0.0;
+	double p50 = bench_percentile(b, 0.50);
+	double p90 = bench_percentile(b, 0.90);
+	double p99 = bench_percentile(b, 0.99);
+	double max = bench_percentile(b, 1.0);
+
+	if( bench_format == BENCH_CSV )
+		printf("%s,%s,%lu,%lu,%lu,%.0f,%.2f,%.2f,%.2f,%.2f,%ld\n",
+			b->suite, b->op,
+			(unsigned long)b->member_size, (unsigned long)b->n,
+			(unsigned long)b->total_ops, ops_per_sec,
+			p50, p90, p99, max, usage.ru_maxrss);
+	else
+		printf("{\"suite\":\"%s\",\"op\":\"%s\",\"member_size\":%lu,\"n\":%lu,"
+			"\"ops\":%lu,\"ops_per_sec\":%.0f,\"ns_p50\":%.2f,\"ns_p90\":%.2f,"
+			"\"ns_p99\":%.2f,\"ns_max\":%.2f,\"peak_rss_kb\":%ld}\n",
+			b->suite, b->op,
+			(unsigned long)b->member_size, (unsigned long)b->n,
+			(unsigned long)b->total_ops, ops_per_sec,
+			p50, p90, p99, max, usage.ru_maxrss);
+	fflush(stdout);
+
+	free(b->samples);
+	b->samples = NULL;
+}
+
+/** Returns a pseudo-random number (xorshift), the sequence is
+  * the same on every run.
+  */
+unsigned long bench_random (void)
+{
+	bench_seed ^= bench_seed << 13;
+	bench_seed ^= bench_seed >> 7;
+	bench_seed ^= bench_seed << 17;
+	return bench_seed;
+}
+
+/** Allocates an element of `member_size` bytes whose first bytes
+  * hold `key`, the compare functions of the suites read it.
+  */
+void* bench_element (size_t member_size, unsigned int key)
+{
+	void* e = calloc(1, member_size);
+	memcpy(e, &key, sizeof(key));
+	return e;
+}
+
+/** Keeps the compiler from removing the computation of the
+  * memory pointed by `p`.
+  */
+void bench_clobber (void* p)
+{
+	__asm__ __volatile__("" : : "r"(p) : "memory");
+}
@@ -0,0 +1,80 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#ifndef __BENCH_H__
+#define __BENCH_H__
+#include <stdlib.h>
+
+/*
+ * Microbenchmark harness of libgenerics.
+ *
+ * A benchmark times its operations in samples of up to
+ * BENCH_BATCH operations; the report has the throughput and the
+ * percentiles of the nanoseconds per operation of the samples,
+ * and the peak resident memory of the process. Every suite runs
+ * in its own process, so the peak is the one of the suite.
+ */
+
+#define BENCH_BATCH 64
+
+typedef enum bench_format_t{
+	BENCH_JSON,	/* one JSON object by line */
+	BENCH_CSV
+}bench_format_t;
+
+typedef struct bench_t{
+	const char* suite;
+	const char* op;
+	size_t member_size;
+	size_t n;
+
+	double* samples;
+	size_t n_samples;
+	size_t capacity;
+
+	double total_ns;
+	size_t total_ops;
+	double start;
+}bench_t;
+
+/*
+ * a suite runs its benchmarks with elements of `member_size`
+ * bytes and a working set of about `bytes` bytes
+ */
+typedef void (*bench_suite_function)(size_t member_size, size_t bytes);
+
+extern bench_format_t bench_format;
+
+void bench_begin(bench_t* b, const char* suite, const char* op, size_t member_size, size_t n);
+void bench_start(bench_t* b);
+void bench_stop(bench_t* b, size_t ops);
+void bench_end(bench_t* b);
+void bench_print_header(void);
+unsigned long bench_random(void);
+void* bench_element(size_t member_size, unsigned int key);
+void bench_clobber(void* p);
+
+void bench_vector(size_t member_size, size_t bytes);
+void bench_queue(size_t member_size, size_t bytes);
+void bench_stack(size_t member_size, size_t bytes);
+void bench_pqueue(size_t member_size, size_t bytes);
+void bench_trie(size_t member_size, size_t bytes);
+void bench_hashmap(size_t member_size, size_t bytes);
+void bench_graph(size_t member_size, size_t bytes);
+
+#endif
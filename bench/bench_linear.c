@@ -0,0 +1,279 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#include <string.h>
+
+#include "bench.h"
+#include "vector.h"
+#include "vector_algorithm.h"
+#include "queue.h"
+#include "stack.h"
+
+/*
+ * auxiliar function;
+ * number of elements of `member_size` bytes in `bytes`
+ */
+size_t bench_n_elements (size_t member_size, size_t bytes)
+{
+	size_t n = bytes/member_size;
+	return n? n : 1;
+}
+
+/*
+ * auxiliar function;
+ * vector_find of a missing element, vector_min_max and
+ * vector_sort of the `n` int64 elements of `v`, every sample
+ * is one call
+ */
+void bench_vector_kernels (vector_t* v, size_t n)
+{
+	int64_t* data = (int64_t*) v->data;
+	int64_t missing = -1, min, max;
+	size_t i, index;
+	bench_t b;
+
+	memset(data, 0, n*8);
+	bench_begin(&b, "vector", "find_int64", 8, n);
+	bench_start(&b);
+	vector_find(v, &missing, &index);
+	bench_stop(&b, n);
+	bench_end(&b);
+
+	bench_begin(&b, "vector", "min_max_int64", 8, n);
+	for( i=0; i<n; i++ )
+		data[i] = (int64_t) bench_random();
+	bench_start(&b);
+	vector_min_max(v, VECTOR_INT64, NULL, NULL, &min, &max);
+	bench_clobber(&min);
+	bench_stop(&b, n);
+	bench_end(&b);
+
+	bench_begin(&b, "vector", "sort_int64", 8, n);
+	bench_start(&b);
+	vector_sort(v, VECTOR_INT64, NULL, NULL);
+	bench_clobber(data);
+	bench_stop(&b, n);
+	bench_end(&b);
+}
+
+/** vector_add, vector_at at random positions and
+  * vector_ptr_at in order.
+  */
+void bench_vector (size_t member_size, size_t bytes)
+{
+	size_t n = bench_n_elements(member_size, bytes);
+	void* e = bench_element(member_size, 1);
+	size_t* index = (size_t*) malloc(n*sizeof(size_t));
+	size_t i, j;
+	vector_t v;
+	bench_t b;
+
+	for( i=0; i<n; i++ )
+		index[i] = bench_random() % n;
+
+	vector_create(&v, 0, member_size);
+
+	bench_begin(&b, "vector", "add", member_size, n);
+	for( i=0; i<n; i+=BENCH_BATCH ){
+		size_t m = n - i < BENCH_BATCH? n - i : BENCH_BATCH;
+		bench_start(&b);
+		for( j=0; j<m; j++ )
+			vector_add(&v, e);
+		bench_stop(&b, m);
+	}
+	bench_end(&b);
+
+	bench_begin(&b, "vector", "at_random", member_size, n);
+	for( i=0; i<n; i+=BENCH_BATCH ){
+		size_t m = n - i < BENCH_BATCH? n - i : BENCH_BATCH;
+		bench_start(&b);
+		for( j=0; j<m; j++ )
+			vector_at(&v, index[i+j], e);
+		bench_clobber(e);
+		bench_stop(&b, m);
+	}
+	bench_end(&b);
+
+	bench_begin(&b, "vector", "ptr_at_sequential", member_size, n);
+	for( i=0; i<n; i+=BENCH_BATCH ){
+		size_t m = n - i < BENCH_BATCH? n - i : BENCH_BATCH;
+		unsigned long sum = 0;
+		bench_start(&b);
+		for( j=0; j<m; j++ )
+			sum += *(unsigned char*)vector_ptr_at(&v, i+j);
+		bench_clobber(&sum);
+		bench_stop(&b, m);
+	}
+	bench_end(&b);
+
+	if( member_size == 8 )
+		bench_vector_kernels(&v, n);
+
+	vector_destroy(&v);
+	free(index);
+	free(e);
+}
+
+/*
+ * auxiliar function;
+ * enqueues and dequeues `n` elements of the queue `q`
+ */
+void bench_queue_ops (queue_t* q, const char* suite, size_t member_size, size_t n)
+{
+	void* e = bench_element(member_size, 1);
+	size_t i, j;
+	bench_t b;
+
+	bench_begin(&b, suite, "enqueue", member_size, n);
+	for( i=0; i<n; i+=BENCH_BATCH ){
+		size_t m = n - i < BENCH_BATCH? n - i : BENCH_BATCH;
+		bench_start(&b);
+		for( j=0; j<m; j++ )
+			queue_enqueue(q, e);
+		bench_stop(&b, m);
+	}
+	bench_end(&b);
+
+	bench_begin(&b, suite, "dequeue", member_size, n);
+	for( i=0; i<n; i+=BENCH_BATCH ){
+		size_t m = n - i < BENCH_BATCH? n - i : BENCH_BATCH;
+		bench_start(&b);
+		for( j=0; j<m; j++ )
+			queue_dequeue(q, e);
+		bench_clobber(e);
+		bench_stop(&b, m);
+	}
+	bench_end(&b);
+
+	free(e);
+}
+
+/*
+ * auxiliar function;
+ * enqueues and dequeues `n` elements of `member_size` bytes
+ * that embed their qnode_t, in an intrusive queue
+ */
+void bench_queue_intrusive (size_t member_size, size_t n)
+{
+	size_t stride = (sizeof(qnode_t) + member_size + sizeof(void*) - 1)
+			& ~(sizeof(void*) - 1);
+	char* elements = (char*) malloc(n*stride);
+	void* e = NULL;
+	size_t i, j;
+	queue_t q;
+	bench_t b;
+
+	for( i=0; i<n; i++ )
+		memset(elements + i*stride + sizeof(qnode_t), 1, member_size);
+
+	queue_create_intrusive(&q, 0);
+
+	bench_begin(&b, "queue_intrusive", "enqueue", member_size, n);
+	for( i=0; i<n; i+=BENCH_BATCH ){
+		size_t m = n - i < BENCH_BATCH? n - i : BENCH_BATCH;
+		bench_start(&b);
+		for( j=0; j<m; j++ )
+			queue_enqueue(&q, elements + (i + j)*stride);
+		bench_stop(&b, m);
+	}
+	bench_end(&b);
+
+	bench_begin(&b, "queue_intrusive", "dequeue", member_size, n);
+	for( i=0; i<n; i+=BENCH_BATCH ){
+		size_t m = n - i < BENCH_BATCH? n - i : BENCH_BATCH;
+		bench_start(&b);
+		for( j=0; j<m; j++ )
+			queue_dequeue(&q, &e);
+		bench_clobber(e);
+		bench_stop(&b, m);
+	}
+	bench_end(&b);
+
+	queue_destroy(&q);
+	free(elements);
+}
+
+/** queue_enqueue and queue_dequeue of the linked, of the
+  * ring and of the intrusive queue.
+  */
+void bench_queue (size_t member_size, size_t bytes)
+{
+	size_t n = bench_n_elements(member_size, bytes);
+	queue_t q;
+
+	queue_create(&q, member_size);
+	bench_queue_ops(&q, "queue", member_size, n);
+	queue_destroy(&q);
+
+	queue_create_ring(&q, member_size, 0);
+	bench_queue_ops(&q, "queue_ring", member_size, n);
+	queue_destroy(&q);
+
+	bench_queue_intrusive(member_size, n);
+}
+
+/*
+ * auxiliar function;
+ * pushes and pops `n` elements of the stack `s`
+ */
+void bench_stack_ops (stack_t* s, const char* suite, size_t member_size, size_t n)
+{
+	void* e = bench_element(member_size, 1);
+	size_t i, j;
+	bench_t b;
+
+	bench_begin(&b, suite, "push", member_size, n);
+	for( i=0; i<n; i+=BENCH_BATCH ){
+		size_t m = n - i < BENCH_BATCH? n - i : BENCH_BATCH;
+		bench_start(&b);
+		for( j=0; j<m; j++ )
+			stack_push(s, e);
+		bench_stop(&b, m);
+	}
+	bench_end(&b);
+
+	bench_begin(&b, suite, "pop", member_size, n);
+	for( i=0; i<n; i+=BENCH_BATCH ){
+		size_t m = n - i < BENCH_BATCH? n - i : BENCH_BATCH;
+		bench_start(&b);
+		for( j=0; j<m; j++ )
+			stack_pop(s, e);
+		bench_clobber(e);
+		bench_stop(&b, m);
+	}
+	bench_end(&b);
+
+	free(e);
+}
+
+/** stack_push and stack_pop of the linked and of the array
+  * stack.
+  */
+void bench_stack (size_t member_size, size_t bytes)
+{
+	size_t n = bench_n_elements(member_size, bytes);
+	stack_t s;
+
+	stack_create(&s, member_size);
+	bench_stack_ops(&s, "stack", member_size, n);
+	stack_destroy(&s);
+
+	stack_create_array(&s, member_size, 0);
+	bench_stack_ops(&s, "stack_array", member_size, n);
+	stack_destroy(&s);
+}
@@ -0,0 +1,374 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "priority_queue.h"
+#include "trie.h"
+#include "hashmap.h"
+#include "graph.h"
+#include "graph_search.h"
+#include "graph_reorder.h"
+
+#define BENCH_GRAPH_DEGREE 8
+#define BENCH_TRIE_DENSE_MAX 16384
+#define BENCH_KEY_SIZE 48
+
+/*
+ * auxiliar function;
+ * compares the keys written by `bench_element`
+ */
+int bench_key_compare (void* a, void* b, void* arg)
+{
+	unsigned int x, y;
+
+	(void) arg;
+	memcpy(&x, a, sizeof(x));
+	memcpy(&y, b, sizeof(y));
+	return (x > y) - (x < y);
+}
+
+/*
+ * auxiliar function;
+ * pqueue_add of `n` random keys in `p` and pqueue_extract of
+ * all of them
+ */
+void bench_pqueue_ops (pqueue_t* p, const char* suite, size_t member_size, size_t n)
+{
+	void* e = bench_element(member_size, 0);
+	size_t i, j;
+	bench_t b;
+
+	pqueue_set_compare_function(p, bench_key_compare, NULL);
+
+	bench_begin(&b, suite, "add", member_size, n);
+	for( i=0; i<n; i+=BENCH_BATCH ){
+		size_t m = n - i < BENCH_BATCH? n - i : BENCH_BATCH;
+		bench_start(&b);
+		for( j=0; j<m; j++ ){
+			*(unsigned int*)e = (unsigned int)bench_random();
+			pqueue_add(p, e);
+		}
+		bench_stop(&b, m);
+	}
+	bench_end(&b);
+
+	bench_begin(&b, suite, "extract", member_size, n);
+	for( i=0; i<n; i+=BENCH_BATCH ){
+		size_t m = n - i < BENCH_BATCH? n - i : BENCH_BATCH;
+		bench_start(&b);
+		for( j=0; j<m; j++ )
+			pqueue_extract(p, e);
+		bench_clobber(e);
+		bench_stop(&b, m);
+	}
+	bench_end(&b);
+
+	free(e);
+}
+
+/** pqueue_add and pqueue_extract of random keys on the heap and
+  * on the pairing heap, then pqueue_add_n and pqueue_extract_n
+  * of batches of them on the heap; the batches are built before
+  * the clock starts.
+  */
+void bench_pqueue (size_t member_size, size_t bytes)
+{
+	size_t n = bytes/member_size? bytes/member_size : 1;
+	char* batch = (char*) malloc(BENCH_BATCH*member_size);
+	size_t i, j;
+	pqueue_t p;
+	bench_t b;
+
+	pqueue_create(&p, member_size);
+	bench_pqueue_ops(&p, "pqueue", member_size, n);
+	pqueue_destroy(&p);
+
+	pqueue_create_pairing(&p, member_size);
+	bench_pqueue_ops(&p, "pqueue_pairing", member_size, n);
+	pqueue_destroy(&p);
+
+	pqueue_create(&p, member_size);
+	pqueue_set_compare_function(&p, bench_key_compare, NULL);
+	memset(batch, 0, BENCH_BATCH*member_size);
+
+	bench_begin(&b, "pqueue", "add_n", member_size, n);
+	for( i=0; i<n; i+=BENCH_BATCH ){
+		size_t m = n - i < BENCH_BATCH? n - i : BENCH_BATCH;
+		for( j=0; j<m; j++ )
+			*(unsigned int*)(batch + j*member_size) = (unsigned int)bench_random();
+		bench_start(&b);
+		pqueue_add_n(&p, batch, m);
+		bench_stop(&b, m);
+	}
+	bench_end(&b);
+
+	bench_begin(&b, "pqueue", "extract_n", member_size, n);
+	for( i=0; i<n; i+=BENCH_BATCH ){
+		size_t m = n - i < BENCH_BATCH? n - i : BENCH_BATCH;
+		bench_start(&b);
+		pqueue_extract_n(&p, batch, m, NULL);
+		bench_clobber(batch);
+		bench_stop(&b, m);
+	}
+	bench_end(&b);
+
+	pqueue_destroy(&p);
+	free(batch);
+}
+
+/*
+ * auxiliar function;
+ * writes in `key` the `i`-th key of the set `set`: "paths" are
+ * hierarchical names sharing long prefixes, "ids" are random
+ * decimal numbers
+ */
+size_t bench_key (char* key, const char* set, size_t i)
+{
+	static const char* kinds[] = { "user", "order", "item", "session", "product" };
+	static const char* regions[] = { "us-east", "us-west", "eu-central", "ap-south" };
+
+	if( !strcmp(set, "paths") )
+		return (size_t) sprintf(key, "/api/v2/%s/%s/%lu/profile",
+				kinds[i % 5], regions[(i/5) % 4], (unsigned long)i);
+
+	return (size_t) sprintf(key, "%lu", (unsigned long)(i*2654435761UL % 4294967291UL));
+}
+
+/*
+ * auxiliar function;
+ * adds `n` keys of `set` to `t` and gets them in random order
+ */
+void bench_trie_ops (trie_t* t, const char* suite, const char* set, size_t member_size, size_t n)
+{
+	void* e = bench_element(member_size, 1);
+	char key[BENCH_KEY_SIZE];
+	char op[32];
+	size_t i, j;
+	bench_t b;
+
+	sprintf(op, "add_%s", set);
+	bench_begin(&b, suite, op, member_size, n);
+	for( i=0; i<n; i+=BENCH_BATCH ){
+		size_t m = n - i < BENCH_BATCH? n - i : BENCH_BATCH;
+		bench_start(&b);
+		for( j=0; j<m; j++ ){
+			size_t size = bench_key(key, set, i+j);
+			trie_add_element(t, key, size, e);
+		}
+		bench_stop(&b, m);
+	}
+	bench_end(&b);
+
+	sprintf(op, "get_%s", set);
+	bench_begin(&b, suite, op, member_size, n);
+	for( i=0; i<n; i+=BENCH_BATCH ){
+		size_t m = n - i < BENCH_BATCH? n - i : BENCH_BATCH;
+		bench_start(&b);
+		for( j=0; j<m; j++ ){
+			size_t size = bench_key(key, set, bench_random() % n);
+			trie_get_element(t, key, size, e);
+		}
+		bench_clobber(e);
+		bench_stop(&b, m);
+	}
+	bench_end(&b);
+
+	/*
+	 * the batch of keys is built before the clock starts,
+	 * trie_get_many needs all of them at once
+	 */
+	char* keys = (char*) malloc(BENCH_BATCH*BENCH_KEY_SIZE);
+	void* pointers[BENCH_BATCH];
+	size_t sizes[BENCH_BATCH];
+	void* out = malloc(BENCH_BATCH*(member_size? member_size : 1));
+
+	sprintf(op, "get_many_%s", set);
+	bench_begin(&b, suite, op, member_size, n);
+	for( i=0; i<n; i+=BENCH_BATCH ){
+		size_t m = n - i < BENCH_BATCH? n - i : BENCH_BATCH;
+		for( j=0; j<m; j++ ){
+			pointers[j] = keys + j*BENCH_KEY_SIZE;
+			sizes[j] = bench_key(pointers[j], set, bench_random() % n);
+		}
+		bench_start(&b);
+		trie_get_many(t, pointers, sizes, m, out, NULL);
+		bench_clobber(out);
+		bench_stop(&b, m);
+	}
+	bench_end(&b);
+
+	free(out);
+	free(keys);
+	free(e);
+}
+
+/** trie_add_element, trie_get_element and trie_get_many of the
+  * adaptive trie and, while it fits, of the dense trie, over two
+  * key sets. The time of building the keys is counted in, but for
+  * trie_get_many.
+  */
+void bench_trie (size_t member_size, size_t bytes)
+{
+	static const char* sets[] = { "paths", "ids" };
+	size_t n = bytes/(member_size + BENCH_KEY_SIZE);
+	size_t k;
+	trie_t t;
+
+	if( !n ) n = 1;
+	for( k=0; k<2; k++ ){
+		trie_create_adaptive(&t, member_size);
+		bench_trie_ops(&t, "trie", sets[k], member_size, n);
+		trie_destroy(&t);
+
+		if( n > BENCH_TRIE_DENSE_MAX ) continue;
+		trie_create(&t, member_size);
+		bench_trie_ops(&t, "trie_dense", sets[k], member_size, n);
+		trie_destroy(&t);
+	}
+}
+
+/** hashmap_add_element and hashmap_get_element over the key sets
+  * of `bench_trie`, the time of building the keys counted in.
+  */
+void bench_hashmap (size_t member_size, size_t bytes)
+{
+	static const char* sets[] = { "paths", "ids" };
+	size_t n = bytes/(member_size + BENCH_KEY_SIZE);
+	void* e = bench_element(member_size, 1);
+	char key[BENCH_KEY_SIZE];
+	char op[32];
+	size_t i, j, k;
+	hashmap_t h;
+	bench_t b;
+
+	if( !n ) n = 1;
+	for( k=0; k<2; k++ ){
+		hashmap_create(&h, BENCH_KEY_SIZE, member_size);
+
+		sprintf(op, "add_%s", sets[k]);
+		bench_begin(&b, "hashmap", op, member_size, n);
+		for( i=0; i<n; i+=BENCH_BATCH ){
+			size_t m = n - i < BENCH_BATCH? n - i : BENCH_BATCH;
+			bench_start(&b);
+			for( j=0; j<m; j++ ){
+				size_t size = bench_key(key, sets[k], i+j);
+				hashmap_add_element(&h, key, size, e);
+			}
+			bench_stop(&b, m);
+		}
+		bench_end(&b);
+
+		sprintf(op, "get_%s", sets[k]);
+		bench_begin(&b, "hashmap", op, member_size, n);
+		for( i=0; i<n; i+=BENCH_BATCH ){
+			size_t m = n - i < BENCH_BATCH? n - i : BENCH_BATCH;
+			bench_start(&b);
+			for( j=0; j<m; j++ ){
+				size_t size = bench_key(key, sets[k], bench_random() % n);
+				hashmap_get_element(&h, key, size, e);
+			}
+			bench_clobber(e);
+			bench_stop(&b, m);
+		}
+		bench_end(&b);
+
+		hashmap_destroy(&h);
+	}
+
+	free(e);
+}
+
+/*
+ * auxiliar function;
+ * times a traversal of `g` from the vertex 0 for `repeat`
+ * times, every sample is one traversal of `n_ops` edges
+ */
+void bench_graph_traversal (graph_t* g, const char* op, int dfs, size_t member_size, size_t n_ops)
+{
+	size_t* distance = (size_t*) malloc(g->V*sizeof(size_t));
+	size_t* parent = (size_t*) malloc(g->V*sizeof(size_t));
+	size_t repeat = n_ops < 1000000? 16 : 4;
+	size_t i;
+	bench_t b;
+
+	bench_begin(&b, "graph", op, member_size, g->V);
+	for( i=0; i<repeat; i++ ){
+		bench_start(&b);
+		if( dfs )
+			graph_dfs(g, 0, parent, NULL, NULL);
+		else
+			graph_bfs(g, 0, distance, parent, NULL, NULL);
+		bench_clobber(parent);
+		bench_stop(&b, n_ops);
+	}
+	bench_end(&b);
+
+	free(distance);
+	free(parent);
+}
+
+/** graph_add_edge of random edges, BFS and DFS over the
+  * adjacency queues, BFS over the frozen graph and BFS after
+  * the reverse Cuthill-McKee reordering. The traversals are
+  * reported by edge.
+  */
+void bench_graph (size_t member_size, size_t bytes)
+{
+	size_t n = bytes/(member_size + BENCH_GRAPH_DEGREE*sizeof(graph_edge_t));
+	size_t n_edges, i, j;
+	graph_t g;
+	bench_t b;
+
+	if( n < 2 ) n = 2;
+	n_edges = n*BENCH_GRAPH_DEGREE;
+	graph_create(&g, n, member_size);
+
+	bench_begin(&b, "graph", "add_edge", member_size, n);
+	for( i=0; i<n_edges; i+=BENCH_BATCH ){
+		size_t m = n_edges - i < BENCH_BATCH? n_edges - i : BENCH_BATCH;
+		bench_start(&b);
+		for( j=0; j<m; j++ )
+			graph_add_edge(&g, (i+j) % n, bench_random() % n);
+		bench_stop(&b, m);
+	}
+	bench_end(&b);
+
+	bench_graph_traversal(&g, "bfs", 0, member_size, n_edges);
+	bench_graph_traversal(&g, "dfs", 1, member_size, n_edges);
+
+	bench_begin(&b, "graph", "freeze", member_size, n);
+	bench_start(&b);
+	graph_freeze(&g);
+	bench_stop(&b, n_edges);
+	bench_end(&b);
+
+	bench_graph_traversal(&g, "bfs_frozen", 0, member_size, n_edges);
+
+	bench_begin(&b, "graph", "reorder_rcm", member_size, n);
+	bench_start(&b);
+	graph_reorder(&g, GRAPH_ORDER_RCM, NULL);
+	bench_stop(&b, n_edges);
+	bench_end(&b);
+
+	bench_graph_traversal(&g, "bfs_reordered", 0, member_size, n_edges);
+
+	graph_destroy(&g);
+}
@@ -0,0 +1,136 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "bench.h"
+
+#define BENCH_MIN_BYTES (16UL << 10)
+#define BENCH_MAX_BYTES (64UL << 20)
+#define BENCH_BYTES_STEP 16
+
+typedef struct bench_suite_t{
+	const char* name;
+	bench_suite_function run;
+}bench_suite_t;
+
+bench_suite_t bench_suites[] = {
+	{ "vector", bench_vector },
+	{ "queue", bench_queue },
+	{ "stack", bench_stack },
+	{ "pqueue", bench_pqueue },
+	{ "trie", bench_trie },
+	{ "hashmap", bench_hashmap },
+	{ "graph", bench_graph },
+	{ NULL, NULL }
+};
+
+size_t bench_member_sizes[] = { 8, 64, 256, 0 };
+
+/*
+ * auxiliar function;
+ * whether the suite `name` was selected in the command line
+ */
+int bench_selected (const char* name, int argc, char** argv)
+{
+	int i;
+
+	if( optind == argc ) return 1;
+	for( i=optind; i<argc; i++ )
+		if( !strcmp(argv[i], name) )
+			return 1;
+	return 0;
+}
+
+/*
+ * auxiliar function;
+ * runs the suite in a new process, so its peak memory is
+ * its own
+ */
+void bench_run (bench_suite_t* suite, size_t member_size, size_t bytes)
+{
+	pid_t pid;
+
+	fflush(stdout);
+	pid = fork();
+	if( pid == 0 ){
+		suite->run(member_size, bytes);
+		fflush(stdout);
+		_exit(0);
+	}
+
+	if( pid > 0 )
+		waitpid(pid, NULL, 0);
+	else
+		suite->run(member_size, bytes);
+}
+
+void usage (const char* program)
+{
+	fprintf(stderr,
+		"usage: %s [-c] [-m max_kib] [suite...]\n"
+		"  -c          CSV output, the default is one JSON object by line\n"
+		"  -m max_kib  largest working set in KiB, the default is %lu\n"
+		"suites: vector queue stack pqueue trie hashmap graph\n",
+		program, BENCH_MAX_BYTES >> 10);
+}
+
+/*
+ * Runs every selected suite for every element size and for
+ * working sets from BENCH_MIN_BYTES (inside L1) to the maximum
+ * (larger than the last level cache), BENCH_BYTES_STEP times
+ * bigger each step.
+ */
+int main (int argc, char** argv)
+{
+	size_t max_bytes = BENCH_MAX_BYTES;
+	size_t bytes, *member_size;
+	bench_suite_t* suite;
+	int opt;
+
+	while( (opt = getopt(argc, argv, "cm:h")) != -1 ){
+		switch(opt){
+		case 'c':
+			bench_format = BENCH_CSV;
+			break;
+		case 'm':
+			max_bytes = strtoul(optarg, NULL, 10) << 10;
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h'? 0 : 1;
+		}
+	}
+
+	bench_print_header();
+	for( suite=bench_suites; suite->name; suite++ ){
+		if( !bench_selected(suite->name, argc, argv) ) continue;
+
+		for( member_size=bench_member_sizes; *member_size; member_size++ )
+			for( bytes=BENCH_MIN_BYTES; bytes<=max_bytes; bytes*=BENCH_BYTES_STEP )
+				bench_run(suite, *member_size, bytes);
+	}
+
+	return 0;
+}
@@ -0,0 +1,29 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <generics/epoch.h>
+
+int released = 0;
+
+void release(void* ptr)
+{
+	free(ptr);
+	released++;
+}
+
+int main()
+{
+	epoch_t e;
+	epoch_create(&e, 4);
+
+	/* unlinked memory waits for the readers of its epoch */
+	epoch_retire(&e, malloc(16), release);
+	epoch_retire(&e, malloc(16), release);
+	printf("released before synchronize: %d\n", released);
+
+	/* with no reader in a read section everything is freed */
+	epoch_synchronize(&e);
+	printf("released after synchronize: %d\n", released);
+
+	epoch_destroy(&e);
+	return released == 2? EXIT_SUCCESS : EXIT_FAILURE;
+}
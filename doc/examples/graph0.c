@@ -17,7 +17,7 @@ void printf_graph(graph_t* g)
 		qnode_t* j;
 
 		for(j=g->adj[i].head; j!=NULL; j = j->next){
-			int adj_index = *(int*)j->data;
+			size_t adj_index = *(size_t*)j->data;
 			graph_get_label_at(g, adj_index, &label);
 
 			printf("%d%s", label, (j->next)?", ":"");
@@ -0,0 +1,36 @@
+#include <stdio.h>
+#include <generics/graph.h>
+
+#define N 5
+
+int main()
+{
+	graph_t g;
+	graph_create(&g, N, 0);
+
+	graph_add_edge(&g, 0, 1);
+	graph_add_edge(&g, 0, 4);
+	graph_add_edge(&g, 1, 2);
+	graph_add_edge(&g, 3, 0);
+	graph_add_edge(&g, 3, 2);
+	graph_add_edge(&g, 4, 3);
+
+	/* no edge can be added from here on */
+	graph_freeze(&g);
+
+	size_t v;
+	for(v=0; v<g.V; v++){
+		const size_t* neighbors;
+		size_t i, n;
+
+		graph_neighbors(&g, v, &neighbors, &n);
+
+		printf("[%lu]->", (unsigned long)v);
+		for(i=0; i<n; i++)
+			printf("%lu%s", (unsigned long)neighbors[i], (i+1<n)?", ":"");
+		printf("\n");
+	}
+
+	graph_destroy(&g);
+	return 0;
+}
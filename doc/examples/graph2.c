@@ -0,0 +1,44 @@
+#include <stdio.h>
+#include <generics/graph.h>
+#include <generics/graph_search.h>
+
+#define N 6
+
+int print_vertex(graph_t* g, size_t v, size_t parent, size_t depth, void* argument)
+{
+	(void)g;
+	(void)argument;
+
+	printf("%lu (from %lu, depth %lu)\n",
+		(unsigned long)v, (unsigned long)parent, (unsigned long)depth);
+	return 0;
+}
+
+int main()
+{
+	graph_t g;
+	graph_create(&g, N, 0);
+
+	graph_add_edge(&g, 0, 1);
+	graph_add_edge(&g, 0, 2);
+	graph_add_edge(&g, 1, 3);
+	graph_add_edge(&g, 2, 3);
+	graph_add_edge(&g, 4, 5);
+
+	printf("bfs:\n");
+	graph_bfs(&g, 0, NULL, NULL, print_vertex, NULL);
+
+	printf("dfs:\n");
+	graph_dfs(&g, 0, NULL, print_vertex, NULL);
+
+	size_t component[N], n, i;
+	graph_connected_components(&g, component, &n);
+
+	printf("%lu components:", (unsigned long)n);
+	for(i=0; i<N; i++)
+		printf(" %lu", (unsigned long)component[i]);
+	printf("\n");
+
+	graph_destroy(&g);
+	return 0;
+}
@@ -0,0 +1,41 @@
+#include <stdio.h>
+#include <generics/graph.h>
+#include <generics/graph_search.h>
+
+#define N 5
+
+int main()
+{
+	graph_t g;
+	graph_create_weighted(&g, N, 0);
+
+	graph_add_weighted_edge(&g, 0, 1, 4.0);
+	graph_add_weighted_edge(&g, 0, 2, 1.0);
+	graph_add_weighted_edge(&g, 2, 1, 2.0);
+	graph_add_weighted_edge(&g, 1, 3, 1.0);
+	graph_add_weighted_edge(&g, 2, 3, 5.0);
+
+	double distance[N];
+	size_t parent[N], v;
+
+	graph_sssp(&g, 0, distance, parent);
+
+	for(v=0; v<N; v++){
+		if(distance[v] == GRAPH_INFINITY){
+			printf("%lu: unreachable\n", (unsigned long)v);
+			continue;
+		}
+
+		printf("%lu: %g, path", (unsigned long)v, distance[v]);
+
+		size_t u = v;
+		while(u != 0){
+			printf(" %lu <-", (unsigned long)u);
+			u = parent[u];
+		}
+		printf(" 0\n");
+	}
+
+	graph_destroy(&g);
+	return 0;
+}
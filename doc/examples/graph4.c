@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include <generics/graph.h>
+#include <generics/snapshot.h>
+
+#define N 4
+#define PATH "graph4.snapshot"
+
+int main()
+{
+	graph_t g, mapped;
+	graph_create_weighted(&g, N, sizeof(int));
+
+	int label;
+	size_t v, i;
+	for(v=0; v<N; v++){
+		label = (int)v*10;
+		graph_set_label_at(&g, v, &label);
+	}
+
+	graph_add_weighted_edge(&g, 0, 1, 0.5);
+	graph_add_weighted_edge(&g, 0, 2, 1.5);
+	graph_add_weighted_edge(&g, 2, 3, 2.0);
+	graph_add_weighted_edge(&g, 3, 0, 4.0);
+
+	if(graph_save(&g, PATH) != GERROR_OK){
+		printf("could not save the graph\n");
+		return 1;
+	}
+	graph_destroy(&g);
+
+	/* the arrays of `mapped` are the pages of the file themselves */
+	if(graph_map(&mapped, PATH) != GERROR_OK){
+		printf("could not map the graph\n");
+		return 1;
+	}
+
+	const size_t* neighbors;
+	const double* weights;
+	size_t count;
+	for(v=0; v<mapped.V; v++){
+		graph_get_label_at(&mapped, v, &label);
+		graph_neighbors(&mapped, v, &neighbors, &count);
+		graph_neighbor_weights(&mapped, v, &weights, &count);
+
+		printf("%lu (%d):", (unsigned long)v, label);
+		for(i=0; i<count; i++)
+			printf(" %lu [%g]", (unsigned long)neighbors[i], weights[i]);
+		printf("\n");
+	}
+
+	graph_unmap(&mapped);
+	remove(PATH);
+	return 0;
+}
@@ -0,0 +1,50 @@
+#include <stdio.h>
+#include <generics/graph.h>
+#include <generics/graph_reorder.h>
+
+#define N 8
+
+/* a path whose vertices were numbered out of order */
+size_t from[] = { 5, 0, 0, 3, 3, 7, 7, 1, 1, 6, 6, 2, 2, 4 };
+size_t to[]   = { 0, 5, 3, 0, 7, 3, 1, 7, 6, 1, 2, 6, 4, 2 };
+
+size_t bandwidth(graph_t* g)
+{
+	size_t v, k, max = 0;
+
+	for(v=0; v<g->V; v++)
+		for(k=g->row_offsets[v]; k<g->row_offsets[v+1]; k++){
+			size_t w = g->col_indices[k];
+			size_t d = w > v? w - v : v - w;
+			if(d > max) max = d;
+		}
+
+	return max;
+}
+
+int main()
+{
+	graph_t g;
+	size_t perm[N], v;
+	char name;
+
+	graph_create_from_edge_list(&g, N, sizeof(char), from, to, NULL, sizeof(from)/sizeof(from[0]));
+	for(v=0; v<N; v++){
+		name = 'a' + v;
+		graph_set_label_at(&g, v, &name);
+	}
+
+	printf("bandwidth before: %lu\n", (unsigned long)bandwidth(&g));
+
+	/* once after loading, the labels follow their vertices */
+	graph_reorder(&g, GRAPH_ORDER_RCM, perm);
+	printf("bandwidth after: %lu\n", (unsigned long)bandwidth(&g));
+
+	for(v=0; v<N; v++){
+		graph_get_label_at(&g, perm[v], &name);
+		printf("%lu -> %lu (%c)\n", (unsigned long)v, (unsigned long)perm[v], name);
+	}
+
+	graph_destroy(&g);
+	return 0;
+}
@@ -0,0 +1,44 @@
+#include <stdio.h>
+#include <string.h>
+#include <generics/hashmap.h>
+
+int print(void* key, size_t size, void* value, void* argument)
+{
+	(void) argument;
+	printf("[%.*s] = %d\n", (int)size, (char*)key, *(int*)value);
+	return 0;
+}
+
+int main()
+{
+	static const char* words[] = {
+		"the", "quick", "brown", "fox", "jumps", "over", "the", "lazy",
+		"dog", "the", "fox", "and", "the", "unbelievably-long-hyphenated-dog"
+	};
+	size_t i;
+
+	/* keys up to 8 bytes are kept in the slots */
+	hashmap_t h;
+	hashmap_create(&h, 8, sizeof(int));
+	hashmap_reserve(&h, sizeof(words)/sizeof(*words));
+
+	for(i=0; i<sizeof(words)/sizeof(*words); i++){
+		int* count = (int*) hashmap_get_ref(&h, (void*)words[i], strlen(words[i]));
+		if(count){
+			(*count)++;
+		}else{
+			count = (int*) hashmap_emplace(&h, (void*)words[i], strlen(words[i]));
+			*count = 1;
+		}
+	}
+
+	hashmap_remove_element(&h, "and", 3);
+	hashmap_foreach(&h, print, NULL);
+
+	int n;
+	if(hashmap_get_element(&h, "and", 3, &n) != GERROR_OK)
+		printf("[and] was removed\n");
+
+	hashmap_destroy(&h);
+	return 0;
+}
@@ -0,0 +1,45 @@
+#include <stdio.h>
+#include <generics/priority_queue.h>
+
+#define WORKERS 3
+#define TIMERS 5
+#define TOP 4
+
+int main()
+{
+	pqueue_t workers[WORKERS], all;
+	long deadlines[TIMERS];
+	size_t w, i, count;
+
+	/* every worker keeps the deadlines of its own timers */
+	for(w=0; w<WORKERS; w++){
+		pqueue_create_pairing(&workers[w], sizeof(long));
+		for(i=0; i<TIMERS; i++)
+			deadlines[i] = (long)((w*7 + i*13) % 40);
+		pqueue_add_n(&workers[w], deadlines, TIMERS);
+	}
+
+	/* at the barrier the heaps are linked, nothing is copied */
+	pqueue_create_pairing(&all, sizeof(long));
+	for(w=0; w<WORKERS; w++){
+		pqueue_merge(&all, &workers[w]);
+		pqueue_destroy(&workers[w]);
+	}
+
+	long next[TOP];
+	pqueue_top_k(&all, next, TOP, &count);
+	printf("next %lu deadlines:", (unsigned long)count);
+	for(i=0; i<count; i++)
+		printf(" %ld", next[i]);
+	printf("\n");
+
+	long expired[TIMERS*WORKERS];
+	pqueue_extract_n(&all, expired, TIMERS, &count);
+	printf("expired:");
+	for(i=0; i<count; i++)
+		printf(" %ld", expired[i]);
+	printf("\n%lu timers left\n", (unsigned long)all.size);
+
+	pqueue_destroy(&all);
+	return 0;
+}
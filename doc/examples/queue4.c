@@ -0,0 +1,34 @@
+#include <stdio.h>
+#include <generics/queue.h>
+
+#define N 100
+
+typedef struct message_t{
+	int id;
+	double payload;
+}message_t;
+
+int main()
+{
+	int i;
+	queue_t q;
+	queue_create_ring(&q, sizeof(message_t), 8);
+
+	for( i=0; i<N; i++ ){
+		message_t m;
+		m.id = i;
+		m.payload = i/2.0;
+		queue_enqueue(&q, &m);
+	}
+
+	printf("capacity(q:%zu): %zu\n", q.size, q.capacity);
+
+	while( q.size ){
+		message_t m;
+		queue_dequeue(&q, &m);
+		printf("dequeue(q): %d %.1lf\n", m.id, m.payload);
+	}
+
+	queue_destroy(&q);
+	return 0;
+}
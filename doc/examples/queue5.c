@@ -0,0 +1,43 @@
+#include <stdio.h>
+#include <pthread.h>
+#include <generics/concurrent_queue.h>
+
+#define N 1000
+
+void* producer(void* argument)
+{
+	spscq_t* q = (spscq_t*) argument;
+	int i;
+
+	for(i=1; i<=N; i++)
+		spscq_enqueue(q, &i);
+
+	return NULL;
+}
+
+int main()
+{
+	spscq_t q;
+	spscq_create(&q, sizeof(int), 64);
+
+	pthread_t thread;
+	pthread_create(&thread, NULL, producer, &q);
+
+	/* takes up to 16 elements at a time */
+	int batch[16];
+	long sum = 0;
+	size_t received = 0;
+
+	while(received < N){
+		size_t i, n = spscq_try_dequeue_n(&q, batch, 16);
+		for(i=0; i<n; i++)
+			sum += batch[i];
+		received += n;
+	}
+
+	pthread_join(thread, NULL);
+	printf("received %lu elements, sum %ld\n", (unsigned long)received, sum);
+
+	spscq_destroy(&q);
+	return 0;
+}
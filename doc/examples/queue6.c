@@ -0,0 +1,50 @@
+#include <stdio.h>
+#include <stddef.h>
+#include <generics/queue.h>
+
+#define N 6
+#define CAPACITY 4
+
+typedef struct connection_t{
+	int fd;
+	qnode_t lru;	/* link of the lru list, owned by the queue */
+}connection_t;
+
+int print_connection(void* elem, size_t index, void* argument)
+{
+	(void) index; (void) argument;
+	printf(" %d", ((connection_t*) elem)->fd);
+	return 0;
+}
+
+int main()
+{
+	connection_t pool[N];
+	connection_t* evicted;
+	queue_t lru;
+	int i;
+
+	/* the queue only links the connections, it never copies them */
+	queue_create_intrusive(&lru, offsetof(connection_t, lru));
+
+	for( i=0; i<N; i++ ){
+		pool[i].fd = 10 + i;
+		if( lru.size == CAPACITY ){
+			queue_dequeue(&lru, &evicted);
+			printf("evicted: %d\n", evicted->fd);
+		}
+		queue_enqueue(&lru, &pool[i]);
+	}
+
+	/* a hit moves the connection to the back in O(1) */
+	queue_remove(&lru, &pool[3].lru, NULL);
+	queue_enqueue(&lru, &pool[3]);
+
+	printf("front: %d\n", QUEUE_CONTAINER_OF(lru.head, connection_t, lru)->fd);
+	printf("lru:");
+	queue_foreach(&lru, print_connection, NULL);
+	printf("\n");
+
+	queue_destroy(&lru);
+	return 0;
+}
@@ -0,0 +1,70 @@
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <generics/epoch.h>
+#include <generics/trie.h>
+
+#define N 1000
+#define READERS 4
+
+epoch_t e;
+trie_t t;
+int done = 0;
+
+void* reader(void* argument)
+{
+	epoch_reader_t* r = epoch_register(&e);
+	long found = 0;
+	char key[16];
+	int i, value;
+
+	(void) argument;
+	while(!__atomic_load_n(&done, __ATOMIC_ACQUIRE)){
+		for(i=0; i<N; i++){
+			sprintf(key, "key%d", i);
+
+			/* no lock, only a read section */
+			epoch_enter(&e, r);
+			if(trie_get_element(&t, key, strlen(key), &value) == GERROR_OK)
+				found++;
+			epoch_exit(r);
+		}
+	}
+
+	epoch_unregister(&e, r);
+	printf("reader found %ld keys\n", found);
+	return NULL;
+}
+
+int main()
+{
+	pthread_t threads[READERS];
+	char key[16];
+	int i;
+
+	epoch_create(&e, READERS);
+	trie_create_concurrent(&t, sizeof(int), &e);
+
+	for(i=0; i<READERS; i++)
+		pthread_create(&threads[i], NULL, reader, NULL);
+
+	/* the single writer */
+	for(i=0; i<N; i++){
+		sprintf(key, "key%d", i);
+		trie_add_element(&t, key, strlen(key), &i);
+	}
+	for(i=0; i<N; i+=2){
+		sprintf(key, "key%d", i);
+		trie_remove_element(&t, key, strlen(key));
+	}
+
+	__atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+	for(i=0; i<READERS; i++)
+		pthread_join(threads[i], NULL);
+
+	printf("%lu keys left\n", (unsigned long)t.size);
+
+	trie_destroy(&t);
+	epoch_destroy(&e);
+	return 0;
+}
@@ -0,0 +1,43 @@
+#include <stdio.h>
+#include <string.h>
+#include <generics/galloc.h>
+#include <generics/trie.h>
+
+#define N 10000
+#define BATCHES 3
+
+int main()
+{
+	garena_t arena;
+	trie_t t;
+	char key[16];
+	int i, batch, value;
+
+	garena_create(&arena, 0);
+
+	for(batch=0; batch<BATCHES; batch++){
+		/* the nodes and the values are carved from the arena */
+		trie_create_adaptive_with_allocator(&t, sizeof(int), &arena.allocator);
+
+		for(i=0; i<N; i++){
+			sprintf(key, "key%d", i*(batch + 1));
+			trie_add_element(&t, key, strlen(key), &i);
+		}
+
+		sprintf(key, "key%d", (N/2)*(batch + 1));
+		if(trie_get_element(&t, key, strlen(key), &value) == GERROR_OK)
+			printf("batch %d: %zu keys, %s -> %d\n", batch, t.size, key, value);
+
+		/*
+		 * the whole trie is given back at once, without trie_destroy;
+		 * `t` is not on the arena, so it leaves the registry of the
+		 * counters first (nothing to do without GENERICS_STATS)
+		 */
+		GSTATS_UNREGISTER(&t);
+		garena_reset(&arena);
+	}
+
+	garena_destroy(&arena);
+
+	return 0;
+}
@@ -0,0 +1,35 @@
+#include <stdio.h>
+#include <string.h>
+#include <generics/trie.h>
+
+int print_entry(void* key, size_t size, void* value, void* argument)
+{
+	(void) argument;
+	printf("%.*s -> %d\n", (int) size, (char*) key, *(int*) value);
+	return 0;
+}
+
+int main()
+{
+	char* names[] = { "barbara", "boris", "bob", "raul", "tutu", "yudi", "bo" };
+	size_t n = sizeof(names)/sizeof(names[0]);
+	trie_t t;
+	size_t i;
+
+	trie_create_adaptive(&t, sizeof(int));
+
+	for(i=0; i<n; i++){
+		int length = (int) strlen(names[i]);
+		trie_add_element(&t, names[i], strlen(names[i]), &length);
+	}
+
+	printf("every key:\n");
+	trie_foreach(&t, print_entry, NULL);
+
+	printf("keys starting with \"bo\":\n");
+	trie_foreach_prefix(&t, "bo", 2, print_entry, NULL);
+
+	trie_destroy(&t);
+
+	return 0;
+}
@@ -0,0 +1,36 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <generics/typed.h>
+
+#define N 10
+
+#define int_less(a, b) ((a) < (b))
+
+GENERICS_VECTOR_DECLARE(ivector, int)
+GENERICS_PQUEUE_DECLARE(ipqueue, int, int_less)
+
+int main()
+{
+	srand(time(NULL));
+
+	int i;
+	ivector_t v;
+	ivector_create(&v, N);
+
+	for( i=0; i<N; i++ )
+		ivector_push(&v, rand()%N);
+
+	ipqueue_t p;
+	ipqueue_create_from_array(&p, v.data, v.size);
+
+	while( p.size ){
+		int temp;
+		ipqueue_extract(&p, &temp);
+		printf("extracted: %d\n", temp);
+	}
+
+	ipqueue_destroy(&p);
+	ivector_destroy(&v);
+	return 0;
+}
@@ -0,0 +1,34 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <generics/vector.h>
+#include <generics/vector_algorithm.h>
+
+int main()
+{
+	static const int32_t prices[] = { 120, -5, 42, 999, 42, 7, 300, 64, 42, 0 };
+	vector_t v;
+	size_t i, count, index;
+
+	vector_create(&v, 0, sizeof(int32_t));
+	vector_append_n(&v, (void*)prices, sizeof(prices)/sizeof(*prices));
+
+	int32_t min, max;
+	vector_min_max(&v, VECTOR_INT32, NULL, NULL, &min, &max);
+	printf("min %d, max %d\n", min, max);
+
+	int32_t low = 0, high = 100;
+	vector_count_range(&v, VECTOR_INT32, &low, &high, &count);
+	printf("%lu prices in [%d, %d]\n", (unsigned long)count, low, high);
+
+	int32_t x = 42;
+	if(vector_find(&v, &x, &index) == GERROR_OK)
+		printf("first %d at %lu\n", x, (unsigned long)index);
+
+	vector_sort(&v, VECTOR_INT32, NULL, NULL);
+	for(i=0; i<v.size; i++)
+		printf("%d ", *(int32_t*)vector_ptr_at(&v, i));
+	printf("\n");
+
+	vector_destroy(&v);
+	return 0;
+}
@@ -0,0 +1,26 @@
+#include <stdio.h>
+#include <generics/inline.h>
+
+#define N 1000000
+
+int main()
+{
+	vector_t v;
+	long i, sum = 0, last;
+
+	vector_create(&v, 0, sizeof(long));
+
+	/* the buffer is only grown when full, no other checks on the way */
+	for( i=0; i<N; i++ )
+		vector_push_back_unchecked(&v, &i);
+
+	/* the index is trusted, the load compiles to a plain array access */
+	for( i=0; i<(long)v.size; i++ )
+		sum += VECTOR_ELEM(&v, long, i);
+
+	vector_at_unchecked(&v, v.size - 1, &last);
+	printf("size: %lu, sum: %ld, last: %ld\n", (unsigned long)v.size, sum, last);
+
+	vector_destroy(&v);
+	return 0;
+}
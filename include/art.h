@@ -0,0 +1,108 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#ifndef __ART_H__
+#define __ART_H__
+#include <stdlib.h>
+#include <string.h>
+
+#include "gerror.h"
+#include "vector.h"
+#include "galloc.h"
+
+/*
+ * Adaptive radix tree nodes, the adaptive layout of `trie_t`.
+ *
+ * A node has room for only as many children as it needs (4, 16,
+ * 48 or 256) and it grows or shrinks as the children are added
+ * and removed. A node with no child is a leaf with no room for
+ * children at all. Single-child chains are collapsed in the
+ * `prefix` of the node: the bytes that follow the byte of the
+ * edge that leads to the node. Prefixes longer than
+ * ART_MAX_PREFIX are split along a chain of nodes.
+ */
+
+#define ART_MAX_PREFIX 10
+
+typedef enum art_type_t{
+	ART_LEAF,
+	ART_NODE4,
+	ART_NODE16,
+	ART_NODE48,
+	ART_NODE256
+}art_type_t;
+
+/** Header shared by every node type. `value` is the element
+  * mapped by the key that ends in this node, or NULL.
+  */
+typedef struct art_node_t{
+	unsigned char type;
+	unsigned char prefix_len;
+	unsigned short n_children;
+	unsigned char prefix[ART_MAX_PREFIX];
+	void* value;
+}art_node_t;
+
+/** Up to 4 children, `keys` sorted.
+  */
+typedef struct art_node4_t{
+	struct art_node_t n;
+	unsigned char keys[4];
+	struct art_node_t* children[4];
+}art_node4_t;
+
+/** Up to 16 children, `keys` sorted and searched 16 at a time.
+  */
+typedef struct art_node16_t{
+	struct art_node_t n;
+	unsigned char keys[16];
+	struct art_node_t* children[16];
+}art_node16_t;
+
+/** Up to 48 children, `index[byte]` is one plus the position
+  * of the child of `byte` in `children` or 0.
+  */
+typedef struct art_node48_t{
+	struct art_node_t n;
+	unsigned char index[256];
+	struct art_node_t* children[48];
+}art_node48_t;
+
+/** Up to 256 children, indexed by the byte.
+  */
+typedef struct art_node256_t{
+	struct art_node_t n;
+	struct art_node_t* children[256];
+}art_node256_t;
+
+/** Function called on every value of a tree, with the key that
+  * maps it. A non-zero return stops the walk.
+  */
+typedef int (*art_visit_function)(void* key, size_t size, void* value, void* argument);
+
+void* art_get(struct art_node_t* root, void* string, size_t size);
+void** art_insert(struct art_node_t** root, void* string, size_t size, const struct galloc_t* a);
+void* art_remove(struct art_node_t** root, void* string, size_t size, const struct galloc_t* a);
+void** art_insert_copy(struct art_node_t** root, void* string, size_t size, struct vector_t* retired);
+void* art_remove_copy(struct art_node_t** root, void* string, size_t size, struct vector_t* retired);
+void art_destroy(struct art_node_t* root, size_t value_size, const struct galloc_t* a);
+void art_foreach(struct art_node_t* root, void* string, size_t size, art_visit_function visit, void* argument);
+struct art_node_t** art_find_child(struct art_node_t* node, unsigned char byte);
+size_t art_children(struct art_node_t* node, unsigned char* keys, struct art_node_t** children);
+
+#endif
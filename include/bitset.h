@@ -0,0 +1,50 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#ifndef __BITSET_H__
+#define __BITSET_H__
+#include <stdlib.h>
+#include <limits.h>
+#include "gerror.h"
+
+/** Packed set of bits, one bit per element.
+  */
+typedef struct bitset_t{
+	size_t size;
+	size_t n_words;
+	unsigned long* words;
+}bitset_t;
+
+#define BITSET_WORD_BITS	(sizeof(unsigned long)*CHAR_BIT)
+#define BITSET_WORD(i)		((i)/BITSET_WORD_BITS)
+#define BITSET_MASK(i)		(1UL << ((i)%BITSET_WORD_BITS))
+
+/*
+ * unchecked access to the bit `i` of the bitset pointed by `b`
+ */
+#define BITSET_TEST(b, i)	(((b)->words[BITSET_WORD(i)] & BITSET_MASK(i)) != 0)
+#define BITSET_SET(b, i)	((b)->words[BITSET_WORD(i)] |= BITSET_MASK(i))
+#define BITSET_UNSET(b, i)	((b)->words[BITSET_WORD(i)] &= ~BITSET_MASK(i))
+
+gerror_t bitset_create(bitset_t* b, size_t size);
+gerror_t bitset_clear(bitset_t* b);
+gerror_t bitset_swap(bitset_t* a, bitset_t* b);
+size_t bitset_count(bitset_t* b);
+gerror_t bitset_destroy(bitset_t* b);
+
+#endif
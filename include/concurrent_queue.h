@@ -0,0 +1,94 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#ifndef __CONCURRENT_QUEUE_H__
+#define __CONCURRENT_QUEUE_H__
+#include <stdlib.h>
+#include "gerror.h"
+
+/*
+ * size of a cache line; the counters written by different
+ * threads are kept this far apart so that they do not share
+ * a line
+ */
+#define GENERICS_CACHE_LINE 64
+
+/** Bounded queue for exactly one producer thread and one
+  * consumer thread. The elements are copied in and out of a
+  * ring buffer of `capacity` slots, a power of two. Each side
+  * keeps a copy of the counter of the other side and only reads
+  * the shared counter when its copy says the queue is full or
+  * empty.
+  */
+typedef struct spscq_t{
+	size_t member_size;
+	size_t capacity;
+	void* buffer;
+
+	char pad0[GENERICS_CACHE_LINE];
+	size_t head;
+	size_t cached_tail;
+
+	char pad1[GENERICS_CACHE_LINE];
+	size_t tail;
+	size_t cached_head;
+
+	char pad2[GENERICS_CACHE_LINE];
+}spscq_t;
+
+/** Bounded queue for any number of producer and consumer
+  * threads (Vyukov). Every slot has a sequence number that
+  * tells whether it is free for the producer of that position
+  * or full for its consumer, so a thread claims a position with
+  * a single compare-and-swap on `tail` or `head`.
+  */
+typedef struct mpmcq_t{
+	size_t member_size;
+	size_t capacity;
+	size_t slot_size;
+	void* buffer;
+
+	char pad0[GENERICS_CACHE_LINE];
+	size_t head;
+
+	char pad1[GENERICS_CACHE_LINE];
+	size_t tail;
+
+	char pad2[GENERICS_CACHE_LINE];
+}mpmcq_t;
+
+gerror_t spscq_create(spscq_t* q, size_t member_size, size_t capacity);
+gerror_t spscq_try_enqueue(spscq_t* q, void* e);
+gerror_t spscq_try_dequeue(spscq_t* q, void* e);
+size_t spscq_try_enqueue_n(spscq_t* q, void* e, size_t n);
+size_t spscq_try_dequeue_n(spscq_t* q, void* e, size_t n);
+gerror_t spscq_enqueue(spscq_t* q, void* e);
+gerror_t spscq_dequeue(spscq_t* q, void* e);
+size_t spscq_size(spscq_t* q);
+gerror_t spscq_destroy(spscq_t* q);
+
+gerror_t mpmcq_create(mpmcq_t* q, size_t member_size, size_t capacity);
+gerror_t mpmcq_try_enqueue(mpmcq_t* q, void* e);
+gerror_t mpmcq_try_dequeue(mpmcq_t* q, void* e);
+size_t mpmcq_try_enqueue_n(mpmcq_t* q, void* e, size_t n);
+size_t mpmcq_try_dequeue_n(mpmcq_t* q, void* e, size_t n);
+gerror_t mpmcq_enqueue(mpmcq_t* q, void* e);
+gerror_t mpmcq_dequeue(mpmcq_t* q, void* e);
+gerror_t mpmcq_destroy(mpmcq_t* q);
+
+#endif
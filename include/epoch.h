@@ -0,0 +1,79 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#ifndef __EPOCH_H__
+#define __EPOCH_H__
+#include <stdlib.h>
+#include "gerror.h"
+#include "vector.h"
+
+#ifndef GENERICS_CACHE_LINE
+#define GENERICS_CACHE_LINE 64
+#endif
+
+/*
+ * number of epochs whose retired memory is kept; memory retired
+ * in an epoch is freed two epochs later
+ */
+#define EPOCH_N_BUCKETS 3
+
+/** Slot of a reader thread. `epoch` is zero while the reader is
+  * outside a read section, otherwise it is the epoch the reader
+  * saw when it entered.
+  */
+typedef struct epoch_reader_t{
+	size_t epoch;
+	int used;
+	char pad[GENERICS_CACHE_LINE];
+}epoch_reader_t;
+
+/** Memory unlinked by the writer that readers may still see.
+  */
+typedef struct epoch_retired_t{
+	void* ptr;
+	void (*release)(void*);
+}epoch_retired_t;
+
+/** Epoch-based reclamation domain for many reader threads and a
+  * single writer thread.
+  *
+  * Readers only announce the epoch they run in; they never
+  * block and never write shared memory but their own slot. The
+  * writer unlinks memory, retires it in the current epoch and
+  * moves the epoch on when every reader in a read section has
+  * seen the current one; then nothing unlinked two epochs ago
+  * can be reached anymore and it is freed.
+  */
+typedef struct epoch_t{
+	size_t global;
+	size_t n_readers;
+	epoch_reader_t* readers;
+	struct vector_t retired[EPOCH_N_BUCKETS];
+}epoch_t;
+
+gerror_t epoch_create(epoch_t* e, size_t max_readers);
+epoch_reader_t* epoch_register(epoch_t* e);
+gerror_t epoch_unregister(epoch_t* e, epoch_reader_t* r);
+void epoch_enter(epoch_t* e, epoch_reader_t* r);
+void epoch_exit(epoch_reader_t* r);
+gerror_t epoch_retire(epoch_t* e, void* ptr, void (*release)(void*));
+int epoch_try_advance(epoch_t* e);
+gerror_t epoch_synchronize(epoch_t* e);
+gerror_t epoch_destroy(epoch_t* e);
+
+#endif
@@ -0,0 +1,81 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#ifndef __GALLOC_H__
+#define __GALLOC_H__
+#include <stdlib.h>
+#include <string.h>
+#include "gerror.h"
+
+/*
+ * Allocators of the containers.
+ *
+ * A container created by a `*_create_with_allocator` function
+ * takes all its memory from the allocator, which must outlive
+ * the container; the other create functions use
+ * `galloc_default`, that is malloc, realloc and free. The
+ * allocator receives back the size of every block it frees or
+ * resizes, so it needs no header of its own.
+ */
+
+/** Allocator interface: the functions receive `context` as
+  * their first argument.
+  */
+typedef struct galloc_t{
+	void* (*alloc)(void* context, size_t size);
+	void* (*realloc)(void* context, void* ptr, size_t old_size, size_t new_size);
+	void (*free)(void* context, void* ptr, size_t size);
+	void* context;
+}galloc_t;
+
+#define GALLOC_ALLOC(a, size)			((a)->alloc((a)->context, (size)))
+#define GALLOC_REALLOC(a, ptr, old_size, size)	((a)->realloc((a)->context, (ptr), (old_size), (size)))
+#define GALLOC_FREE(a, ptr, size)		((a)->free((a)->context, (ptr), (size)))
+
+#define GARENA_ALIGNMENT 16
+#define GARENA_BLOCK_SIZE (64 << 10)
+
+/** Bump allocator: the blocks are carved in order from big
+  * blocks of memory; freeing only gives back the last block
+  * allocated, and `garena_reset` gives back everything at once.
+  * A container on an arena may be dropped by the reset, without
+  * its `*_destroy`; with GENERICS_STATS its structure must be on
+  * the arena too, or leave the registry with GSTATS_UNREGISTER
+  * before the reset, see `garena_reset`.
+  *
+  * `allocator` is the interface to pass to the containers.
+  */
+typedef struct garena_t{
+	galloc_t allocator;
+
+	size_t block_size;
+	void* blocks;
+	char* next;
+	size_t remaining;
+	void* last;
+}garena_t;
+
+extern const galloc_t galloc_default;
+
+void* galloc_zeroed(const galloc_t* a, size_t size);
+
+gerror_t garena_create(garena_t* a, size_t block_size);
+gerror_t garena_reset(garena_t* a);
+gerror_t garena_destroy(garena_t* a);
+
+#endif
@@ -28,6 +28,11 @@ typedef enum gerror_t{
 	GERROR_TRY_REMOVE_EMPTY_STRUCTURE,
 	GERROR_TRY_ADD_EDGE_NO_VERTEX,
 	GERROR_ACCESS_OUT_OF_BOUND,
+	GERROR_UNSUPPORTED_OPERATION,
+	GERROR_INVALID_ARGUMENT,
+	GERROR_IO,
+	GERROR_INVALID_FORMAT,
+	GERROR_TRY_ADD_FULL_STRUCTURE,
 	GERROR_N_ERROR
 } gerror_t;
 
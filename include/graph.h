@@ -21,8 +21,40 @@
 #include <string.h>
 #include "gerror.h"
 #include "queue.h"
+#include "gstats.h"
+#include "galloc.h"
+
+/** Adjacency entry of a weighted graph. The index of the vertex
+  * comes first, as in the entries of an unweighted graph.
+  */
+typedef struct graph_edge_t{
+	size_t to;
+	double weight;
+}graph_edge_t;
+
+struct graph_t;
+
+/** Function called on every edge out of the vertex `v`, with the
+  * incident vertex and the weight of the edge. A non-zero return
+  * stops the walk.
+  */
+typedef int (*graph_neighbor_function)(struct graph_t* g, size_t v, size_t to, double weight, void* argument);
 
 /** Graph structure and elements.
+  *
+  * The nodes of all adjacency queues are blocks of `pool`.
+  *
+  * After `graph_freeze` the adjacency queues are released and
+  * the graph is kept in compressed sparse row form: the
+  * neighbors of the vertex `v` are `col_indices[row_offsets[v]]`
+  * up to `col_indices[row_offsets[v+1]-1]`. The arrays
+  * `in_offsets` and `in_indices` keep the transpose in the
+  * same form once `graph_build_transpose` is called.
+  *
+  * The adjacency entries of a weighted graph are `graph_edge_t`
+  * and, once it is frozen, `weights[k]` is the weight of the
+  * edge to `col_indices[k]`. The entries of an unweighted graph
+  * are only the index of the vertex, and its edges weigh 1.
   */
 typedef struct graph_t{
 	size_t V;
@@ -30,12 +62,47 @@ typedef struct graph_t{
 	size_t member_size;
 	struct queue_t* adj;
 	void* label;
+
+	struct npool_t* pool;
+	int owns_pool;
+
+	size_t* row_offsets;
+	size_t* col_indices;
+	size_t* in_offsets;
+	size_t* in_indices;
+
+	int weighted;
+	double* weights;
+
+	const struct galloc_t* allocator;
+	GSTATS_ENTRY
 }graph_t;
 
 gerror_t graph_create(graph_t* g, size_t size, size_t member_size);
+gerror_t graph_create_pooled(graph_t* g, size_t size, size_t member_size, struct npool_t* pool);
+gerror_t graph_create_weighted(graph_t* g, size_t size, size_t member_size);
+gerror_t graph_create_with_allocator(graph_t* g, size_t size, size_t member_size,
+		const struct galloc_t* allocator);
 gerror_t graph_add_edge(graph_t* g, size_t from, size_t to);
+gerror_t graph_add_weighted_edge(graph_t* g, size_t from, size_t to, double weight);
+gerror_t graph_add_edges(graph_t* g, const size_t* from, const size_t* to, size_t n);
+gerror_t graph_add_weighted_edges(graph_t* g, const size_t* from, const size_t* to,
+		const double* weight, size_t n);
+gerror_t graph_create_from_csr(graph_t* g, size_t size, size_t member_size,
+		size_t* row_offsets, size_t* col_indices, double* weights);
+gerror_t graph_create_from_edge_list(graph_t* g, size_t size, size_t member_size,
+		const size_t* from, const size_t* to, const double* weight, size_t n);
+gerror_t graph_sort_neighbors(graph_t* g, int dedup);
 gerror_t graph_get_label_at(graph_t* g, size_t index, void* label);
 gerror_t graph_set_label_at(graph_t* g, size_t index, void* label);
+gerror_t graph_freeze(graph_t* g);
+int graph_is_frozen(graph_t* g);
+gerror_t graph_neighbors(graph_t* g, size_t v, const size_t** begin, size_t* count);
+gerror_t graph_neighbor_weights(graph_t* g, size_t v, const double** begin, size_t* count);
+gerror_t graph_foreach_neighbor(graph_t* g, size_t v, graph_neighbor_function visit, void* argument);
+gerror_t graph_build_transpose(graph_t* g);
+gerror_t graph_in_neighbors(graph_t* g, size_t v, const size_t** begin, size_t* count);
 gerror_t graph_destroy(graph_t* g);
+gerror_t graph_get_stats(graph_t* g, gstats_t* stats);
 
 #endif
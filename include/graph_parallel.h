@@ -0,0 +1,39 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#ifndef __GRAPH_PARALLEL_H__
+#define __GRAPH_PARALLEL_H__
+#include <stdlib.h>
+#include "gerror.h"
+#include "graph.h"
+#include "graph_search.h"
+#include "thread_pool.h"
+
+/*
+ * vertices or edges given to a worker at a time
+ */
+#define GRAPH_PARALLEL_GRAIN 256
+
+gerror_t graph_parallel_create_from_edge_list(graph_t* g, tpool_t* p, size_t size, size_t member_size,
+		const size_t* from, const size_t* to, const double* weight, size_t n);
+gerror_t graph_parallel_bfs(graph_t* g, tpool_t* p, size_t source, size_t* distance, size_t* parent);
+gerror_t graph_parallel_connected_components(graph_t* g, tpool_t* p, size_t* component, size_t* n_components);
+gerror_t graph_parallel_pagerank(graph_t* g, tpool_t* p, double damping,
+		size_t max_iterations, double tolerance, double* rank, size_t* iterations);
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#ifndef __GRAPH_REORDER_H__
+#define __GRAPH_REORDER_H__
+#include <stdlib.h>
+#include "gerror.h"
+#include "graph.h"
+
+/*
+ * Vertex orders that improve the locality of the traversals of a
+ * frozen graph, whose vertex ids usually come from the order of
+ * ingestion. The degree of a vertex is its number of edges out
+ * and, once the transpose is built, in.
+ *
+ *	GRAPH_ORDER_DEGREE	by descending degree, so the vertices
+ *				that are reached most often share lines
+ *				and pages;
+ *	GRAPH_ORDER_RCM		reverse Cuthill-McKee: breadth first
+ *				from vertices of low degree, visiting the
+ *				neighbors by ascending degree, and
+ *				reversed, which keeps the neighbors of a
+ *				vertex close to it;
+ *	GRAPH_ORDER_HUB		hub clustering: the vertices whose degree
+ *				is above the average come first and every
+ *				group keeps the original relative order.
+ *
+ * RCM follows the edges out and, once the transpose is built, in,
+ * so a directed graph is walked as undirected.
+ */
+typedef enum graph_order_t{
+	GRAPH_ORDER_DEGREE,
+	GRAPH_ORDER_RCM,
+	GRAPH_ORDER_HUB
+}graph_order_t;
+
+gerror_t graph_reorder(graph_t* g, graph_order_t strategy, size_t* perm);
+gerror_t graph_order_permutation(graph_t* g, graph_order_t strategy, size_t* perm);
+gerror_t graph_permute(graph_t* g, const size_t* perm);
+
+#endif
@@ -0,0 +1,61 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#ifndef __GRAPH_SEARCH_H__
+#define __GRAPH_SEARCH_H__
+#include <stdlib.h>
+#include <math.h>
+#include "gerror.h"
+#include "graph.h"
+
+/*
+ * distance and parent of the vertices not reached by a search
+ */
+#define GRAPH_UNREACHED ((size_t)-1)
+
+/*
+ * weighted distance of the vertices not reached by a search
+ */
+#define GRAPH_INFINITY HUGE_VAL
+
+/*
+ * Direction-optimizing BFS switches to the bottom-up step when
+ * the edges out of the frontier exceed the edges out of the
+ * unvisited vertices divided by GRAPH_BFS_ALPHA, and back to
+ * the top-down step when the frontier has less than V divided
+ * by GRAPH_BFS_BETA vertices.
+ */
+#define GRAPH_BFS_ALPHA	14
+#define GRAPH_BFS_BETA	24
+
+/** Function called on every vertex reached by a search, with the
+  * vertex from which it was reached and its depth in the search.
+  * The source is reached from itself. A non-zero return stops
+  * the search.
+  */
+typedef int (*graph_visit_function)(graph_t* g, size_t v, size_t parent, size_t depth, void* argument);
+
+gerror_t graph_bfs(graph_t* g, size_t source, size_t* distance, size_t* parent,
+		graph_visit_function visit, void* argument);
+gerror_t graph_dfs(graph_t* g, size_t source, size_t* parent,
+		graph_visit_function visit, void* argument);
+gerror_t graph_connected_components(graph_t* g, size_t* component, size_t* n_components);
+gerror_t graph_dijkstra(graph_t* g, size_t source, size_t target, double* distance, size_t* parent);
+gerror_t graph_sssp(graph_t* g, size_t source, double* distance, size_t* parent);
+
+#endif
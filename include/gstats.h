@@ -0,0 +1,107 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#ifndef __GSTATS_H__
+#define __GSTATS_H__
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gerror.h"
+
+/*
+ * Instrumentation counters of the containers.
+ *
+ * The counters exist only when the library is built with
+ * GENERICS_STATS defined (`make STATS=1`); the code that uses
+ * the library must define it too, since the containers get one
+ * more member. Without it the counting macros expand to nothing,
+ * the containers keep their layout and `*_get_stats` returns
+ * GERROR_UNSUPPORTED_OPERATION.
+ *
+ * Every container registers itself when created, so
+ * `gstats_dump` can print the counters of all the live
+ * containers. A container owned by another one (the vector of a
+ * priority queue, the queues of a graph, ...) is not registered,
+ * its counters are added to the ones of its owner.
+ *
+ * Creating a container again on a structure that is still
+ * registered, without its `*_destroy`, moves the entry instead of
+ * adding it twice. A container dropped without `*_destroy` whose
+ * structure lives outside the memory given back (the `trie_t` on
+ * the stack of a trie on an arena, ...) must leave the registry
+ * with GSTATS_UNREGISTER before its memory goes, see `garena_reset`.
+ */
+
+/** Counters of a container. The fields that do not apply to a
+  * container are zero.
+  */
+typedef struct gstats_t{
+	size_t size;		/* elements now */
+	size_t peak_size;	/* most elements at once */
+	size_t allocations;	/* nodes and buffers allocated */
+	size_t reallocations;	/* buffers resized */
+	size_t bytes_moved;	/* bytes copied by resizes and shifts */
+	size_t comparisons;	/* calls of the compare function */
+	size_t nodes;		/* nodes now */
+	size_t depth;		/* nodes on the longest path */
+}gstats_t;
+
+/*
+ * fills `stats` with the counters of `container`
+ */
+typedef gerror_t (*gstats_function)(void* container, gstats_t* stats);
+
+/** Entry of a container in the registry, a member of every
+  * container in the GENERICS_STATS mode.
+  */
+typedef struct gstats_entry_t{
+	gstats_t counters;
+
+	const char* type;
+	void* container;
+	gstats_function get;
+	struct gstats_entry_t* self;	/* the entry itself while registered */
+	struct gstats_entry_t* prev;
+	struct gstats_entry_t* next;
+}gstats_entry_t;
+
+#ifdef GENERICS_STATS
+#define GSTATS_ENTRY			struct gstats_entry_t stats;
+#define GSTATS_INIT(c)			gstats_init(&(c)->stats)
+#define GSTATS_ADD(c, counter, n)	((c)->stats.counters.counter += (n))
+#define GSTATS_PEAK(c, value)		do{ if( (value) > (c)->stats.counters.peak_size ) \
+						(c)->stats.counters.peak_size = (value); }while(0)
+#define GSTATS_REGISTER(c, type, get)	gstats_register(&(c)->stats, type, (c), get)
+#define GSTATS_UNREGISTER(c)		gstats_unregister(&(c)->stats)
+#else
+#define GSTATS_ENTRY
+#define GSTATS_INIT(c)			((void)0)
+#define GSTATS_ADD(c, counter, n)	((void)0)
+#define GSTATS_PEAK(c, value)		((void)0)
+#define GSTATS_REGISTER(c, type, get)	((void)0)
+#define GSTATS_UNREGISTER(c)		((void)0)
+#endif
+
+void gstats_init(gstats_entry_t* entry);
+void gstats_register(gstats_entry_t* entry, const char* type, void* container, gstats_function get);
+void gstats_unregister(gstats_entry_t* entry);
+void gstats_unregister_range(const void* begin, size_t size);
+void gstats_merge(gstats_t* stats, gstats_t* other);
+gerror_t gstats_dump(FILE* out);
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#ifndef __HASHMAP_H__
+#define __HASHMAP_H__
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "gerror.h"
+#include "gstats.h"
+#include "galloc.h"
+
+/*
+ * Open addressing hash map, in the layout of the Swiss tables.
+ *
+ * The slots are split in groups of HASHMAP_GROUP. Every slot has
+ * a control byte: HASHMAP_EMPTY, HASHMAP_DELETED or, when the
+ * slot is full, the low 7 bits of the hash of its key. A lookup
+ * hashes the key once, picks a group from the high bits and
+ * compares the 7 bits with the whole group at once (SSE2 or NEON
+ * when available), so the keys are compared only on a match; it
+ * stops at the first group that has an empty slot. The groups are
+ * probed in triangular order.
+ *
+ * Every slot keeps the size of its key, the key and the value
+ * inline. Keys up to `key_size` bytes are kept in the slot; the
+ * longer ones are copied to a block from the allocator and the
+ * slot keeps a pointer to it.
+ */
+
+#define HASHMAP_GROUP 16
+#define HASHMAP_EMPTY 0x80
+#define HASHMAP_DELETED 0xFE
+
+/** Hash function of the keys: `size` bytes at `key`.
+  */
+typedef uint64_t (*hashmap_hash_function)(const void* key, size_t size);
+
+/** Function called on every element of a hash map, with the key
+  * that maps it. A non-zero return stops the walk.
+  */
+typedef int (*hashmap_visit_function)(void* key, size_t size, void* value, void* argument);
+
+/** Represents the hash map structure.
+  *
+  * `capacity` is the number of slots, 0 or a power of two not
+  * below HASHMAP_GROUP, and it grows so that at most 7/8 of the
+  * slots are full or deleted. `slot_size` is in bytes.
+  *
+  * The control bytes, the slots and the long keys come from
+  * `allocator`, see galloc.h.
+  */
+typedef struct hashmap_t{
+	size_t size;
+	size_t key_size;
+	size_t member_size;
+
+	size_t capacity;
+	size_t deleted;
+	size_t slot_size;
+	size_t value_offset;
+	unsigned char* control;
+	char* slots;
+
+	hashmap_hash_function hash;
+	const struct galloc_t* allocator;
+	GSTATS_ENTRY
+}hashmap_t;
+
+uint64_t hashmap_hash_default(const void* key, size_t size);
+
+gerror_t hashmap_create(hashmap_t* h, size_t key_size, size_t member_size);
+gerror_t hashmap_create_with_hash(hashmap_t* h, size_t key_size, size_t member_size,
+		hashmap_hash_function hash);
+gerror_t hashmap_create_with_allocator(hashmap_t* h, size_t key_size, size_t member_size,
+		hashmap_hash_function hash, const struct galloc_t* allocator);
+gerror_t hashmap_destroy(hashmap_t* h);
+gerror_t hashmap_reserve(hashmap_t* h, size_t n_elements);
+gerror_t hashmap_clear(hashmap_t* h);
+gerror_t hashmap_add_element(hashmap_t* h, void* key, size_t size, void* elem);
+gerror_t hashmap_remove_element(hashmap_t* h, void* key, size_t size);
+gerror_t hashmap_get_element(hashmap_t* h, void* key, size_t size, void* elem);
+void* hashmap_get_ref(hashmap_t* h, void* key, size_t size);
+void* hashmap_emplace(hashmap_t* h, void* key, size_t size);
+gerror_t hashmap_foreach(hashmap_t* h, hashmap_visit_function visit, void* argument);
+gerror_t hashmap_get_stats(hashmap_t* h, gstats_t* stats);
+
+#endif
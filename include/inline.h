@@ -0,0 +1,104 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#ifndef __INLINE_H__
+#define __INLINE_H__
+#include <string.h>
+
+#include "vector.h"
+#include "queue.h"
+#include "stack.h"
+#include "priority_queue.h"
+
+/*
+ * Unchecked accessors, defined in this header so the compiler
+ * inlines them, and vectorizes the loops around them, instead of
+ * calling into the library. They do not check their arguments
+ * nor the bounds: the caller guarantees the structure is valid
+ * and the index is in range. They read and write the fields
+ * without atomics, so they must not be used on a vector with an
+ * epoch while another thread changes it; the checked functions
+ * of each container remain the safe interface.
+ */
+
+#ifndef GENERICS_INLINE
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#define GENERICS_INLINE static inline
+#elif defined(__GNUC__)
+#define GENERICS_INLINE static __inline__
+#else
+#define GENERICS_INLINE static
+#endif
+#endif
+
+/** The element `index` of the vector `v` of elements of `type`,
+  * as an lvalue.
+  */
+#define VECTOR_ELEM(v, type, index) (((type*)(v)->data)[index])
+
+/** Pointer to the element `index` of `v`, without bounds check.
+  */
+GENERICS_INLINE void* vector_ptr_at_unchecked (vector_t* v, size_t index)
+{
+	return (char*) v->data + index*v->member_size;
+}
+
+/** Copies the element `index` of `v` to `elem`, without bounds
+  * check.
+  */
+GENERICS_INLINE void vector_at_unchecked (vector_t* v, size_t index, void* elem)
+{
+	memcpy(elem, (char*) v->data + index*v->member_size, v->member_size);
+}
+
+/** Adds `elem` at the end of `v`. Only a full buffer calls into
+  * the library, to grow it by the policy of `v`.
+  */
+GENERICS_INLINE void vector_push_back_unchecked (vector_t* v, void* elem)
+{
+	if( (v->size + 1)*v->member_size > v->buffer_size )
+		vector_grow(v, v->size + 1);
+	memcpy((char*) v->data + v->size*v->member_size, elem, v->member_size);
+	v->size++;
+}
+
+/** Number of elements of the queue `q`.
+  */
+GENERICS_INLINE size_t queue_size_unchecked (queue_t* q)
+{
+	return q->size;
+}
+
+/** Number of elements of the stack `s`.
+  */
+GENERICS_INLINE size_t stack_size_unchecked (stack_t* s)
+{
+	return s->size;
+}
+
+/** Pointer to the highest priority element of `p`, that is not
+  * empty, as `pqueue_top_ptr`.
+  */
+GENERICS_INLINE void* pqueue_top_unchecked (pqueue_t* p)
+{
+	if( p->mode == PQUEUE_PAIRING )
+		return (char*) p->root + sizeof(pqueue_node_t);
+	return p->queue.data;
+}
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#ifndef __NODE_POOL_H__
+#define __NODE_POOL_H__
+#include <stdlib.h>
+#include "gerror.h"
+#include "galloc.h"
+
+#define NPOOL_ALIGNMENT	16
+#define NPOOL_ALIGN(n)	(((n) + NPOOL_ALIGNMENT - 1) & ~((size_t)NPOOL_ALIGNMENT - 1))
+
+/** Layout shared by the nodes of the linked containers
+  * (`qnode_t`, `snode_t`). A pool block is one of these
+  * headers followed by an inline payload.
+  */
+typedef struct pnode_t{
+	struct pnode_t* next;
+	struct pnode_t* prev;
+
+	void* data;
+}pnode_t;
+
+#define NPOOL_HEADER_SIZE	NPOOL_ALIGN(sizeof(struct pnode_t))
+
+/** Slab allocator of fixed size nodes.
+  *
+  * The blocks are carved from slabs of `blocks_per_slab`
+  * blocks and the released blocks are kept in `free_list`,
+  * linked through their first word. The same pool may be
+  * shared by any containers whose `member_size` fits in
+  * `member_size`. The slabs come from `allocator`.
+  */
+typedef struct npool_t{
+	size_t member_size;
+	size_t block_size;
+	size_t blocks_per_slab;
+
+	void* slabs;
+	void* free_list;
+	void* next_block;
+	size_t remaining;
+
+	const struct galloc_t* allocator;
+}npool_t;
+
+gerror_t npool_create(struct npool_t* p, size_t member_size, size_t blocks_per_slab);
+gerror_t npool_create_with_allocator(struct npool_t* p, size_t member_size, size_t blocks_per_slab,
+		const struct galloc_t* allocator);
+gerror_t npool_destroy(struct npool_t* p);
+void* npool_alloc(struct npool_t* p);
+gerror_t npool_free(struct npool_t* p, void* block);
+gerror_t npool_free_chain(struct npool_t* p, void* first, void* last);
+void* npool_payload(void* block);
+
+#endif
@@ -22,6 +22,7 @@
 #include <stdlib.h>
 #include "gerror.h"
 #include "vector.h"
+#include "gstats.h"
 
 typedef enum{
 	G_PQUEUE_FIRST_PRIORITY = -1,	/* a > b  */
@@ -31,22 +32,95 @@ typedef enum{
 
 typedef int (*compare_function)(void* a, void* b, void* arg);
 
+/*
+ * position of a key not in an indexed priority queue
+ */
+#define PQUEUE_NO_POSITION ((size_t)-1)
+
+/** Layout of the elements of a priority queue.
+  */
+typedef enum pqueue_mode_t{
+	PQUEUE_HEAP,	/* implicit heap in a vector */
+	PQUEUE_PAIRING	/* pairing heap of nodes, see pqueue_create_pairing */
+}pqueue_mode_t;
+
+/** Node of a pairing heap, in the left-child right-sibling
+  * form; the element follows the node.
+  */
+typedef struct pqueue_node_t{
+	struct pqueue_node_t* child;
+	struct pqueue_node_t* sibling;
+}pqueue_node_t;
+
+/** Represents a priority queue, kept as an implicit
+  * `arity`-ary heap in the vector `queue`.
+  *
+  * An indexed priority queue also maps every element to a key
+  * from 0 to `n_keys - 1`: `key_of[i]` is the key of the i-th
+  * element of the heap and `position[k]` is the place in the
+  * heap of the key `k`, so an element can be found and moved
+  * without searching the heap.
+  *
+  * In the PQUEUE_PAIRING mode the elements are in the nodes of
+  * a pairing heap that hangs from `root` instead, so two queues
+  * merge in O(1).
+  *
+  * The heap, the scratch element, the key maps and the nodes
+  * come from `allocator`, see galloc.h.
+  */
 typedef struct priority_queue_t{
 	size_t size;
 	size_t member_size;
+	size_t arity;
 
 	compare_function compare;
 	void* compare_argument;
+	void* scratch;
 	struct vector_t queue;
+
+	size_t n_keys;
+	size_t* key_of;
+	size_t* position;
+
+	pqueue_mode_t mode;
+	struct pqueue_node_t* root;
+
+	const struct galloc_t* allocator;
+	GSTATS_ENTRY
 } priority_queue_t;
 
 typedef struct priority_queue_t pqueue_t;
 
 gerror_t pqueue_create(	pqueue_t* p, size_t member_size);
+gerror_t pqueue_create_with_allocator(pqueue_t* p, size_t member_size, const struct galloc_t* allocator);
+gerror_t pqueue_create_with_arity(pqueue_t* p, size_t member_size, size_t arity);
+gerror_t pqueue_set_arity(pqueue_t* p, size_t arity);
+gerror_t pqueue_create_from_array(pqueue_t* p, size_t member_size, void* array, size_t n,
+		compare_function function, void* argument);
+gerror_t pqueue_heapify(pqueue_t* p);
 gerror_t pqueue_destroy(pqueue_t* p);
 gerror_t pqueue_set_compare_function(pqueue_t* p, compare_function function, void* argument);
 gerror_t pqueue_add(pqueue_t* p, void* e);
 gerror_t pqueue_max_priority(pqueue_t* p, void* e);
 gerror_t pqueue_extract(pqueue_t* p, void* e);
+void* pqueue_top_ptr(pqueue_t* p);
+void* pqueue_emplace(pqueue_t* p);
+gerror_t pqueue_emplace_commit(pqueue_t* p);
+gerror_t pqueue_add_n(pqueue_t* p, void* elems, size_t n);
+gerror_t pqueue_extract_n(pqueue_t* p, void* elems, size_t n, size_t* count);
+gerror_t pqueue_top_k(pqueue_t* p, void* elems, size_t k, size_t* count);
+
+gerror_t pqueue_create_pairing(pqueue_t* p, size_t member_size);
+gerror_t pqueue_create_pairing_with_allocator(pqueue_t* p, size_t member_size,
+		const struct galloc_t* allocator);
+gerror_t pqueue_merge(pqueue_t* p, pqueue_t* other);
+
+gerror_t pqueue_create_indexed(pqueue_t* p, size_t member_size, size_t n_keys,
+		compare_function function, void* argument);
+gerror_t pqueue_add_indexed(pqueue_t* p, size_t key, void* e);
+gerror_t pqueue_decrease_key(pqueue_t* p, size_t key, void* e);
+gerror_t pqueue_extract_indexed(pqueue_t* p, void* e, size_t* key);
+int pqueue_contains_key(pqueue_t* p, size_t key);
+gerror_t pqueue_get_stats(pqueue_t* p, gstats_t* stats);
 
 #endif
@@ -20,10 +20,15 @@
 #define __QUEUE_T_H__
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
 #include "gerror.h"
+#include "node_pool.h"
+#include "gstats.h"
+#include "galloc.h"
 
 /** queue node.
-  *
+  * The layout is the same of `pnode_t`, so the nodes
+  * may be carved from a `npool_t`.
   */
 typedef struct qnode_t{
 	struct qnode_t* next;
@@ -32,19 +37,73 @@ typedef struct qnode_t{
 	void* data;
 }qnode_t;
 
+/** Pointer to the structure of type `type` that embeds the
+  * qnode_t `node` as its field `member`, for intrusive queues.
+  */
+#define QUEUE_CONTAINER_OF(node, type, member) \
+	((type*)((char*)(node) - offsetof(type, member)))
+
+/** Function called on every element of a queue, with its
+  * position from the front. A non-zero return stops the walk.
+  */
+typedef int (*queue_visit_function)(void* elem, size_t index, void* argument);
+
+/** Storage used by a queue_t.
+  */
+typedef enum queue_mode_t{
+	QUEUE_LIST,	/* doubly linked list of qnode_t */
+	QUEUE_RING,	/* power-of-two circular buffer */
+	QUEUE_INTRUSIVE	/* list of qnode_t embedded in the elements */
+}queue_mode_t;
+
 /** Represents a queue structure.
+  *
+  * In the QUEUE_LIST mode the elements are indexed by the
+  * `head` and `tail` nodes. In the QUEUE_RING mode the
+  * elements live in `buffer`, that has room for `capacity`
+  * elements, starting at the slot `first`.
+  *
+  * In the QUEUE_INTRUSIVE mode the nodes are fields of the
+  * caller's structures, `link_offset` bytes after their start,
+  * and the queue never allocates nor copies them.
+  *
+  * When `pool` is set, the list nodes and their payload are
+  * blocks of that pool instead of two malloc'd pieces.
+  *
+  * The nodes, the buffer and the own pool come from `allocator`,
+  * see galloc.h.
   */
 typedef struct queue_t{
 	size_t size;
 	size_t member_size;
 	struct qnode_t* head;
 	struct qnode_t* tail;
+
+	queue_mode_t mode;
+	void* buffer;
+	size_t capacity;
+	size_t first;
+	size_t link_offset;
+
+	struct npool_t* pool;
+	int owns_pool;
+
+	const struct galloc_t* allocator;
+	GSTATS_ENTRY
 }queue_t;
 
 gerror_t queue_create(struct queue_t* q, size_t member_size);
+gerror_t queue_create_with_allocator(struct queue_t* q, size_t member_size, const struct galloc_t* allocator);
+gerror_t queue_create_pooled(struct queue_t* q, size_t member_size, struct npool_t* pool);
+gerror_t queue_create_ring(struct queue_t* q, size_t member_size, size_t initial_capacity);
+gerror_t queue_create_intrusive(struct queue_t* q, size_t link_offset);
 gerror_t queue_enqueue(struct queue_t* q, void* e);
 gerror_t queue_dequeue(struct queue_t* q, void* e);
+void* queue_front_ptr(struct queue_t* q);
+void* queue_emplace(struct queue_t* q);
+gerror_t queue_foreach(struct queue_t* q, queue_visit_function visit, void* argument);
 gerror_t queue_destroy(struct queue_t* q);
 gerror_t queue_remove(struct queue_t* q, struct qnode_t* node, void* e);
+gerror_t queue_get_stats(struct queue_t* q, gstats_t* stats);
 
 #endif
@@ -0,0 +1,77 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#ifndef __SNAPSHOT_H__
+#define __SNAPSHOT_H__
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "gerror.h"
+#include "vector.h"
+#include "graph.h"
+
+/*
+ * Snapshots: binary images of a `vector_t` or of a `graph_t` that
+ * are written once and memory-mapped read-only by many processes,
+ * without parsing or copying.
+ *
+ * The image starts with a `snapshot_header_t`, padded to
+ * SNAPSHOT_HEADER_SIZE bytes, followed by the payload; every
+ * section of the payload is aligned to 8 bytes:
+ *
+ *	vector:	uint8_t  data[size*member_size];
+ *
+ *	graph:	uint64_t row_offsets[size + 1];
+ *		uint64_t col_indices[edges];
+ *		double   weights[edges];	when SNAPSHOT_WEIGHTED
+ *		uint8_t  label[size*member_size];
+ *
+ * All the fields are in the byte order of the machine that wrote
+ * the snapshot.
+ */
+
+#define SNAPSHOT_MAGIC		"GSNAPSHT"
+#define SNAPSHOT_VERSION	1
+#define SNAPSHOT_HEADER_SIZE	64
+
+#define SNAPSHOT_WEIGHTED	0x1
+
+typedef enum snapshot_kind_t{
+	SNAPSHOT_VECTOR = 1,
+	SNAPSHOT_GRAPH
+}snapshot_kind_t;
+
+typedef struct snapshot_header_t{
+	char magic[8];
+	uint32_t version;
+	uint32_t kind;
+	uint64_t member_size;
+	uint64_t size;
+	uint64_t edges;
+	uint64_t flags;
+	uint64_t length;
+}snapshot_header_t;
+
+gerror_t vector_save(struct vector_t* v, const char* path);
+gerror_t vector_map(struct vector_t* v, const char* path);
+gerror_t vector_unmap(struct vector_t* v);
+gerror_t graph_save(struct graph_t* g, const char* path);
+gerror_t graph_map(struct graph_t* g, const char* path);
+gerror_t graph_unmap(struct graph_t* g);
+
+#endif
@@ -21,8 +21,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include "gerror.h"
+#include "node_pool.h"
+#include "vector.h"
+#include "gstats.h"
+#include "galloc.h"
 
 /** node of a stack
+  * The layout is the same of `pnode_t`, so the nodes
+  * may be carved from a `npool_t`.
   */
 typedef struct snode_t{
 	struct snode_t* next;
@@ -31,17 +37,56 @@ typedef struct snode_t{
 	void* data;
 }snode_t;
 
+/** Function called on every element of a stack, with its
+  * position from the top. A non-zero return stops the walk.
+  */
+typedef int (*stack_visit_function)(void* elem, size_t index, void* argument);
+
+/** Storage used by a stack_t.
+  */
+typedef enum stack_mode_t{
+	STACK_LIST,	/* singly linked list of snode_t */
+	STACK_ARRAY	/* contiguous vector_t, top at the end */
+}stack_mode_t;
+
 /** represents the stack structure.
+  *
+  * In the STACK_ARRAY mode the elements live in `vector`,
+  * from the bottom to the top, and `head` is not used.
+  *
+  * When `pool` is set, the nodes and their payload are
+  * blocks of that pool instead of two malloc'd pieces.
+  *
+  * The nodes, the vector and the own pool come from
+  * `allocator`, see galloc.h.
   */
 typedef struct stack_t{
 	size_t size;
 	size_t member_size;
 	struct snode_t* head;
+
+	struct npool_t* pool;
+	int owns_pool;
+
+	stack_mode_t mode;
+	struct vector_t vector;
+
+	const struct galloc_t* allocator;
+	GSTATS_ENTRY
 }stack_t;
 
 gerror_t stack_create(struct stack_t* q, size_t member_size);
+gerror_t stack_create_with_allocator(struct stack_t* s, size_t member_size, const struct galloc_t* allocator);
+gerror_t stack_create_pooled(struct stack_t* s, size_t member_size, struct npool_t* pool);
+gerror_t stack_create_array(struct stack_t* s, size_t member_size, size_t initial_size);
 gerror_t stack_push(struct stack_t* q, void* e);
 gerror_t stack_pop(struct stack_t* q, void* e);
+void* stack_top_ptr(struct stack_t* s);
+void* stack_emplace(struct stack_t* s);
+gerror_t stack_foreach(struct stack_t* s, stack_visit_function visit, void* argument);
+gerror_t stack_push_n(struct stack_t* s, void* e, size_t n);
+gerror_t stack_pop_n(struct stack_t* s, void* e, size_t n);
 gerror_t stack_destroy(struct stack_t* q);
+gerror_t stack_get_stats(struct stack_t* s, gstats_t* stats);
 
 #endif
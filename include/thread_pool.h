@@ -0,0 +1,84 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+#include <stdlib.h>
+#include <pthread.h>
+#include "gerror.h"
+
+/*
+ * maximum number of ranges waiting in the deque of a worker;
+ * a worker only splits a range in halves, so this bounds the
+ * depth of the splits
+ */
+#define TPOOL_DEQUE_SIZE 128
+
+/** Function called on the indexes from `begin` to `end - 1` by
+  * the worker `worker`, that is a number lower than the number
+  * of threads of the pool.
+  */
+typedef void (*tpool_range_function)(size_t begin, size_t end, size_t worker, void* argument);
+
+typedef struct tpool_range_t{
+	size_t begin;
+	size_t end;
+}tpool_range_t;
+
+/** Deque of ranges of a worker. The owner pushes and pops at
+  * the bottom, the other workers steal from the top.
+  */
+typedef struct tpool_deque_t{
+	pthread_mutex_t lock;
+	size_t top;
+	size_t bottom;
+	tpool_range_t ranges[TPOOL_DEQUE_SIZE];
+}tpool_deque_t;
+
+/** Thread pool structure and elements.
+  *
+  * The pool runs one parallel loop at a time; `generation`
+  * counts the loops so that the workers know when a new one
+  * starts. A loop started from inside a loop of the same pool
+  * runs inline on the calling worker, see `tpool_parallel_for`.
+  */
+typedef struct tpool_t{
+	size_t n_threads;
+	pthread_t* threads;
+	tpool_deque_t* deques;
+
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	pthread_cond_t done;
+	pthread_mutex_t run;
+	size_t generation;
+	size_t active;
+	int stop;
+
+	tpool_range_function function;
+	void* argument;
+	size_t grain;
+	size_t remaining;
+}tpool_t;
+
+gerror_t tpool_create(tpool_t* p, size_t n_threads);
+gerror_t tpool_parallel_for(tpool_t* p, size_t begin, size_t end, size_t grain,
+		tpool_range_function function, void* argument);
+gerror_t tpool_destroy(tpool_t* p);
+
+#endif
@@ -23,6 +23,9 @@
 #include <string.h>
 
 #include "gerror.h"
+#include "art.h"
+#include "gstats.h"
+#include "galloc.h"
 
 #define NBYTE (0x100)
 
@@ -33,20 +36,61 @@ typedef struct tnode_t {
 	struct tnode_t* children[NBYTE];
 } tnode_t;
 
+/** Function called on every element of a trie, with the key
+  * that maps it. A non-zero return stops the walk.
+  */
+typedef art_visit_function trie_visit_function;
+
+/** Node layout used by a trie_t.
+  */
+typedef enum trie_mode_t {
+	TRIE_DENSE,	/* tnode_t with NBYTE children */
+	TRIE_ADAPTIVE	/* adaptive radix tree, see art.h */
+} trie_mode_t;
+
 /** Represents the trie structure.
+  *
+  * In the TRIE_DENSE mode the nodes hang from `root`.
+  * In the TRIE_ADAPTIVE mode they hang from `art_root`.
+  * When `epoch` is set, see `trie_create_concurrent`, readers
+  * may run concurrently with a single writer.
+  *
+  * The nodes and the values come from `allocator`, see
+  * galloc.h; a concurrent trie uses `galloc_default`.
   */
 typedef struct trie_t {
 	size_t size;
 	size_t member_size;
 	struct tnode_t root;
+
+	trie_mode_t mode;
+	struct art_node_t* art_root;
+	struct epoch_t* epoch;
+
+	const struct galloc_t* allocator;
+	GSTATS_ENTRY
 } trie_t;
 
 gerror_t trie_create(struct trie_t* t, size_t member_size);
+gerror_t trie_create_adaptive(struct trie_t* t, size_t member_size);
+gerror_t trie_create_with_allocator(struct trie_t* t, size_t member_size, const struct galloc_t* allocator);
+gerror_t trie_create_adaptive_with_allocator(struct trie_t* t, size_t member_size, const struct galloc_t* allocator);
+gerror_t trie_create_concurrent(struct trie_t* t, size_t member_size, struct epoch_t* e);
 gerror_t trie_destroy(struct trie_t* t);
 gerror_t trie_add_element(struct trie_t* t, void* string, size_t size, void* elem);
 gerror_t trie_remove_element(struct trie_t* t, void* string, size_t size);
 gerror_t trie_get_element(struct trie_t* t, void* string, size_t size, void* elem);
+void* trie_get_ref(struct trie_t* t, void* string, size_t size);
+gerror_t trie_get_many(struct trie_t* t, void** keys, size_t* sizes, size_t n,
+		void* out, gerror_t* status);
+gerror_t trie_longest_prefix_match(struct trie_t* t, void* string, size_t size,
+		size_t* match_size, void* elem);
+void* trie_emplace(struct trie_t* t, void* string, size_t size);
+gerror_t trie_foreach(struct trie_t* t, trie_visit_function visit, void* argument);
+gerror_t trie_foreach_prefix(struct trie_t* t, void* string, size_t size,
+		trie_visit_function visit, void* argument);
 gerror_t trie_set_element(struct trie_t* t, void* string, size_t size, void* elem);
+gerror_t trie_get_stats(struct trie_t* t, gstats_t* stats);
 tnode_t* trie_get_node_or_allocate ( struct trie_t* t, void* string, size_t size);
 
 #endif
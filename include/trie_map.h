@@ -0,0 +1,77 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#ifndef __TRIE_MAP_H__
+#define __TRIE_MAP_H__
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "gerror.h"
+#include "trie.h"
+
+/*
+ * Frozen trie: a read-only, pointer-free image of a `trie_t`
+ * that can be written once and memory-mapped by many processes.
+ *
+ * The image starts with a `trie_map_header_t` and is followed by
+ * the node records, every one aligned to 8 bytes:
+ *
+ *	uint64_t value;			offset of the element or TRIE_MAP_NONE
+ *	uint32_t prefix_len;		bytes collapsed in this node
+ *	uint32_t n_children;
+ *	uint64_t children[n_children];	offsets of the children
+ *	uint8_t  prefix[prefix_len];
+ *	uint8_t  keys[n_children];	bytes of the children, sorted
+ *	uint8_t  element[member_size];	present when value is set,
+ *					after padding to 8 bytes
+ *
+ * All offsets are from the beginning of the image and all the
+ * fields are in the byte order of the machine that froze it.
+ */
+
+#define TRIE_MAP_MAGIC		"GTRIEMAP"
+#define TRIE_MAP_VERSION	1
+#define TRIE_MAP_NONE		((uint64_t)-1)
+
+typedef struct trie_map_header_t{
+	char magic[8];
+	uint32_t version;
+	uint32_t reserved;
+	uint64_t member_size;
+	uint64_t size;
+	uint64_t root;
+	uint64_t length;
+}trie_map_header_t;
+
+/** A frozen trie opened for lookups.
+  */
+typedef struct trie_map_t{
+	size_t size;
+	size_t member_size;
+	void* base;
+	size_t length;
+	uint64_t root;
+}trie_map_t;
+
+gerror_t trie_freeze(struct trie_t* t, const char* path);
+gerror_t trie_map_open(struct trie_map_t* m, const char* path);
+gerror_t trie_map_close(struct trie_map_t* m);
+gerror_t trie_map_get_element(struct trie_map_t* m, void* string, size_t size, void* elem);
+void* trie_map_get_ref(struct trie_map_t* m, void* string, size_t size);
+
+#endif
@@ -0,0 +1,262 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#ifndef __TYPED_H__
+#define __TYPED_H__
+#include <stdlib.h>
+#include <string.h>
+#include "gerror.h"
+
+/*
+ * Generators of type-specialized containers. Every generator
+ * emits a structure and `static` functions prefixed by `name`,
+ * so the compiler knows the element type and the comparison at
+ * compile time: copies become plain assignments and the
+ * comparison is inlined in the sift loops.
+ *
+ * Use them once per translation unit, e.g.:
+ *
+ *	#define int_less(a, b) ((a) < (b))
+ *	GENERICS_VECTOR_DECLARE(ivector, int)
+ *	GENERICS_PQUEUE_DECLARE(ipqueue, int, int_less)
+ */
+
+#ifndef GENERICS_INLINE
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#define GENERICS_INLINE static inline
+#elif defined(__GNUC__)
+#define GENERICS_INLINE static __inline__
+#else
+#define GENERICS_INLINE static
+#endif
+#endif
+
+/** Declares `name_t`, a vector of `type`, and its functions:
+  * name_create, name_destroy, name_reserve, name_push, name_pop,
+  * name_at and name_ptr_at. name_at and name_ptr_at do not check
+  * the bounds.
+  */
+#define GENERICS_VECTOR_DECLARE(name, type)					\
+typedef struct name##_t{							\
+	type* data;								\
+	size_t size;								\
+	size_t capacity;							\
+} name##_t;									\
+										\
+GENERICS_INLINE gerror_t name##_reserve (name##_t* v, size_t n)		\
+{										\
+	if(!v) return GERROR_NULL_STRUCTURE;					\
+	if(n > v->capacity){							\
+		v->data = (type*) realloc(v->data, n*sizeof(type));		\
+		v->capacity = n;						\
+	}									\
+	return GERROR_OK;							\
+}										\
+										\
+GENERICS_INLINE gerror_t name##_create (name##_t* v, size_t initial_size)	\
+{										\
+	if(!v) return GERROR_NULL_STRUCTURE;					\
+	v->data = NULL;								\
+	v->size = v->capacity = 0;						\
+	return name##_reserve(v, initial_size? initial_size : 8);		\
+}										\
+										\
+GENERICS_INLINE gerror_t name##_destroy (name##_t* v)				\
+{										\
+	if(!v) return GERROR_NULL_STRUCTURE;					\
+	free(v->data);								\
+	v->data = NULL;								\
+	v->size = v->capacity = 0;						\
+	return GERROR_OK;							\
+}										\
+										\
+GENERICS_INLINE gerror_t name##_push (name##_t* v, type e)			\
+{										\
+	if(v->size == v->capacity)						\
+		name##_reserve(v, v->capacity*2);				\
+	v->data[v->size++] = e;							\
+	return GERROR_OK;							\
+}										\
+										\
+GENERICS_INLINE gerror_t name##_pop (name##_t* v, type* e)			\
+{										\
+	if(!v->size) return GERROR_TRY_REMOVE_EMPTY_STRUCTURE;			\
+	v->size--;								\
+	if(e) *e = v->data[v->size];						\
+	return GERROR_OK;							\
+}										\
+										\
+GENERICS_INLINE type name##_at (name##_t* v, size_t index)			\
+{										\
+	return v->data[index];							\
+}										\
+										\
+GENERICS_INLINE type* name##_ptr_at (name##_t* v, size_t index)		\
+{										\
+	return v->data + index;							\
+}
+
+/** Declares `name_t`, a ring queue of `type`, and its functions:
+  * name_create, name_destroy, name_enqueue and name_dequeue.
+  * The buffer has a power of two capacity and doubles when full.
+  */
+#define GENERICS_QUEUE_DECLARE(name, type)					\
+typedef struct name##_t{							\
+	type* data;								\
+	size_t size;								\
+	size_t capacity;							\
+	size_t first;								\
+} name##_t;									\
+										\
+GENERICS_INLINE gerror_t name##_create (name##_t* q, size_t initial_capacity)	\
+{										\
+	if(!q) return GERROR_NULL_STRUCTURE;					\
+	q->capacity = 16;							\
+	while(q->capacity < initial_capacity)					\
+		q->capacity *= 2;						\
+	q->data = (type*) malloc(q->capacity*sizeof(type));			\
+	q->size = q->first = 0;							\
+	return GERROR_OK;							\
+}										\
+										\
+GENERICS_INLINE gerror_t name##_destroy (name##_t* q)				\
+{										\
+	if(!q) return GERROR_NULL_STRUCTURE;					\
+	free(q->data);								\
+	q->data = NULL;								\
+	q->size = q->capacity = q->first = 0;					\
+	return GERROR_OK;							\
+}										\
+										\
+GENERICS_INLINE gerror_t name##_enqueue (name##_t* q, type e)			\
+{										\
+	if(q->size == q->capacity){						\
+		size_t old_capacity = q->capacity;				\
+		q->capacity *= 2;						\
+		q->data = (type*) realloc(q->data, q->capacity*sizeof(type));	\
+		if(q->first + q->size > old_capacity)				\
+			memcpy(	q->data + old_capacity, q->data,		\
+				(q->first + q->size - old_capacity)*sizeof(type));\
+	}									\
+	q->data[(q->first + q->size) & (q->capacity - 1)] = e;			\
+	q->size++;								\
+	return GERROR_OK;							\
+}										\
+										\
+GENERICS_INLINE gerror_t name##_dequeue (name##_t* q, type* e)		\
+{										\
+	if(!q->size) return GERROR_TRY_REMOVE_EMPTY_STRUCTURE;			\
+	if(e) *e = q->data[q->first];						\
+	q->first = (q->first + 1) & (q->capacity - 1);				\
+	q->size--;								\
+	return GERROR_OK;							\
+}
+
+/** Declares `name_t`, a binary heap of `type`, and its functions:
+  * name_create, name_create_from_array, name_destroy, name_add,
+  * name_top and name_extract. `less(a, b)` may be a macro or a
+  * function and is true when `a` has more priority than `b`, so
+  * the top is the least element.
+  */
+#define GENERICS_PQUEUE_DECLARE(name, type, less)				\
+typedef struct name##_t{							\
+	type* data;								\
+	size_t size;								\
+	size_t capacity;							\
+} name##_t;									\
+										\
+GENERICS_INLINE void name##_sift_down (name##_t* p, size_t i)			\
+{										\
+	type e = p->data[i];							\
+	for(;;){								\
+		size_t child = 2*i + 1;						\
+		if(child >= p->size) break;					\
+		if(child + 1 < p->size && less(p->data[child+1], p->data[child]))\
+			child++;						\
+		if(!less(p->data[child], e)) break;				\
+		p->data[i] = p->data[child];					\
+		i = child;							\
+	}									\
+	p->data[i] = e;								\
+}										\
+										\
+GENERICS_INLINE gerror_t name##_create (name##_t* p, size_t initial_size)	\
+{										\
+	if(!p) return GERROR_NULL_STRUCTURE;					\
+	p->capacity = initial_size? initial_size : 8;				\
+	p->data = (type*) malloc(p->capacity*sizeof(type));			\
+	p->size = 0;								\
+	return GERROR_OK;							\
+}										\
+										\
+GENERICS_INLINE gerror_t name##_create_from_array (name##_t* p, type* array, size_t n)\
+{										\
+	size_t i;								\
+	gerror_t s = name##_create(p, n);					\
+	if(s != GERROR_OK) return s;						\
+	memcpy(p->data, array, n*sizeof(type));					\
+	p->size = n;								\
+	for(i = n/2; i > 0; i--)						\
+		name##_sift_down(p, i-1);					\
+	return GERROR_OK;							\
+}										\
+										\
+GENERICS_INLINE gerror_t name##_destroy (name##_t* p)				\
+{										\
+	if(!p) return GERROR_NULL_STRUCTURE;					\
+	free(p->data);								\
+	p->data = NULL;								\
+	p->size = p->capacity = 0;						\
+	return GERROR_OK;							\
+}										\
+										\
+GENERICS_INLINE gerror_t name##_add (name##_t* p, type e)			\
+{										\
+	if(p->size == p->capacity){						\
+		p->capacity *= 2;						\
+		p->data = (type*) realloc(p->data, p->capacity*sizeof(type));	\
+	}									\
+	size_t i = p->size++;							\
+	while(i > 0 && less(e, p->data[(i-1)/2])){				\
+		p->data[i] = p->data[(i-1)/2];					\
+		i = (i-1)/2;							\
+	}									\
+	p->data[i] = e;								\
+	return GERROR_OK;							\
+}										\
+										\
+GENERICS_INLINE gerror_t name##_top (name##_t* p, type* e)			\
+{										\
+	if(!p->size) return GERROR_ACCESS_OUT_OF_BOUND;				\
+	*e = p->data[0];							\
+	return GERROR_OK;							\
+}										\
+										\
+GENERICS_INLINE gerror_t name##_extract (name##_t* p, type* e)		\
+{										\
+	if(!p->size) return GERROR_ACCESS_OUT_OF_BOUND;				\
+	if(e) *e = p->data[0];							\
+	p->size--;								\
+	if(p->size){								\
+		p->data[0] = p->data[p->size];					\
+		name##_sift_down(p, 0);						\
+	}									\
+	return GERROR_OK;							\
+}
+
+#endif
@@ -23,21 +23,62 @@
 #include <string.h>
 
 #include "gerror.h"
+#include "gstats.h"
+#include "galloc.h"
+
+/** Represents a vector structure.
+  *
+  * `buffer_size` is in bytes. When the buffer is full it grows
+  * geometrically by `growth_factor`, but never by more than
+  * `growth_cap` elements at once (0 means no cap), and it never
+  * holds less than `min_size` elements.
+  *
+  * When `epoch` is set, see `vector_set_epoch`, readers may run
+  * concurrently with a single writer.
+  *
+  * The buffer comes from `allocator`, see galloc.h.
+  */
+/** Function called on every element of a vector, with its
+  * index. A non-zero return stops the walk.
+  */
+typedef int (*vector_visit_function)(void* elem, size_t index, void* argument);
 
 typedef struct vector_t {
 	void* data;
 	size_t size;
 	size_t buffer_size;
 	size_t member_size;
+
+	size_t min_size;
+	double growth_factor;
+	size_t growth_cap;
+
+	struct epoch_t* epoch;
+	const struct galloc_t* allocator;
+	GSTATS_ENTRY
 } vector_t;
 
 gerror_t vector_create (vector_t* v, size_t initial_size, size_t member_size);
+gerror_t vector_create_with_allocator (vector_t* v, size_t initial_size, size_t member_size,
+		const struct galloc_t* allocator);
 gerror_t vector_destroy (vector_t* v);
+gerror_t vector_set_epoch (vector_t* v, struct epoch_t* e);
 gerror_t vector_resize_buffer (vector_t* v, size_t new_size);
+gerror_t vector_set_growth_policy (vector_t* v, double growth_factor, size_t growth_cap);
+gerror_t vector_grow (vector_t* v, size_t n_elements);
+gerror_t vector_reserve (vector_t* v, size_t n_elements);
+gerror_t vector_shrink_to_fit (vector_t* v);
 gerror_t vector_at (vector_t* v, size_t index, void* elem);
 void* vector_ptr_at (vector_t* v, size_t index);
 gerror_t vector_set_elem_at (vector_t* v, size_t index, void* elem);
 gerror_t vector_add (vector_t* v, void* elem);
+void* vector_emplace (vector_t* v);
+gerror_t vector_append_n (vector_t* v, void* elems, size_t n);
+gerror_t vector_insert_range (vector_t* v, size_t index, void* elems, size_t n);
+gerror_t vector_erase_range (vector_t* v, size_t index, size_t n);
+gerror_t vector_clear (vector_t* v);
+gerror_t vector_foreach (vector_t* v, vector_visit_function visit, void* argument);
+gerror_t vector_get_stats (vector_t* v, gstats_t* stats);
 void vector_set_min_buf_siz(size_t new_min_buf_size);
 size_t vector_get_min_buf_siz(void);
 
@@ -0,0 +1,72 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#ifndef __VECTOR_ALGORITHM_H__
+#define __VECTOR_ALGORITHM_H__
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "gerror.h"
+#include "vector.h"
+#include "priority_queue.h"
+
+/*
+ * Kernels over the elements of a vector_t.
+ *
+ * The functions that interpret the elements receive their type.
+ * The numeric types have fast paths on vectors of 4 or 8 bytes
+ * elements: AVX2 when the processor has it, NEON on AArch64, and
+ * loops the compiler vectorizes otherwise; `vector_sort` sorts
+ * them with an LSD radix sort. VECTOR_GENERIC elements are
+ * ordered by a compare function instead, that returns a negative
+ * value when `a` goes before `b`, as G_PQUEUE_FIRST_PRIORITY.
+ *
+ * The order of the floating types puts the NaNs at the ends, by
+ * their sign bit. A vector with an epoch is not sorted nor
+ * filled, its readers would see the elements being written.
+ */
+
+/** Type of the elements of a vector.
+  */
+typedef enum vector_type_t{
+	VECTOR_GENERIC,	/* any size, ordered by a compare function */
+	VECTOR_INT32,
+	VECTOR_UINT32,
+	VECTOR_INT64,
+	VECTOR_UINT64,
+	VECTOR_FLOAT,
+	VECTOR_DOUBLE
+}vector_type_t;
+
+/** Predicate of `vector_count_if`: non-zero when `elem` is
+  * counted.
+  */
+typedef int (*vector_predicate_function)(void* elem, void* argument);
+
+gerror_t vector_find(vector_t* v, void* elem, size_t* index);
+gerror_t vector_count_if(vector_t* v, vector_predicate_function predicate, void* argument,
+		size_t* count);
+gerror_t vector_count_range(vector_t* v, vector_type_t type, void* low, void* high,
+		size_t* count);
+gerror_t vector_fill(vector_t* v, void* elem);
+gerror_t vector_min_max(vector_t* v, vector_type_t type, compare_function compare,
+		void* argument, void* min, void* max);
+gerror_t vector_sort(vector_t* v, vector_type_t type, compare_function compare,
+		void* argument);
+
+#endif
@@ -0,0 +1,920 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#include "art.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#define ART_NODE16_SHRINK 3
+#define ART_NODE48_SHRINK 12
+#define ART_NODE256_SHRINK 37
+
+/*
+ * auxiliar function;
+ * size in bytes of a node of `type`
+ */
+size_t art_node_size (art_type_t type)
+{
+	switch(type){
+	case ART_LEAF:		return sizeof(art_node_t);
+	case ART_NODE4:		return sizeof(art_node4_t);
+	case ART_NODE16:	return sizeof(art_node16_t);
+	case ART_NODE48:	return sizeof(art_node48_t);
+	case ART_NODE256:	return sizeof(art_node256_t);
+	}
+
+	return sizeof(art_node_t);
+}
+
+/*
+ * auxiliar function;
+ * replaces the node in `ref` by a private copy of it and
+ * adds the original to `retired`
+ */
+void art_clone_node (art_node_t** ref, vector_t* retired, const galloc_t* a)
+{
+	size_t size = art_node_size((art_type_t)(*ref)->type);
+	art_node_t* copy = (art_node_t*) GALLOC_ALLOC(a, size);
+
+	memcpy(copy, *ref, size);
+	vector_add(retired, ref);
+	*ref = copy;
+}
+
+/*
+ * auxiliar function;
+ * allocates an empty node of `type`
+ */
+art_node_t* art_alloc_node (art_type_t type, const galloc_t* a)
+{
+	art_node_t* node = (art_node_t*) galloc_zeroed(a, art_node_size(type));
+	node->type = type;
+	return node;
+}
+
+/*
+ * auxiliar function;
+ * copies the header of `src` to the header of `dst`,
+ * keeping the type of `dst`
+ */
+void art_copy_header (art_node_t* dst, art_node_t* src)
+{
+	dst->prefix_len = src->prefix_len;
+	dst->n_children = src->n_children;
+	memcpy(dst->prefix, src->prefix, src->prefix_len);
+	dst->value = src->value;
+}
+
+/*
+ * auxiliar function;
+ * the sorted arrays of keys and children of a NODE4 or a NODE16
+ */
+void art_sorted_arrays (art_node_t* node, unsigned char** keys, art_node_t*** children)
+{
+	if(node->type == ART_NODE4){
+		*keys = ((art_node4_t*)node)->keys;
+		*children = ((art_node4_t*)node)->children;
+	}else{
+		*keys = ((art_node16_t*)node)->keys;
+		*children = ((art_node16_t*)node)->children;
+	}
+}
+
+/** Finds the child of `node` that follows the `byte`.
+  *
+  * @param node	pointer to a node of any type;
+  * @param byte	byte of the edge
+  *
+  * @return	pointer to the slot of `node` that holds the child
+  * 		or NULL in case there is no such child
+  */
+art_node_t** art_find_child (art_node_t* node, unsigned char byte)
+{
+	int i;
+	unsigned char index;
+	art_node4_t* n4;
+	art_node16_t* n16;
+	art_node48_t* n48;
+	art_node256_t* n256;
+
+	switch(node->type){
+	case ART_NODE4:
+		n4 = (art_node4_t*) node;
+		for( i=0; i<node->n_children; i++ )
+			if( n4->keys[i] == byte )
+				return &n4->children[i];
+		return NULL;
+
+	case ART_NODE16:
+		n16 = (art_node16_t*) node;
+#if defined(__SSE2__)
+		{
+			__m128i cmp = _mm_cmpeq_epi8(	_mm_set1_epi8((char)byte),
+							_mm_loadu_si128((__m128i*)n16->keys) );
+			int mask = _mm_movemask_epi8(cmp) & ((1 << node->n_children) - 1);
+			if( mask )
+				return &n16->children[__builtin_ctz(mask)];
+		}
+#elif defined(__ARM_NEON)
+		{
+			uint8x16_t cmp = vceqq_u8(vdupq_n_u8(byte), vld1q_u8(n16->keys));
+			uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(
+					vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4)), 0);
+			if( node->n_children < 16 )
+				mask &= ((uint64_t)1 << (node->n_children*4)) - 1;
+			if( mask )
+				return &n16->children[__builtin_ctzll(mask) >> 2];
+		}
+#else
+		for( i=0; i<node->n_children; i++ )
+			if( n16->keys[i] == byte )
+				return &n16->children[i];
+#endif
+		return NULL;
+
+	case ART_NODE48:
+		n48 = (art_node48_t*) node;
+		index = n48->index[byte];
+		if( index )
+			return &n48->children[index-1];
+		return NULL;
+
+	case ART_NODE256:
+		n256 = (art_node256_t*) node;
+		if( n256->children[byte] )
+			return &n256->children[byte];
+		return NULL;
+	}
+
+	return NULL;
+}
+
+/** Lists the children of `node` in the order of their bytes.
+  *
+  * @param node		pointer to a node of any type;
+  * @param keys		room for 256 bytes that will receive
+  * 			the bytes of the children;
+  * @param children	room for 256 pointers that will receive
+  * 			the children
+  *
+  * @return	the number of children of `node`
+  */
+size_t art_children (art_node_t* node, unsigned char* keys, art_node_t** children)
+{
+	unsigned char* node_keys;
+	art_node_t** node_children;
+	size_t n = 0;
+	int i;
+
+	switch(node->type){
+	case ART_NODE4:
+	case ART_NODE16:
+		art_sorted_arrays(node, &node_keys, &node_children);
+		memcpy(keys, node_keys, node->n_children);
+		memcpy(children, node_children, node->n_children*sizeof(art_node_t*));
+		n = node->n_children;
+		break;
+
+	case ART_NODE48:
+		for( i=0; i<256; i++ )
+			if( ((art_node48_t*)node)->index[i] ){
+				keys[n] = (unsigned char)i;
+				children[n++] = ((art_node48_t*)node)->children[
+						((art_node48_t*)node)->index[i]-1 ];
+			}
+		break;
+
+	case ART_NODE256:
+		for( i=0; i<256; i++ )
+			if( ((art_node256_t*)node)->children[i] ){
+				keys[n] = (unsigned char)i;
+				children[n++] = ((art_node256_t*)node)->children[i];
+			}
+		break;
+	}
+
+	return n;
+}
+
+/*
+ * auxiliar function;
+ * finds the child of `node` with the lowest byte, `node`
+ * must have at least one child
+ */
+art_node_t** art_first_child (art_node_t* node, unsigned char* byte)
+{
+	unsigned char* keys;
+	art_node_t** children;
+	int i;
+
+	switch(node->type){
+	case ART_NODE4:
+	case ART_NODE16:
+		art_sorted_arrays(node, &keys, &children);
+		*byte = keys[0];
+		return &children[0];
+
+	case ART_NODE48:
+		for( i=0; i<256; i++ )
+			if( ((art_node48_t*)node)->index[i] ){
+				*byte = (unsigned char)i;
+				return &((art_node48_t*)node)->children[
+						((art_node48_t*)node)->index[i]-1 ];
+			}
+		break;
+
+	case ART_NODE256:
+		for( i=0; i<256; i++ )
+			if( ((art_node256_t*)node)->children[i] ){
+				*byte = (unsigned char)i;
+				return &((art_node256_t*)node)->children[i];
+			}
+		break;
+	}
+
+	return NULL;
+}
+
+/*
+ * auxiliar function;
+ * replaces the node in `ref` by a node of the next bigger type
+ */
+void art_grow (art_node_t** ref, const galloc_t* a)
+{
+	art_node_t* node = *ref;
+	art_node_t* bigger = NULL;
+	unsigned char* keys;
+	art_node_t** children;
+	int i;
+
+	switch(node->type){
+	case ART_LEAF:
+		bigger = art_alloc_node(ART_NODE4, a);
+		break;
+
+	case ART_NODE4:
+		bigger = art_alloc_node(ART_NODE16, a);
+		art_sorted_arrays(node, &keys, &children);
+		memcpy(((art_node16_t*)bigger)->keys, keys, node->n_children);
+		memcpy(	((art_node16_t*)bigger)->children, children,
+			node->n_children*sizeof(art_node_t*) );
+		break;
+
+	case ART_NODE16:
+		bigger = art_alloc_node(ART_NODE48, a);
+		art_sorted_arrays(node, &keys, &children);
+		for( i=0; i<node->n_children; i++ ){
+			((art_node48_t*)bigger)->index[keys[i]] = (unsigned char)(i+1);
+			((art_node48_t*)bigger)->children[i] = children[i];
+		}
+		break;
+
+	case ART_NODE48:
+		bigger = art_alloc_node(ART_NODE256, a);
+		for( i=0; i<256; i++ )
+			if( ((art_node48_t*)node)->index[i] )
+				((art_node256_t*)bigger)->children[i] =
+					((art_node48_t*)node)->children[
+						((art_node48_t*)node)->index[i]-1 ];
+		break;
+
+	default:
+		return;
+	}
+
+	art_copy_header(bigger, node);
+	GALLOC_FREE(a, node, art_node_size((art_type_t)node->type));
+	*ref = bigger;
+}
+
+/*
+ * auxiliar function;
+ * replaces the node in `ref` by a node of the next smaller
+ * type when it has few enough children
+ */
+void art_shrink (art_node_t** ref, const galloc_t* a)
+{
+	art_node_t* node = *ref;
+	art_node_t* smaller = NULL;
+	unsigned char* keys;
+	art_node_t** children;
+	int i, j;
+
+	switch(node->type){
+	case ART_NODE4:
+		if( node->n_children ) return;
+		smaller = art_alloc_node(ART_LEAF, a);
+		break;
+
+	case ART_NODE16:
+		if( node->n_children > ART_NODE16_SHRINK ) return;
+		smaller = art_alloc_node(ART_NODE4, a);
+		art_sorted_arrays(node, &keys, &children);
+		memcpy(((art_node4_t*)smaller)->keys, keys, node->n_children);
+		memcpy(	((art_node4_t*)smaller)->children, children,
+			node->n_children*sizeof(art_node_t*) );
+		break;
+
+	case ART_NODE48:
+		if( node->n_children > ART_NODE48_SHRINK ) return;
+		smaller = art_alloc_node(ART_NODE16, a);
+		for( i=0, j=0; i<256; i++ )
+			if( ((art_node48_t*)node)->index[i] ){
+				((art_node16_t*)smaller)->keys[j] = (unsigned char)i;
+				((art_node16_t*)smaller)->children[j++] =
+					((art_node48_t*)node)->children[
+						((art_node48_t*)node)->index[i]-1 ];
+			}
+		break;
+
+	case ART_NODE256:
+		if( node->n_children > ART_NODE256_SHRINK ) return;
+		smaller = art_alloc_node(ART_NODE48, a);
+		for( i=0, j=0; i<256; i++ )
+			if( ((art_node256_t*)node)->children[i] ){
+				((art_node48_t*)smaller)->index[i] = (unsigned char)(j+1);
+				((art_node48_t*)smaller)->children[j++] =
+					((art_node256_t*)node)->children[i];
+			}
+		break;
+
+	default:
+		return;
+	}
+
+	art_copy_header(smaller, node);
+	GALLOC_FREE(a, node, art_node_size((art_type_t)node->type));
+	*ref = smaller;
+}
+
+/*
+ * auxiliar function;
+ * adds `child` after the `byte` in the node in `ref`,
+ * growing the node if it is full
+ */
+void art_add_child (art_node_t** ref, unsigned char byte, art_node_t* child, const galloc_t* a)
+{
+	art_node_t* node = *ref;
+	unsigned char* keys;
+	art_node_t** children;
+	int i;
+
+	if(	node->type == ART_LEAF ||
+		(node->type == ART_NODE4 && node->n_children == 4) ||
+		(node->type == ART_NODE16 && node->n_children == 16) ||
+		(node->type == ART_NODE48 && node->n_children == 48) ){
+		art_grow(ref, a);
+		node = *ref;
+	}
+
+	switch(node->type){
+	case ART_NODE4:
+	case ART_NODE16:
+		art_sorted_arrays(node, &keys, &children);
+		for( i=0; i<node->n_children && keys[i] < byte; i++ );
+		memmove(keys + i + 1, keys + i, node->n_children - i);
+		memmove(children + i + 1, children + i, (node->n_children - i)*sizeof(art_node_t*));
+		keys[i] = byte;
+		children[i] = child;
+		break;
+
+	case ART_NODE48:
+		for( i=0; ((art_node48_t*)node)->children[i]; i++ );
+		((art_node48_t*)node)->children[i] = child;
+		((art_node48_t*)node)->index[byte] = (unsigned char)(i+1);
+		break;
+
+	case ART_NODE256:
+		((art_node256_t*)node)->children[byte] = child;
+		break;
+	}
+
+	node->n_children++;
+}
+
+/*
+ * auxiliar function;
+ * removes the child after the `byte` from the node in `ref`,
+ * shrinking the node if it has few children left
+ */
+void art_remove_child (art_node_t** ref, unsigned char byte, const galloc_t* a)
+{
+	art_node_t* node = *ref;
+	unsigned char* keys;
+	art_node_t** children;
+	unsigned char index;
+	int i;
+
+	switch(node->type){
+	case ART_NODE4:
+	case ART_NODE16:
+		art_sorted_arrays(node, &keys, &children);
+		for( i=0; keys[i] != byte; i++ );
+		memmove(keys + i, keys + i + 1, node->n_children - i - 1);
+		memmove(children + i, children + i + 1, (node->n_children - i - 1)*sizeof(art_node_t*));
+		break;
+
+	case ART_NODE48:
+		index = ((art_node48_t*)node)->index[byte];
+		((art_node48_t*)node)->children[index-1] = NULL;
+		((art_node48_t*)node)->index[byte] = 0;
+		break;
+
+	case ART_NODE256:
+		((art_node256_t*)node)->children[byte] = NULL;
+		break;
+	}
+
+	node->n_children--;
+	if( node->type != ART_NODE4 )
+		art_shrink(ref, a);
+}
+
+/*
+ * auxiliar function;
+ * number of bytes of the prefix of `node` that match `key`
+ */
+size_t art_prefix_match (art_node_t* node, unsigned char* key, size_t size)
+{
+	size_t i, max = node->prefix_len < size? node->prefix_len : size;
+
+	for( i=0; i<max && node->prefix[i] == key[i]; i++ );
+	return i;
+}
+
+/*
+ * auxiliar function;
+ * builds the chain of nodes that maps the `size` bytes of
+ * `key`, the last node of the chain is written in `terminal`
+ */
+art_node_t* art_new_path (unsigned char* key, size_t size, art_node_t** terminal, const galloc_t* a)
+{
+	art_node_t* head = NULL;
+	art_node_t** ref = &head;
+
+	while( size > ART_MAX_PREFIX ){
+		art_node4_t* node = (art_node4_t*) art_alloc_node(ART_NODE4, a);
+		node->n.prefix_len = ART_MAX_PREFIX;
+		memcpy(node->n.prefix, key, ART_MAX_PREFIX);
+		node->keys[0] = key[ART_MAX_PREFIX];
+		node->n.n_children = 1;
+
+		*ref = &node->n;
+		ref = &node->children[0];
+		key += ART_MAX_PREFIX + 1;
+		size -= ART_MAX_PREFIX + 1;
+	}
+
+	*terminal = art_alloc_node(ART_LEAF, a);
+	(*terminal)->prefix_len = (unsigned char)size;
+	memcpy((*terminal)->prefix, key, size);
+	*ref = *terminal;
+
+	return head;
+}
+
+/*
+ * auxiliar function;
+ * collapses the node in `ref` after a removal: an empty node
+ * without value is freed, a node without children becomes a
+ * leaf and a node without value and with only one child is
+ * merged into the child when the prefixes fit in one node;
+ * when `retired` is not NULL the child is shared with readers,
+ * so it is copied before the merge
+ */
+void art_compact (art_node_t** ref, vector_t* retired, const galloc_t* a)
+{
+	art_node_t* node = *ref;
+
+	if( node->n_children == 0 ){
+		if( !node->value ){
+			GALLOC_FREE(a, node, art_node_size((art_type_t)node->type));
+			*ref = NULL;
+		}else{
+			art_shrink(ref, a);
+		}
+		return;
+	}
+
+	if( node->n_children == 1 && !node->value ){
+		unsigned char byte;
+		art_node_t** child_ref = art_first_child(node, &byte);
+		art_node_t* child = *child_ref;
+
+		if( node->prefix_len + 1 + child->prefix_len <= ART_MAX_PREFIX ){
+			if( retired ){
+				art_clone_node(child_ref, retired, a);
+				child = *child_ref;
+			}
+			memmove(child->prefix + node->prefix_len + 1, child->prefix, child->prefix_len);
+			memcpy(child->prefix, node->prefix, node->prefix_len);
+			child->prefix[node->prefix_len] = byte;
+			child->prefix_len += node->prefix_len + 1;
+
+			GALLOC_FREE(a, node, art_node_size((art_type_t)node->type));
+			*ref = child;
+		}
+	}
+}
+
+/** Finds the value mapped by the `size` bytes of `string` in the
+  * tree `root`.
+  *
+  * @param root		root node of the tree or NULL;
+  * @param string	pointer to the string of bytes;
+  * @param size		size of the string of bytes
+  *
+  * @return	the value or NULL in case `string` is not mapped
+  */
+void* art_get (art_node_t* root, void* string, size_t size)
+{
+	unsigned char* key = (unsigned char*) string;
+	art_node_t* node = root;
+	size_t depth = 0;
+
+	while( node ){
+		if( node->prefix_len ){
+			if(	size - depth < node->prefix_len ||
+				memcmp(node->prefix, key + depth, node->prefix_len) )
+				return NULL;
+			depth += node->prefix_len;
+		}
+
+		if( depth == size )
+			return node->value;
+
+		art_node_t** child = art_find_child(node, key[depth]);
+		if( !child )
+			return NULL;
+
+		node = *child;
+		depth++;
+	}
+
+	return NULL;
+}
+
+/** Finds the slot of the value mapped by the `size` bytes of
+  * `string`, adding the nodes to map `string` when needed. The
+  * slot is NULL when `string` was not mapped yet; it is only
+  * valid until the tree is changed again.
+  *
+  * @param root		pointer to the root of the tree;
+  * @param string	pointer to the string of bytes;
+  * @param size		size of the string of bytes;
+  * @param a		allocator of the nodes of the tree
+  *
+  * @return	pointer to the value slot of the node of `string`
+  */
+void** art_insert (art_node_t** root, void* string, size_t size, const galloc_t* a)
+{
+	unsigned char* key = (unsigned char*) string;
+	art_node_t** ref = root;
+	art_node_t* terminal;
+	size_t depth = 0;
+
+	for(;;){
+		art_node_t* node = *ref;
+
+		if( !node ){
+			*ref = art_new_path(key + depth, size - depth, &terminal, a);
+			return &terminal->value;
+		}
+
+		size_t match = art_prefix_match(node, key + depth, size - depth);
+		if( match < node->prefix_len ){
+			/*
+			 * the key leaves the compressed path of `node`,
+			 * so the path is split by a new node
+			 */
+			art_node_t* split = art_alloc_node(ART_NODE4, a);
+			split->prefix_len = (unsigned char)match;
+			memcpy(split->prefix, node->prefix, match);
+
+			unsigned char byte = node->prefix[match];
+			node->prefix_len -= match + 1;
+			memmove(node->prefix, node->prefix + match + 1, node->prefix_len);
+			art_add_child(&split, byte, node, a);
+
+			depth += match;
+			terminal = split;
+			if( depth < size )
+				art_add_child(&split, key[depth],
+					art_new_path(key + depth + 1, size - depth - 1, &terminal, a), a);
+
+			*ref = split;
+			return &terminal->value;
+		}
+
+		depth += node->prefix_len;
+		if( depth == size )
+			return &node->value;
+
+		art_node_t** child = art_find_child(node, key[depth]);
+		if( !child ){
+			art_node_t* path = art_new_path(key + depth + 1, size - depth - 1, &terminal, a);
+			art_add_child(ref, key[depth], path, a);
+			return &terminal->value;
+		}
+
+		ref = child;
+		depth++;
+	}
+}
+
+/*
+ * auxiliar function;
+ * removes `key` from the subtree in `ref`, compacting the
+ * nodes on the way back; `retired` is passed to `art_compact`
+ */
+void* art_remove_node (art_node_t** ref, unsigned char* key, size_t size, size_t depth,
+		vector_t* retired, const galloc_t* a)
+{
+	art_node_t* node = *ref;
+	void* removed;
+
+	if( !node ) return NULL;
+
+	if( node->prefix_len ){
+		if(	size - depth < node->prefix_len ||
+			memcmp(node->prefix, key + depth, node->prefix_len) )
+			return NULL;
+		depth += node->prefix_len;
+	}
+
+	if( depth == size ){
+		removed = node->value;
+		if( !removed ) return NULL;
+		node->value = NULL;
+	}else{
+		art_node_t** child = art_find_child(node, key[depth]);
+		if( !child ) return NULL;
+
+		removed = art_remove_node(child, key, size, depth + 1, retired, a);
+		if( !removed ) return NULL;
+
+		if( !*child )
+			art_remove_child(ref, key[depth], a);
+	}
+
+	art_compact(ref, retired, a);
+	return removed;
+}
+
+/** Unmaps the `size` bytes of `string` from the tree in `root`
+  * and frees the nodes that are not needed anymore.
+  *
+  * @param root		pointer to the root of the tree;
+  * @param string	pointer to the string of bytes;
+  * @param size		size of the string of bytes;
+  * @param a		allocator of the nodes of the tree
+  *
+  * @return	the value that was mapped by `string`, that has to be
+  * 		deallocated by the caller, or NULL in case `string`
+  * 		was not mapped
+  */
+void* art_remove (art_node_t** root, void* string, size_t size, const galloc_t* a)
+{
+	return art_remove_node(root, (unsigned char*) string, size, 0, NULL, a);
+}
+
+/*
+ * auxiliar function;
+ * replaces every node on the search path of `key` in the tree
+ * in `root` by a private copy, the originals are added to
+ * `retired`. The nodes off the path stay shared.
+ */
+void art_copy_path (art_node_t** root, unsigned char* key, size_t size, vector_t* retired)
+{
+	art_node_t** ref = root;
+	size_t depth = 0;
+
+	while( *ref ){
+		art_clone_node(ref, retired, &galloc_default);
+
+		art_node_t* node = *ref;
+		if( art_prefix_match(node, key + depth, size - depth) < node->prefix_len )
+			return;
+
+		depth += node->prefix_len;
+		if( depth == size )
+			return;
+
+		ref = art_find_child(node, key[depth]);
+		if( !ref )
+			return;
+		depth++;
+	}
+}
+
+/** Same as `art_insert`, but the tree in `root` is shared with
+  * readers and it is never changed: the nodes on the path of
+  * `string` are copied, `root` receives the new root and the
+  * replaced nodes are added to `retired`. The readers keep a
+  * consistent tree until the new root is published; the nodes in
+  * `retired` are freed with `free` once no reader can reach them,
+  * so the tree has to use `galloc_default`.
+  *
+  * @param root		pointer to the root of the tree;
+  * @param string	pointer to the string of bytes;
+  * @param size		size of the string of bytes;
+  * @param retired	vector of `art_node_t*` that receives the
+  * 			replaced nodes
+  *
+  * @return	pointer to the value slot of the node of `string`
+  * 		in the new tree
+  */
+void** art_insert_copy (art_node_t** root, void* string, size_t size, vector_t* retired)
+{
+	art_copy_path(root, (unsigned char*) string, size, retired);
+	return art_insert(root, string, size, &galloc_default);
+}
+
+/** Same as `art_remove`, but the tree in `root` is shared with
+  * readers and it is never changed, as in `art_insert_copy`.
+  *
+  * @param root		pointer to the root of the tree;
+  * @param string	pointer to the string of bytes;
+  * @param size		size of the string of bytes;
+  * @param retired	vector of `art_node_t*` that receives the
+  * 			replaced nodes
+  *
+  * @return	the value that was mapped by `string` or NULL in
+  * 		case `string` was not mapped
+  */
+void* art_remove_copy (art_node_t** root, void* string, size_t size, vector_t* retired)
+{
+	if( !art_get(*root, string, size) )
+		return NULL;
+
+	art_copy_path(root, (unsigned char*) string, size, retired);
+	return art_remove_node(root, (unsigned char*) string, size, 0, retired, &galloc_default);
+}
+
+/*
+ * auxiliar function;
+ * calls `visit` on the values of the subtree `node` in the order
+ * of their keys; `key` holds the bytes of the path up to the edge
+ * that leads to `node`
+ *
+ * @return non-zero in case `visit` stopped the walk
+ */
+int art_walk (art_node_t* node, vector_t* key, art_visit_function visit, void* argument)
+{
+	unsigned char* keys;
+	art_node_t** children;
+	size_t depth;
+	int i;
+
+	vector_append_n(key, node->prefix, node->prefix_len);
+	depth = key->size;
+
+	if( node->value && visit(key->data, key->size, node->value, argument) )
+		return 1;
+
+	switch(node->type){
+	case ART_NODE4:
+	case ART_NODE16:
+		art_sorted_arrays(node, &keys, &children);
+		for( i=0; i<node->n_children; i++ ){
+			key->size = depth;
+			vector_append_n(key, &keys[i], 1);
+			if( art_walk(children[i], key, visit, argument) )
+				return 1;
+		}
+		break;
+
+	case ART_NODE48:
+		for( i=0; i<256; i++ ){
+			unsigned char index = ((art_node48_t*)node)->index[i];
+			unsigned char byte = (unsigned char)i;
+			if( !index ) continue;
+
+			key->size = depth;
+			vector_append_n(key, &byte, 1);
+			if( art_walk(((art_node48_t*)node)->children[index-1], key, visit, argument) )
+				return 1;
+		}
+		break;
+
+	case ART_NODE256:
+		for( i=0; i<256; i++ ){
+			unsigned char byte = (unsigned char)i;
+			if( !((art_node256_t*)node)->children[i] ) continue;
+
+			key->size = depth;
+			vector_append_n(key, &byte, 1);
+			if( art_walk(((art_node256_t*)node)->children[i], key, visit, argument) )
+				return 1;
+		}
+		break;
+	}
+
+	return 0;
+}
+
+/** Calls `visit` on every value of the tree `root` whose key
+  * starts with the `size` bytes of `string`, in lexicographic
+  * order of the keys. A key is visited before the longer keys
+  * that start with it. `visit` must not change the tree.
+  *
+  * @param root		root node of the tree or NULL;
+  * @param string	pointer to the prefix of the keys;
+  * @param size		size of the prefix, 0 for every key;
+  * @param visit	function called on every value
+  * @param argument	argument passed to `visit`
+  */
+void art_foreach (art_node_t* root, void* string, size_t size, art_visit_function visit, void* argument)
+{
+	unsigned char* prefix = (unsigned char*) string;
+	art_node_t* node = root;
+	size_t depth = 0;
+	vector_t key;
+
+	/*
+	 * the prefix may end inside the compressed path of
+	 * the node where the walk starts
+	 */
+	while( node ){
+		size_t rest = size - depth;
+		size_t n = node->prefix_len < rest? node->prefix_len : rest;
+
+		if( n && memcmp(node->prefix, prefix + depth, n) )
+			return;
+		if( rest <= node->prefix_len )
+			break;
+
+		depth += node->prefix_len;
+		art_node_t** child = art_find_child(node, prefix[depth]);
+		if( !child )
+			return;
+
+		node = *child;
+		depth++;
+	}
+	if( !node ) return;
+
+	vector_create(&key, 0, sizeof(unsigned char));
+	GSTATS_UNREGISTER(&key);
+	vector_append_n(&key, prefix, depth);
+
+	art_walk(node, &key, visit, argument);
+	vector_destroy(&key);
+}
+
+/** Deallocates recursively the tree `root` and its values.
+  *
+  * @param root		root node of the tree or NULL;
+  * @param value_size	size of the values, given back to `a`;
+  * @param a		allocator of the nodes and the values
+  */
+void art_destroy (art_node_t* root, size_t value_size, const galloc_t* a)
+{
+	unsigned char* keys;
+	art_node_t** children;
+	int i;
+
+	if( !root ) return;
+
+	switch(root->type){
+	case ART_NODE4:
+	case ART_NODE16:
+		art_sorted_arrays(root, &keys, &children);
+		for( i=0; i<root->n_children; i++ )
+			art_destroy(children[i], value_size, a);
+		break;
+
+	case ART_NODE48:
+		for( i=0; i<48; i++ )
+			art_destroy(((art_node48_t*)root)->children[i], value_size, a);
+		break;
+
+	case ART_NODE256:
+		for( i=0; i<256; i++ )
+			art_destroy(((art_node256_t*)root)->children[i], value_size, a);
+		break;
+	}
+
+	if( root->value )
+		GALLOC_FREE(a, root->value, value_size);
+	GALLOC_FREE(a, root, art_node_size((art_type_t)root->type));
+}
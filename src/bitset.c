@@ -0,0 +1,112 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#include <string.h>
+#include "bitset.h"
+
+/** Creates a bitset of `size` bits, all of them unset, and
+  * populates the previous allocated structure pointed by `b`;
+  *
+  * @param b		pointer to a bitset structure;
+  * @param size		number of bits of `b`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `b` is a NULL
+  */
+gerror_t bitset_create (bitset_t* b, size_t size)
+{
+	if(!b) return GERROR_NULL_STRUCTURE;
+
+	b->size = size;
+	b->n_words = (size + BITSET_WORD_BITS - 1)/BITSET_WORD_BITS;
+	b->words = (unsigned long*) calloc(b->n_words? b->n_words : 1, sizeof(unsigned long));
+
+	return GERROR_OK;
+}
+
+/** Unsets every bit of `b`.
+  *
+  * @param b		pointer to a bitset structure;
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `b` is a NULL
+  */
+gerror_t bitset_clear (bitset_t* b)
+{
+	if(!b) return GERROR_NULL_STRUCTURE;
+
+	memset(b->words, 0, b->n_words*sizeof(unsigned long));
+
+	return GERROR_OK;
+}
+
+/** Swaps the bits of `a` and `b` without copying them.
+  *
+  * @param a		pointer to a bitset structure;
+  * @param b		pointer to a bitset structure;
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `a` or `b` is a NULL
+  */
+gerror_t bitset_swap (bitset_t* a, bitset_t* b)
+{
+	if(!a || !b) return GERROR_NULL_STRUCTURE;
+
+	bitset_t t = *a;
+	*a = *b;
+	*b = t;
+
+	return GERROR_OK;
+}
+
+/** Returns the number of bits set in `b`.
+  */
+size_t bitset_count (bitset_t* b)
+{
+	if(!b) return 0;
+
+	size_t i, n = 0;
+	for(i=0; i<b->n_words; i++){
+		unsigned long w = b->words[i];
+		while(w){
+			w &= w - 1;
+			n++;
+		}
+	}
+
+	return n;
+}
+
+/** Deallocates the bits of `b`.
+  * This function WILL NOT deallocate the pointer `b`.
+  *
+  * @param b		pointer to a bitset structure;
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `b` is a NULL
+  */
+gerror_t bitset_destroy (bitset_t* b)
+{
+	if(!b) return GERROR_NULL_STRUCTURE;
+
+	free(b->words);
+	b->words = NULL;
+	b->size = b->n_words = 0;
+
+	return GERROR_OK;
+}
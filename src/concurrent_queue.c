@@ -0,0 +1,428 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#define _POSIX_C_SOURCE 200112L
+#include <string.h>
+#include <sched.h>
+#include "concurrent_queue.h"
+
+#define SPSCQ_AT(q, i)	((q)->buffer + ((i) & ((q)->capacity - 1))*(q)->member_size)
+#define MPMCQ_SLOT(q, i)	((q)->buffer + ((i) & ((q)->capacity - 1))*(q)->slot_size)
+#define MPMCQ_DATA(slot)	((void*)((size_t*)(slot) + 1))
+
+/*
+ * auxiliar function;
+ * the lowest power of two not lower than `n`, at least 2
+ */
+size_t concurrent_queue_capacity (size_t n)
+{
+	size_t capacity = 2;
+	while( capacity < n )
+		capacity <<= 1;
+	return capacity;
+}
+
+/*
+ * auxiliar function;
+ * copies `n` elements between `e` and the ring of `q`
+ * from the position `i`, wrapping at the end of the ring
+ */
+void spscq_copy (spscq_t* q, size_t i, void* e, size_t n, int in)
+{
+	if(!q->member_size || !e || !n) return;
+
+	size_t first = q->capacity - (i & (q->capacity - 1));
+	if(first > n)
+		first = n;
+
+	if(in){
+		memcpy(SPSCQ_AT(q, i), e, first*q->member_size);
+		memcpy(q->buffer, e + first*q->member_size, (n - first)*q->member_size);
+	}else{
+		memcpy(e, SPSCQ_AT(q, i), first*q->member_size);
+		memcpy(e + first*q->member_size, q->buffer, (n - first)*q->member_size);
+	}
+}
+
+/** Creates a single-producer single-consumer queue and populates
+  * the previous allocated structure pointed by `q`;
+  *
+  * @param q		pointer to a queue structure;
+  * @param member_size	size of the elements that will be
+  * 			indexed by `q`
+  * @param capacity	number of elements that fit in `q`,
+  * 			rounded up to a power of two
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `q` is a NULL
+  */
+gerror_t spscq_create (spscq_t* q, size_t member_size, size_t capacity)
+{
+	if(!q) return GERROR_NULL_STRUCTURE;
+
+	q->member_size = member_size;
+	q->capacity = concurrent_queue_capacity(capacity);
+	q->buffer = member_size? malloc(q->capacity*member_size) : NULL;
+	q->head = q->cached_tail = 0;
+	q->tail = q->cached_head = 0;
+
+	return GERROR_OK;
+}
+
+/** Adds up to `n` contiguous elements of `e` at the end of `q`
+  * with a single atomic store. Only the producer thread may call
+  * this function.
+  *
+  * @param q		pointer to a queue structure;
+  * @param e		pointer to `n` elements or NULL;
+  * @param n		number of elements
+  *
+  * @return	the number of elements added, lower than `n`
+  * 		in case `q` became full
+  */
+size_t spscq_try_enqueue_n (spscq_t* q, void* e, size_t n)
+{
+	if(!q) return 0;
+
+	size_t tail = q->tail;
+	size_t room = q->capacity - (tail - q->cached_head);
+
+	if(room < n){
+		q->cached_head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+		room = q->capacity - (tail - q->cached_head);
+	}
+	if(n > room)
+		n = room;
+
+	spscq_copy(q, tail, e, n, 1);
+	__atomic_store_n(&q->tail, tail + n, __ATOMIC_RELEASE);
+
+	return n;
+}
+
+/** Removes up to `n` elements from the front of `q` to the
+  * contiguous memory `e` with a single atomic store. Only the
+  * consumer thread may call this function.
+  *
+  * @param q		pointer to a queue structure;
+  * @param e		pointer to room for `n` elements or NULL;
+  * @param n		number of elements
+  *
+  * @return	the number of elements removed, lower than `n`
+  * 		in case `q` became empty
+  */
+size_t spscq_try_dequeue_n (spscq_t* q, void* e, size_t n)
+{
+	if(!q) return 0;
+
+	size_t head = q->head;
+	size_t available = q->cached_tail - head;
+
+	if(available < n){
+		q->cached_tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+		available = q->cached_tail - head;
+	}
+	if(n > available)
+		n = available;
+
+	spscq_copy(q, head, e, n, 0);
+	__atomic_store_n(&q->head, head + n, __ATOMIC_RELEASE);
+
+	return n;
+}
+
+/** Adds the element `e` at the end of `q`, in case it is not full.
+  * Only the producer thread may call this function.
+  *
+  * @param q		pointer to a queue structure;
+  * @param e		pointer to the element or NULL
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `q` is a NULL
+  * 		GERROR_TRY_ADD_FULL_STRUCTURE in case `q` is full
+  */
+gerror_t spscq_try_enqueue (spscq_t* q, void* e)
+{
+	if(!q) return GERROR_NULL_STRUCTURE;
+	return spscq_try_enqueue_n(q, e, 1)? GERROR_OK : GERROR_TRY_ADD_FULL_STRUCTURE;
+}
+
+/** Removes the element at the front of `q` and writes it in `e`,
+  * in case `q` is not empty. Only the consumer thread may call
+  * this function.
+  *
+  * @param q		pointer to a queue structure;
+  * @param e		pointer to room for the element or NULL
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `q` is a NULL
+  * 		GERROR_TRY_REMOVE_EMPTY_STRUCTURE in case `q`
+  * 		is empty
+  */
+gerror_t spscq_try_dequeue (spscq_t* q, void* e)
+{
+	if(!q) return GERROR_NULL_STRUCTURE;
+	return spscq_try_dequeue_n(q, e, 1)? GERROR_OK : GERROR_TRY_REMOVE_EMPTY_STRUCTURE;
+}
+
+/** Adds the element `e` at the end of `q`, yielding the
+  * processor while `q` is full.
+  */
+gerror_t spscq_enqueue (spscq_t* q, void* e)
+{
+	if(!q) return GERROR_NULL_STRUCTURE;
+
+	while( !spscq_try_enqueue_n(q, e, 1) )
+		sched_yield();
+
+	return GERROR_OK;
+}
+
+/** Removes the element at the front of `q` and writes it in `e`,
+  * yielding the processor while `q` is empty.
+  */
+gerror_t spscq_dequeue (spscq_t* q, void* e)
+{
+	if(!q) return GERROR_NULL_STRUCTURE;
+
+	while( !spscq_try_dequeue_n(q, e, 1) )
+		sched_yield();
+
+	return GERROR_OK;
+}
+
+/** Returns the number of elements in `q`; it may be already out
+  * of date when the other thread is running.
+  */
+size_t spscq_size (spscq_t* q)
+{
+	if(!q) return 0;
+
+	size_t head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+	size_t tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+	return tail - head;
+}
+
+/** Deallocates the buffer of `q`. No thread may be using `q`.
+  * This function WILL NOT deallocate the pointer `q`.
+  */
+gerror_t spscq_destroy (spscq_t* q)
+{
+	if(!q) return GERROR_NULL_STRUCTURE;
+
+	if(q->buffer)
+		free(q->buffer);
+	q->buffer = NULL;
+	q->capacity = q->member_size = 0;
+
+	return GERROR_OK;
+}
+
+/** Creates a multi-producer multi-consumer queue and populates
+  * the previous allocated structure pointed by `q`;
+  *
+  * @param q		pointer to a queue structure;
+  * @param member_size	size of the elements that will be
+  * 			indexed by `q`
+  * @param capacity	number of elements that fit in `q`,
+  * 			rounded up to a power of two
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `q` is a NULL
+  */
+gerror_t mpmcq_create (mpmcq_t* q, size_t member_size, size_t capacity)
+{
+	if(!q) return GERROR_NULL_STRUCTURE;
+
+	q->member_size = member_size;
+	q->capacity = concurrent_queue_capacity(capacity);
+	q->slot_size = sizeof(size_t) +
+		(member_size + sizeof(size_t) - 1)/sizeof(size_t)*sizeof(size_t);
+	q->buffer = malloc(q->capacity*q->slot_size);
+	q->head = q->tail = 0;
+
+	size_t i;
+	for(i=0; i<q->capacity; i++)
+		*(size_t*)MPMCQ_SLOT(q, i) = i;
+
+	return GERROR_OK;
+}
+
+/*
+ * auxiliar function;
+ * claims up to `n` consecutive positions from the counter
+ * `counter`, whose slots are ready when their sequence is the
+ * position plus `ready`; returns the first one in `first`
+ */
+size_t mpmcq_claim (mpmcq_t* q, size_t* counter, size_t ready, size_t n, size_t* first)
+{
+	size_t pos = __atomic_load_n(counter, __ATOMIC_RELAXED);
+
+	for(;;){
+		size_t k = 0;
+		long dif = 0;
+
+		while( k < n ){
+			size_t seq = __atomic_load_n((size_t*)MPMCQ_SLOT(q, pos + k), __ATOMIC_ACQUIRE);
+			dif = (long)(seq - (pos + k + ready));
+			if(dif) break;
+			k++;
+		}
+
+		if(!k){
+			if(dif < 0) return 0;
+			pos = __atomic_load_n(counter, __ATOMIC_RELAXED);
+			continue;
+		}
+
+		if(__atomic_compare_exchange_n(counter, &pos, pos + k, 1,
+					__ATOMIC_RELAXED, __ATOMIC_RELAXED)){
+			*first = pos;
+			return k;
+		}
+	}
+}
+
+/** Adds up to `n` contiguous elements of `e` at the end of `q`,
+  * claiming all their slots with a single compare-and-swap.
+  *
+  * @param q		pointer to a queue structure;
+  * @param e		pointer to `n` elements or NULL;
+  * @param n		number of elements
+  *
+  * @return	the number of elements added, lower than `n`
+  * 		in case `q` became full
+  */
+size_t mpmcq_try_enqueue_n (mpmcq_t* q, void* e, size_t n)
+{
+	if(!q || !n) return 0;
+
+	size_t pos, i;
+	n = mpmcq_claim(q, &q->tail, 0, n, &pos);
+
+	for(i=0; i<n; i++){
+		void* slot = MPMCQ_SLOT(q, pos + i);
+
+		if(q->member_size && e)
+			memcpy(MPMCQ_DATA(slot), e + i*q->member_size, q->member_size);
+		__atomic_store_n((size_t*)slot, pos + i + 1, __ATOMIC_RELEASE);
+	}
+
+	return n;
+}
+
+/** Removes up to `n` elements from the front of `q` to the
+  * contiguous memory `e`, claiming all their slots with a single
+  * compare-and-swap.
+  *
+  * @param q		pointer to a queue structure;
+  * @param e		pointer to room for `n` elements or NULL;
+  * @param n		number of elements
+  *
+  * @return	the number of elements removed, lower than `n`
+  * 		in case `q` became empty
+  */
+size_t mpmcq_try_dequeue_n (mpmcq_t* q, void* e, size_t n)
+{
+	if(!q || !n) return 0;
+
+	size_t pos, i;
+	n = mpmcq_claim(q, &q->head, 1, n, &pos);
+
+	for(i=0; i<n; i++){
+		void* slot = MPMCQ_SLOT(q, pos + i);
+
+		if(q->member_size && e)
+			memcpy(e + i*q->member_size, MPMCQ_DATA(slot), q->member_size);
+		__atomic_store_n((size_t*)slot, pos + i + q->capacity, __ATOMIC_RELEASE);
+	}
+
+	return n;
+}
+
+/** Adds the element `e` at the end of `q`, in case it is not full.
+  *
+  * @param q		pointer to a queue structure;
+  * @param e		pointer to the element or NULL
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `q` is a NULL
+  * 		GERROR_TRY_ADD_FULL_STRUCTURE in case `q` is full
+  */
+gerror_t mpmcq_try_enqueue (mpmcq_t* q, void* e)
+{
+	if(!q) return GERROR_NULL_STRUCTURE;
+	return mpmcq_try_enqueue_n(q, e, 1)? GERROR_OK : GERROR_TRY_ADD_FULL_STRUCTURE;
+}
+
+/** Removes the element at the front of `q` and writes it in `e`,
+  * in case `q` is not empty.
+  *
+  * @param q		pointer to a queue structure;
+  * @param e		pointer to room for the element or NULL
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `q` is a NULL
+  * 		GERROR_TRY_REMOVE_EMPTY_STRUCTURE in case `q`
+  * 		is empty
+  */
+gerror_t mpmcq_try_dequeue (mpmcq_t* q, void* e)
+{
+	if(!q) return GERROR_NULL_STRUCTURE;
+	return mpmcq_try_dequeue_n(q, e, 1)? GERROR_OK : GERROR_TRY_REMOVE_EMPTY_STRUCTURE;
+}
+
+/** Adds the element `e` at the end of `q`, yielding the
+  * processor while `q` is full.
+  */
+gerror_t mpmcq_enqueue (mpmcq_t* q, void* e)
+{
+	if(!q) return GERROR_NULL_STRUCTURE;
+
+	while( !mpmcq_try_enqueue_n(q, e, 1) )
+		sched_yield();
+
+	return GERROR_OK;
+}
+
+/** Removes the element at the front of `q` and writes it in `e`,
+  * yielding the processor while `q` is empty.
+  */
+gerror_t mpmcq_dequeue (mpmcq_t* q, void* e)
+{
+	if(!q) return GERROR_NULL_STRUCTURE;
+
+	while( !mpmcq_try_dequeue_n(q, e, 1) )
+		sched_yield();
+
+	return GERROR_OK;
+}
+
+/** Deallocates the slots of `q`. No thread may be using `q`.
+  * This function WILL NOT deallocate the pointer `q`.
+  */
+gerror_t mpmcq_destroy (mpmcq_t* q)
+{
+	if(!q) return GERROR_NULL_STRUCTURE;
+
+	free(q->buffer);
+	q->buffer = NULL;
+	q->capacity = q->member_size = q->slot_size = 0;
+
+	return GERROR_OK;
+}
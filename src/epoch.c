@@ -0,0 +1,226 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#define _POSIX_C_SOURCE 200112L
+#include <sched.h>
+#include "epoch.h"
+
+/*
+ * auxiliar function;
+ * frees everything retired in the bucket `b`
+ */
+void epoch_release_bucket (epoch_t* e, size_t b)
+{
+	vector_t* v = &e->retired[b];
+	size_t i;
+
+	for(i=0; i<v->size; i++){
+		epoch_retired_t* r = (epoch_retired_t*) vector_ptr_at(v, i);
+		r->release(r->ptr);
+	}
+	vector_clear(v);
+}
+
+/** Creates an epoch domain for up to `max_readers` reader threads
+  * and populates the previous allocated structure pointed by `e`;
+  *
+  * @param e		pointer to an epoch structure;
+  * @param max_readers	maximum number of registered readers
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `e` is a NULL
+  */
+gerror_t epoch_create (epoch_t* e, size_t max_readers)
+{
+	if(!e) return GERROR_NULL_STRUCTURE;
+
+	e->global = 1;
+	e->n_readers = max_readers;
+	e->readers = (epoch_reader_t*) calloc(max_readers? max_readers : 1, sizeof(epoch_reader_t));
+
+	size_t i;
+	for(i=0; i<EPOCH_N_BUCKETS; i++){
+		vector_create(&e->retired[i], 0, sizeof(epoch_retired_t));
+		GSTATS_UNREGISTER(&e->retired[i]);
+	}
+
+	return GERROR_OK;
+}
+
+/** Takes a free reader slot of `e` for the calling thread. Any
+  * thread may call this function.
+  *
+  * @param e		pointer to an epoch structure;
+  *
+  * @return	the slot of the reader or NULL in case `e`
+  * 		has no free slot
+  */
+epoch_reader_t* epoch_register (epoch_t* e)
+{
+	if(!e) return NULL;
+
+	size_t i;
+	for(i=0; i<e->n_readers; i++){
+		int expected = 0;
+		if(__atomic_compare_exchange_n(&e->readers[i].used, &expected, 1, 0,
+					__ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+			return &e->readers[i];
+	}
+
+	return NULL;
+}
+
+/** Gives back the slot `r`, which must be outside a read section.
+  *
+  * @param e		pointer to an epoch structure;
+  * @param r		slot taken by `epoch_register`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `e` or `r` is a NULL
+  */
+gerror_t epoch_unregister (epoch_t* e, epoch_reader_t* r)
+{
+	if(!e || !r) return GERROR_NULL_STRUCTURE;
+
+	__atomic_store_n(&r->epoch, 0, __ATOMIC_RELEASE);
+	__atomic_store_n(&r->used, 0, __ATOMIC_RELEASE);
+
+	return GERROR_OK;
+}
+
+/** Starts a read section of the reader `r`: until `epoch_exit`,
+  * no memory reachable when the section started is freed.
+  */
+void epoch_enter (epoch_t* e, epoch_reader_t* r)
+{
+	size_t global = __atomic_load_n(&e->global, __ATOMIC_ACQUIRE);
+
+	__atomic_store_n(&r->epoch, global, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/** Ends the read section of the reader `r`. The pointers read in
+  * the section must not be used anymore.
+  */
+void epoch_exit (epoch_reader_t* r)
+{
+	__atomic_store_n(&r->epoch, 0, __ATOMIC_RELEASE);
+}
+
+/** Retires `ptr`, already unlinked from every shared structure,
+  * to be released by `release` once no reader can reach it. Only
+  * the writer thread may call this function.
+  *
+  * @param e		pointer to an epoch structure;
+  * @param ptr		pointer to the memory unlinked;
+  * @param release	function that frees `ptr`, usually `free`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `e` is a NULL
+  */
+gerror_t epoch_retire (epoch_t* e, void* ptr, void (*release)(void*))
+{
+	if(!e) return GERROR_NULL_STRUCTURE;
+	if(!ptr) return GERROR_OK;
+
+	epoch_retired_t r;
+	r.ptr = ptr;
+	r.release = release;
+
+	return vector_add(&e->retired[e->global % EPOCH_N_BUCKETS], &r);
+}
+
+/** Moves the epoch of `e` on, in case every reader in a read
+  * section has seen the current epoch, and frees the memory
+  * retired two epochs before. Only the writer thread may call
+  * this function; it never blocks.
+  *
+  * @param e		pointer to an epoch structure;
+  *
+  * @return	non-zero in case the epoch moved on
+  */
+int epoch_try_advance (epoch_t* e)
+{
+	if(!e) return 0;
+
+	size_t global = e->global;
+	size_t i;
+
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	for(i=0; i<e->n_readers; i++){
+		size_t seen = __atomic_load_n(&e->readers[i].epoch, __ATOMIC_ACQUIRE);
+		if(seen && seen != global)
+			return 0;
+	}
+
+	__atomic_store_n(&e->global, global + 1, __ATOMIC_RELEASE);
+	epoch_release_bucket(e, (global + 1) % EPOCH_N_BUCKETS);
+
+	return 1;
+}
+
+/** Waits until everything retired in `e` so far is freed,
+  * yielding the processor while readers are in old read
+  * sections. Only the writer thread may call this function.
+  *
+  * @param e		pointer to an epoch structure;
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `e` is a NULL
+  */
+gerror_t epoch_synchronize (epoch_t* e)
+{
+	if(!e) return GERROR_NULL_STRUCTURE;
+
+	/*
+	 * the bucket of the current epoch is freed by the
+	 * third advance, the one out of `global + 2`
+	 */
+	size_t target = e->global + EPOCH_N_BUCKETS;
+	while( e->global != target )
+		if( !epoch_try_advance(e) )
+			sched_yield();
+
+	return GERROR_OK;
+}
+
+/** Frees everything retired and deallocates the structures of
+  * `e`. No reader may be in a read section.
+  * This function WILL NOT deallocate the pointer `e`.
+  *
+  * @param e		pointer to an epoch structure;
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `e` is a NULL
+  */
+gerror_t epoch_destroy (epoch_t* e)
+{
+	if(!e) return GERROR_NULL_STRUCTURE;
+
+	size_t i;
+	for(i=0; i<EPOCH_N_BUCKETS; i++){
+		epoch_release_bucket(e, i);
+		vector_destroy(&e->retired[i]);
+	}
+
+	free(e->readers);
+	e->readers = NULL;
+	e->n_readers = 0;
+
+	return GERROR_OK;
+}
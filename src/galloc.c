@@ -0,0 +1,256 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#include "galloc.h"
+#include "gstats.h"
+
+#define GARENA_ALIGN(n)	(((n) + GARENA_ALIGNMENT - 1) & ~((size_t)GARENA_ALIGNMENT - 1))
+
+/*
+ * header of the blocks of an arena, the memory of the block
+ * follows it
+ */
+typedef struct garena_block_t{
+	struct garena_block_t* next;
+	size_t size;
+}garena_block_t;
+
+#define GARENA_HEADER_SIZE GARENA_ALIGN(sizeof(garena_block_t))
+
+/*
+ * auxiliar function;
+ * `alloc` of the default allocator
+ */
+void* galloc_default_alloc (void* context, size_t size)
+{
+	(void) context;
+	return malloc(size);
+}
+
+/*
+ * auxiliar function;
+ * `realloc` of the default allocator
+ */
+void* galloc_default_realloc (void* context, void* ptr, size_t old_size, size_t new_size)
+{
+	(void) context;
+	(void) old_size;
+	return realloc(ptr, new_size);
+}
+
+/*
+ * auxiliar function;
+ * `free` of the default allocator
+ */
+void galloc_default_free (void* context, void* ptr, size_t size)
+{
+	(void) context;
+	(void) size;
+	free(ptr);
+}
+
+const galloc_t galloc_default = {
+	galloc_default_alloc,
+	galloc_default_realloc,
+	galloc_default_free,
+	NULL
+};
+
+/** Allocates `size` bytes filled with zeros from `a`.
+  *
+  * @param a		the allocator;
+  * @param size		number of bytes
+  *
+  * @return	pointer to the memory or NULL
+  */
+void* galloc_zeroed (const galloc_t* a, size_t size)
+{
+	void* ptr = GALLOC_ALLOC(a, size);
+
+	if(ptr) memset(ptr, 0, size);
+	return ptr;
+}
+
+/*
+ * auxiliar function;
+ * `alloc` of an arena
+ */
+void* garena_alloc (void* context, size_t size)
+{
+	garena_t* a = (garena_t*) context;
+	size = GARENA_ALIGN(size? size : 1);
+
+	if( size > a->remaining ){
+		size_t block_size = size > a->block_size? size : a->block_size;
+		garena_block_t* block = (garena_block_t*) malloc(GARENA_HEADER_SIZE + block_size);
+		if( !block ) return NULL;
+
+		block->next = (garena_block_t*) a->blocks;
+		block->size = block_size;
+		a->blocks = block;
+		a->next = (char*) block + GARENA_HEADER_SIZE;
+		a->remaining = block_size;
+	}
+
+	a->last = a->next;
+	a->next += size;
+	a->remaining -= size;
+
+	return a->last;
+}
+
+/*
+ * auxiliar function;
+ * `realloc` of an arena: the last block allocated is resized
+ * in place when it fits, the others are copied
+ */
+void* garena_realloc (void* context, void* ptr, size_t old_size, size_t new_size)
+{
+	garena_t* a = (garena_t*) context;
+
+	if( !ptr ) return garena_alloc(a, new_size);
+
+	if( ptr == a->last ){
+		size_t used = a->next - (char*) ptr;
+		size_t size = GARENA_ALIGN(new_size? new_size : 1);
+
+		if( size <= used + a->remaining ){
+			a->remaining = a->remaining + used - size;
+			a->next = (char*) ptr + size;
+			return ptr;
+		}
+	}
+
+	void* copy = garena_alloc(a, new_size);
+	if( copy )
+		memcpy(copy, ptr, old_size < new_size? old_size : new_size);
+	return copy;
+}
+
+/*
+ * auxiliar function;
+ * `free` of an arena, only the last block allocated is given
+ * back
+ */
+void garena_free (void* context, void* ptr, size_t size)
+{
+	garena_t* a = (garena_t*) context;
+
+	(void) size;
+	if( ptr && ptr == a->last ){
+		a->remaining += a->next - (char*) ptr;
+		a->next = (char*) ptr;
+		a->last = NULL;
+	}
+}
+
+/** Creates an arena that allocates the memory from the system
+  * in blocks of `block_size` bytes and populates the previous
+  * allocated structure pointed by `a`. The containers use it
+  * through `&a->allocator`, so `a` must not be moved.
+  *
+  * @param a		pointer to an arena structure;
+  * @param block_size	size of the blocks or 0 for
+  * 			GARENA_BLOCK_SIZE
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `a` is a NULL
+  */
+gerror_t garena_create (garena_t* a, size_t block_size)
+{
+	if(!a) return GERROR_NULL_STRUCTURE;
+
+	a->allocator.alloc = garena_alloc;
+	a->allocator.realloc = garena_realloc;
+	a->allocator.free = garena_free;
+	a->allocator.context = a;
+
+	a->block_size = block_size? GARENA_ALIGN(block_size) : GARENA_BLOCK_SIZE;
+	a->blocks = NULL;
+	a->next = NULL;
+	a->remaining = 0;
+	a->last = NULL;
+
+	return GERROR_OK;
+}
+
+/** Gives back at once all the memory allocated from `a`, and
+  * with it every container on `a`. One block is kept for the
+  * next allocations.
+  *
+  * With GENERICS_STATS the containers whose structure was
+  * allocated from `a` leave the registry here. A container whose
+  * structure lives elsewhere, such as on the stack, must be
+  * taken out with GSTATS_UNREGISTER before the reset, or be
+  * destroyed, see gstats.h.
+  *
+  * @param a		pointer to an arena structure;
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `a` is a NULL
+  */
+gerror_t garena_reset (garena_t* a)
+{
+	if(!a) return GERROR_NULL_STRUCTURE;
+
+	garena_block_t* i, *j, *kept = NULL;
+	for( i=(garena_block_t*) a->blocks; i!=NULL; i=j ){
+		j = i->next;
+#ifdef GENERICS_STATS
+		gstats_unregister_range((char*) i + GARENA_HEADER_SIZE, i->size);
+#endif
+		if( !kept && i->size == a->block_size )
+			kept = i;
+		else
+			free(i);
+	}
+
+	a->blocks = kept;
+	a->last = NULL;
+	if( kept ){
+		kept->next = NULL;
+		a->next = (char*) kept + GARENA_HEADER_SIZE;
+		a->remaining = kept->size;
+	}else{
+		a->next = NULL;
+		a->remaining = 0;
+	}
+
+	return GERROR_OK;
+}
+
+/** Gives back all the memory of `a` to the system.
+  * This function WILL NOT deallocate the pointer `a`.
+  *
+  * @param a		pointer to an arena structure;
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `a` is a NULL
+  */
+gerror_t garena_destroy (garena_t* a)
+{
+	if(!a) return GERROR_NULL_STRUCTURE;
+
+	garena_reset(a);
+	free(a->blocks);
+	a->blocks = NULL;
+	a->next = NULL;
+	a->remaining = 0;
+
+	return GERROR_OK;
+}
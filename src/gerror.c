@@ -26,6 +26,11 @@ char* gerror_to_string[GERROR_N_ERROR] = {
 	"Attempt to remove an element but the structure is empty",
 	"Attempt to add a edge with inexistent vertex",
 	"Attempt to access a position out of the container or buffer",
+	"Operation not supported by the structure in its current mode",
+	"Invalid argument",
+	"Input/output error while reading or writing a file",
+	"The data is not in the expected format or version",
+	"Attempt to add an element but the structure is full",
 };
 
 char* gerror_to_str (gerror_t g)
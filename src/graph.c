@@ -18,6 +18,14 @@
  */
 #include "graph.h"
 
+#define ROWS_SIZE(g)	(sizeof(size_t)*((g)->V + 1))
+#define COLS_SIZE(g)	(sizeof(size_t)*((g)->E? (g)->E : 1))
+#define WEIGHTS_SIZE(g)	(sizeof(double)*((g)->E? (g)->E : 1))
+
+gerror_t graph_init(graph_t* g, size_t size, size_t member_size,
+		struct npool_t* pool, int weighted, int adjacency, const galloc_t* allocator);
+gerror_t graph_stats_of(void* g, gstats_t* stats);
+
 /** Creates a graph and populates the previous
   * allocated structure pointed by `g`;
   *
@@ -29,23 +37,121 @@
   */
 gerror_t graph_create(graph_t* g, size_t size, size_t member_size)
 {
-	if(!g) return GERROR_NULL_STRUCTURE;
+	return graph_create_pooled(g, size, member_size, NULL);
+}
+
+/** Creates a graph whose adjacency nodes are blocks of the
+  * node pool `pool` and populates the previous allocated
+  * structure pointed by `g`;
+  *
+  * @param g		pointer to a graph structure;
+  * @param member_size	size of the elements that will be
+  * 			indexed by `g`
+  * @param pool		pool shared with other containers or NULL,
+  * 			in which case `g` creates and owns a
+  * 			private pool.
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  * 		GERROR_INVALID_ARGUMENT in case the blocks of
+  * 		`pool` are too small for an adjacency entry
+  */
+gerror_t graph_create_pooled(graph_t* g, size_t size, size_t member_size, struct npool_t* pool)
+{
+	return graph_init(g, size, member_size, pool, 0, 1, &galloc_default);
+}
+
+/** Creates a graph whose edges have weights and populates the
+  * previous allocated structure pointed by `g`. The weight of
+  * every edge is kept next to the index of its vertex in the
+  * adjacency and, once `g` is frozen, in the array `weights`
+  * along `col_indices`.
+  *
+  * @param g		pointer to a graph structure;
+  * @param member_size	size of the elements that will be
+  * 			indexed by `g`
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  */
+gerror_t graph_create_weighted(graph_t* g, size_t size, size_t member_size)
+{
+	return graph_init(g, size, member_size, NULL, 1, 1, &galloc_default);
+}
+
+/** Creates a graph as `graph_create` does, but the adjacency,
+  * the labels and the arrays of the frozen graph come from
+  * `allocator`, and populates the previous allocated structure
+  * pointed by `g`;
+  *
+  * @param g		pointer to a graph structure;
+  * @param member_size	size of the elements that will be
+  * 			indexed by `g`
+  * @param allocator	allocator of the graph
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` or `allocator`
+  * 		is a NULL pointer
+  */
+gerror_t graph_create_with_allocator(graph_t* g, size_t size, size_t member_size,
+		const galloc_t* allocator)
+{
+	return graph_init(g, size, member_size, NULL, 0, 1, allocator);
+}
+
+/*
+ * auxiliar function;
+ * populates `g`, with adjacency entries of `graph_edge_t`
+ * in case `weighted` is non-zero; the adjacency queues are only
+ * created in case `adjacency` is non-zero
+ */
+gerror_t graph_init(graph_t* g, size_t size, size_t member_size,
+		struct npool_t* pool, int weighted, int adjacency, const galloc_t* allocator)
+{
+	if(!g || !allocator) return GERROR_NULL_STRUCTURE;
+
+	size_t entry_size = weighted? sizeof(graph_edge_t) : sizeof(size_t);
+	if(pool && pool->member_size < entry_size)
+		return GERROR_INVALID_ARGUMENT;
+
 	g->V = size;
 	g->E = 0;
 	g->member_size = member_size;
+	g->weighted = weighted;
+	g->weights = NULL;
+
+	g->owns_pool = 0;
+	g->pool = NULL;
+	g->adj = NULL;
+	g->allocator = allocator;
+	GSTATS_INIT(g);
 
-	g->adj = (queue_t*) malloc(sizeof(queue_t)*size);
-	size_t i;
-	for(i=0; i<size; i++)
-		queue_create(&g->adj[i], sizeof(int));
+	if(adjacency){
+		if(!pool){
+			pool = (npool_t*) GALLOC_ALLOC(g->allocator, sizeof(npool_t));
+			npool_create_with_allocator(pool, entry_size, 0, g->allocator);
+			g->owns_pool = 1;
+		}
+		g->pool = pool;
+
+		g->adj = (queue_t*) GALLOC_ALLOC(g->allocator, sizeof(queue_t)*size);
+		size_t i;
+		for(i=0; i<size; i++){
+			queue_create_pooled(&g->adj[i], entry_size, g->pool);
+			GSTATS_UNREGISTER(&g->adj[i]);
+		}
+		GSTATS_ADD(g, allocations, 1);
+	}
 
 	if( g->member_size ){
-		g->label = malloc(g->member_size*size);
-		memset(g->label, 0, size*g->member_size);
+		g->label = galloc_zeroed(g->allocator, g->member_size*size);
 	}else{
 		g->label = NULL;
 	}
 
+	g->row_offsets = NULL;
+	g->col_indices = NULL;
+	g->in_offsets = NULL;
+	g->in_indices = NULL;
+
+	GSTATS_REGISTER(g, "graph", graph_stats_of);
 	return GERROR_OK;
 }
 
@@ -60,14 +166,365 @@ gerror_t graph_create(graph_t* g, size_t size, size_t member_size)
   * @return	GERROR_OK in case of success operation;
   * 		GERROR_TRY_ADD_EDGE_NO_VERTEX in case that
   * 		`from` or `to` not exists in the graph
+  * 		GERROR_UNSUPPORTED_OPERATION in case `g`
+  * 		is frozen
   *
   */
 gerror_t graph_add_edge(graph_t* g, size_t from, size_t to)
+{
+	return graph_add_weighted_edge(g, from, to, 1.0);
+}
+
+/** Adds an edge of weight `weight` on the graph `g` from the
+  * vertex `from` to the vertex `to`. The weight is discarded in
+  * case `g` is not weighted.
+  *
+  * @param g		pointer to a graph structure;
+  * @param from		index of the first vertex;
+  * @param to		index of the incident vertex;
+  * @param weight	weight of the edge.
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_TRY_ADD_EDGE_NO_VERTEX in case that
+  * 		`from` or `to` not exists in the graph
+  * 		GERROR_UNSUPPORTED_OPERATION in case `g`
+  * 		is frozen
+  */
+gerror_t graph_add_weighted_edge(graph_t* g, size_t from, size_t to, double weight)
 {
 	if(!g) return GERROR_NULL_STRUCTURE;
-	if(from > g->V || to > g->V) return GERROR_TRY_ADD_EDGE_NO_VERTEX;
-	queue_enqueue(&g->adj[from], &to);
+	if(g->row_offsets) return GERROR_UNSUPPORTED_OPERATION;
+	if(from >= g->V || to >= g->V) return GERROR_TRY_ADD_EDGE_NO_VERTEX;
+
+	if(g->weighted){
+		graph_edge_t edge;
+		edge.to = to;
+		edge.weight = weight;
+		queue_enqueue(&g->adj[from], &edge);
+	}else{
+		queue_enqueue(&g->adj[from], &to);
+	}
 	g->E++;
+	GSTATS_PEAK(g, g->E);
+
+	return GERROR_OK;
+}
+
+/*
+ * auxiliar function;
+ * checks that every edge is between vertices of `g`
+ */
+int graph_valid_edges(graph_t* g, const size_t* from, const size_t* to, size_t n)
+{
+	size_t k;
+	for(k=0; k<n; k++)
+		if(from[k] >= g->V || to[k] >= g->V)
+			return 0;
+	return 1;
+}
+
+/*
+ * auxiliar function;
+ * rebuilds the compressed rows of `g`, which may have none,
+ * with the `n` edges after the edges already in every row:
+ * the degrees are counted, summed up to the offsets and the
+ * edges are scattered straight to their rows
+ */
+void graph_csr_merge(graph_t* g, const size_t* from, const size_t* to,
+		const double* weight, size_t n)
+{
+	size_t E = g->E + n;
+	size_t* offsets = (size_t*) galloc_zeroed(g->allocator, ROWS_SIZE(g));
+	size_t* cursor = (size_t*) GALLOC_ALLOC(g->allocator, sizeof(size_t)*(g->V? g->V : 1));
+	size_t* cols = (size_t*) GALLOC_ALLOC(g->allocator, sizeof(size_t)*(E? E : 1));
+	double* weights = NULL;
+	size_t i, k;
+
+	if(g->weighted)
+		weights = (double*) GALLOC_ALLOC(g->allocator, sizeof(double)*(E? E : 1));
+	GSTATS_ADD(g, allocations, weights? 4 : 3);
+
+	if(g->row_offsets)
+		for(i=0; i<g->V; i++)
+			offsets[i+1] = g->row_offsets[i+1] - g->row_offsets[i];
+	for(k=0; k<n; k++)
+		offsets[from[k] + 1]++;
+	for(i=0; i<g->V; i++)
+		offsets[i+1] += offsets[i];
+
+	for(i=0; i<g->V; i++){
+		cursor[i] = offsets[i];
+		if(!g->row_offsets) continue;
+
+		size_t degree = g->row_offsets[i+1] - g->row_offsets[i];
+		memcpy(cols + cursor[i], g->col_indices + g->row_offsets[i], degree*sizeof(size_t));
+		if(weights)
+			memcpy(weights + cursor[i], g->weights + g->row_offsets[i], degree*sizeof(double));
+		cursor[i] += degree;
+	}
+
+	for(k=0; k<n; k++){
+		size_t at = cursor[from[k]]++;
+		cols[at] = to[k];
+		if(weights)
+			weights[at] = weight? weight[k] : 1.0;
+	}
+
+	if(g->row_offsets){
+		GSTATS_ADD(g, reallocations, 1);
+		GSTATS_ADD(g, bytes_moved, g->E*(weights? sizeof(size_t) + sizeof(double) : sizeof(size_t)));
+		GALLOC_FREE(g->allocator, g->row_offsets, ROWS_SIZE(g));
+		GALLOC_FREE(g->allocator, g->col_indices, COLS_SIZE(g));
+		if(g->weights)
+			GALLOC_FREE(g->allocator, g->weights, WEIGHTS_SIZE(g));
+	}
+	GALLOC_FREE(g->allocator, cursor, sizeof(size_t)*(g->V? g->V : 1));
+
+	g->row_offsets = offsets;
+	g->col_indices = cols;
+	g->weights = weights;
+	g->E = E;
+	GSTATS_PEAK(g, g->E);
+}
+
+/** Adds the `n` edges from `from[k]` to `to[k]` on the graph
+  * `g`, see `graph_add_weighted_edges`.
+  */
+gerror_t graph_add_edges(graph_t* g, const size_t* from, const size_t* to, size_t n)
+{
+	return graph_add_weighted_edges(g, from, to, NULL, n);
+}
+
+/** Adds the `n` edges from `from[k]` to `to[k]`, of weight
+  * `weight[k]`, on the graph `g`. In case `g` is frozen the
+  * compressed rows are rebuilt once for all the edges, which
+  * are scattered straight to their rows, and the transpose is
+  * rebuilt in case it was built. Either all edges are added or
+  * none of them.
+  *
+  * @param g		pointer to a graph structure;
+  * @param from		index of the first vertex of every edge;
+  * @param to		index of the incident vertex of every edge;
+  * @param weight	weight of every edge or NULL, in which
+  * 			case every edge weighs 1;
+  * @param n		number of edges.
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  * 		GERROR_TRY_ADD_EDGE_NO_VERTEX in case that
+  * 		any vertex of the edges not exists in the graph
+  */
+gerror_t graph_add_weighted_edges(graph_t* g, const size_t* from, const size_t* to,
+		const double* weight, size_t n)
+{
+	if(!g) return GERROR_NULL_STRUCTURE;
+	if(!graph_valid_edges(g, from, to, n)) return GERROR_TRY_ADD_EDGE_NO_VERTEX;
+
+	if(!g->row_offsets){
+		size_t k;
+		for(k=0; k<n; k++)
+			graph_add_weighted_edge(g, from[k], to[k], weight? weight[k] : 1.0);
+		return GERROR_OK;
+	}
+
+	int transposed = g->in_offsets != NULL;
+	if(transposed){
+		GALLOC_FREE(g->allocator, g->in_offsets, ROWS_SIZE(g));
+		GALLOC_FREE(g->allocator, g->in_indices, COLS_SIZE(g));
+		g->in_offsets = g->in_indices = NULL;
+	}
+
+	graph_csr_merge(g, from, to, weight, n);
+
+	if(transposed)
+		graph_build_transpose(g);
+
+	return GERROR_OK;
+}
+
+/** Creates a frozen graph on the compressed rows `row_offsets`
+  * and `col_indices` and populates the previous allocated
+  * structure pointed by `g`. The arrays must be allocated with
+  * `malloc` and their ownership goes to `g`.
+  *
+  * @param g		pointer to a graph structure;
+  * @param size		number of vertices;
+  * @param member_size	size of the elements that will be
+  * 			indexed by `g`
+  * @param row_offsets	array of `size + 1` offsets;
+  * @param col_indices	array of `row_offsets[size]` vertices;
+  * @param weights	array of `row_offsets[size]` weights or
+  * 			NULL, in which case `g` is not weighted.
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  */
+gerror_t graph_create_from_csr(graph_t* g, size_t size, size_t member_size,
+		size_t* row_offsets, size_t* col_indices, double* weights)
+{
+	gerror_t s = graph_init(g, size, member_size, NULL, weights != NULL, 0, &galloc_default);
+	if(s != GERROR_OK) return s;
+
+	g->row_offsets = row_offsets;
+	g->col_indices = col_indices;
+	g->weights = weights;
+	g->E = row_offsets[size];
+	GSTATS_PEAK(g, g->E);
+
+	return GERROR_OK;
+}
+
+/** Creates a frozen graph with the `n` edges from `from[k]` to
+  * `to[k]` and populates the previous allocated structure pointed
+  * by `g`. The degrees are counted and summed up to the offsets,
+  * and the edges are scattered straight to the compressed rows,
+  * without building the adjacency queues. The neighbors of every
+  * vertex keep the order of the edge list.
+  *
+  * @param g		pointer to a graph structure;
+  * @param size		number of vertices;
+  * @param member_size	size of the elements that will be
+  * 			indexed by `g`
+  * @param from		index of the first vertex of every edge;
+  * @param to		index of the incident vertex of every edge;
+  * @param weight	weight of every edge or NULL, in which
+  * 			case `g` is not weighted;
+  * @param n		number of edges.
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  * 		GERROR_TRY_ADD_EDGE_NO_VERTEX in case that
+  * 		any vertex of the edges not exists in the graph
+  */
+gerror_t graph_create_from_edge_list(graph_t* g, size_t size, size_t member_size,
+		const size_t* from, const size_t* to, const double* weight, size_t n)
+{
+	gerror_t s = graph_init(g, size, member_size, NULL, weight != NULL, 0, &galloc_default);
+	if(s != GERROR_OK) return s;
+
+	if(!graph_valid_edges(g, from, to, n)){
+		graph_destroy(g);
+		return GERROR_TRY_ADD_EDGE_NO_VERTEX;
+	}
+
+	graph_csr_merge(g, from, to, weight, n);
+
+	return GERROR_OK;
+}
+
+/*
+ * auxiliar function;
+ * orders the edges by vertex and then by weight
+ */
+int graph_edge_compare(const void* a, const void* b)
+{
+	const graph_edge_t* x = (const graph_edge_t*) a;
+	const graph_edge_t* y = (const graph_edge_t*) b;
+
+	if(x->to != y->to) return (x->to > y->to) - (x->to < y->to);
+	return (x->weight > y->weight) - (x->weight < y->weight);
+}
+
+/*
+ * auxiliar function;
+ * orders the vertices
+ */
+int graph_index_compare(const void* a, const void* b)
+{
+	size_t x = *(const size_t*) a;
+	size_t y = *(const size_t*) b;
+
+	return (x > y) - (x < y);
+}
+
+/** Sorts the neighbors of every vertex of the frozen graph `g`
+  * by index, so that neighbor lists can be merged or searched
+  * in order, and optionally removes the repeated edges. Among
+  * repeated edges of a weighted graph the lightest one is kept.
+  * The transpose is rebuilt in case it was built.
+  *
+  * @param g		pointer to a graph structure;
+  * @param dedup	non-zero to remove the repeated edges
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  * 		GERROR_UNSUPPORTED_OPERATION in case `g`
+  * 		is not frozen
+  */
+gerror_t graph_sort_neighbors(graph_t* g, int dedup)
+{
+	if(!g) return GERROR_NULL_STRUCTURE;
+	if(!g->row_offsets) return GERROR_UNSUPPORTED_OPERATION;
+
+	graph_edge_t* edges = NULL;
+	size_t i, k, max_degree = 0;
+
+	for(i=0; i<g->V; i++)
+		if(g->row_offsets[i+1] - g->row_offsets[i] > max_degree)
+			max_degree = g->row_offsets[i+1] - g->row_offsets[i];
+
+	if(g->weights)
+		edges = (graph_edge_t*) GALLOC_ALLOC(g->allocator, sizeof(graph_edge_t)*(max_degree? max_degree : 1));
+
+	size_t written = 0;
+	for(i=0; i<g->V; i++){
+		size_t begin = g->row_offsets[i];
+		size_t degree = g->row_offsets[i+1] - begin;
+
+		if(edges){
+			for(k=0; k<degree; k++){
+				edges[k].to = g->col_indices[begin + k];
+				edges[k].weight = g->weights[begin + k];
+			}
+			qsort(edges, degree, sizeof(graph_edge_t), graph_edge_compare);
+		}else{
+			qsort(g->col_indices + begin, degree, sizeof(size_t), graph_index_compare);
+		}
+
+		/*
+		 * the rows only move to the left when
+		 * repeated edges are removed
+		 */
+		g->row_offsets[i] = written;
+		for(k=0; k<degree; k++){
+			size_t to = edges? edges[k].to : g->col_indices[begin + k];
+
+			if(dedup && k && g->col_indices[written - 1] == to)
+				continue;
+
+			g->col_indices[written] = to;
+			if(edges)
+				g->weights[written] = edges[k].weight;
+			written++;
+		}
+	}
+	g->row_offsets[g->V] = written;
+
+	if(edges)
+		GALLOC_FREE(g->allocator, edges, sizeof(graph_edge_t)*(max_degree? max_degree : 1));
+
+	int transposed = g->in_offsets != NULL;
+	if(transposed){
+		GALLOC_FREE(g->allocator, g->in_offsets, ROWS_SIZE(g));
+		GALLOC_FREE(g->allocator, g->in_indices, COLS_SIZE(g));
+		g->in_offsets = g->in_indices = NULL;
+	}
+
+	/*
+	 * the arrays are cut down to the edges left, so the
+	 * allocator takes back the sizes it gave
+	 */
+	if(written < g->E){
+		size_t old_cols = COLS_SIZE(g), old_weights = WEIGHTS_SIZE(g);
+
+		g->E = written;
+		g->col_indices = (size_t*) GALLOC_REALLOC(g->allocator, g->col_indices, old_cols, COLS_SIZE(g));
+		if(g->weights)
+			g->weights = (double*) GALLOC_REALLOC(g->allocator, g->weights, old_weights, WEIGHTS_SIZE(g));
+	}
+
+	if(transposed)
+		graph_build_transpose(g);
 
 	return GERROR_OK;
 }
@@ -120,9 +577,260 @@ gerror_t graph_set_label_at(graph_t* g, size_t index, void* label)
 	return GERROR_OK;
 }
 
+/*
+ * auxiliar function;
+ * releases the adjacency queues of `g`
+ */
+void graph_release_adjacency(graph_t* g)
+{
+	if(!g->adj) return;
+
+	if(g->owns_pool){
+		npool_destroy(g->pool);
+		GALLOC_FREE(g->allocator, g->pool, sizeof(npool_t));
+	}else{
+		size_t i;
+		for(i=0; i<g->V; i++){
+			queue_destroy(&g->adj[i]);
+		}
+	}
+	g->pool = NULL;
+	g->owns_pool = 0;
+
+	GALLOC_FREE(g->allocator, g->adj, sizeof(queue_t)*g->V);
+	g->adj = NULL;
+}
+
+/** Freezes the graph `g`: moves the adjacency queues to the
+  * contiguous arrays `row_offsets[V+1]` and `col_indices[E]`
+  * and releases the queues. The neighbors keep the order in
+  * which the edges were added. No edge can be added to a
+  * frozen graph.
+  *
+  * @param g		pointer to a graph structure;
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  */
+gerror_t graph_freeze(graph_t* g)
+{
+	if(!g) return GERROR_NULL_STRUCTURE;
+	if(g->row_offsets) return GERROR_OK;
+
+	g->row_offsets = (size_t*) GALLOC_ALLOC(g->allocator, ROWS_SIZE(g));
+	g->col_indices = (size_t*) GALLOC_ALLOC(g->allocator, COLS_SIZE(g));
+	if(g->weighted)
+		g->weights = (double*) GALLOC_ALLOC(g->allocator, WEIGHTS_SIZE(g));
+
+	size_t i, k = 0;
+	for(i=0; i<g->V; i++){
+		qnode_t* j;
+
+		g->row_offsets[i] = k;
+		for(j=g->adj[i].head; j!=NULL; j = j->next){
+			if(g->weighted)
+				g->weights[k] = ((graph_edge_t*)j->data)->weight;
+			g->col_indices[k++] = *(size_t*)j->data;
+		}
+	}
+	g->row_offsets[g->V] = k;
+	GSTATS_ADD(g, allocations, g->weighted? 3 : 2);
+	GSTATS_ADD(g, bytes_moved, k*(g->weighted? sizeof(size_t) + sizeof(double) : sizeof(size_t)));
+
+	graph_release_adjacency(g);
+
+	return GERROR_OK;
+}
+
+/** Returns non-zero in case the graph `g` is frozen.
+  */
+int graph_is_frozen(graph_t* g)
+{
+	return g && g->row_offsets;
+}
+
+/** Gets the neighbors of the vertex `v` of the frozen graph `g`.
+  *
+  * @param g		pointer to a graph structure;
+  * @param v		index of the vertex;
+  * @param begin	pointer that will point to the first
+  * 			neighbor of `v` in `col_indices`
+  * @param count	pointer that will be write with the
+  * 			number of neighbors of `v`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  * 		GERROR_ACCESS_OUT_OF_BOUND in case that `v`
+  * 		is out of bound
+  * 		GERROR_UNSUPPORTED_OPERATION in case `g`
+  * 		is not frozen
+  */
+gerror_t graph_neighbors(graph_t* g, size_t v, const size_t** begin, size_t* count)
+{
+	if(!g) return GERROR_NULL_STRUCTURE;
+	if(!g->row_offsets) return GERROR_UNSUPPORTED_OPERATION;
+	if(v >= g->V) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	if(begin)
+		*begin = g->col_indices + g->row_offsets[v];
+	if(count)
+		*count = g->row_offsets[v+1] - g->row_offsets[v];
+
+	return GERROR_OK;
+}
+
+/** Gets the weights of the edges that leave the vertex `v` of
+  * the frozen and weighted graph `g`, in the same order of
+  * `graph_neighbors`.
+  *
+  * @param g		pointer to a graph structure;
+  * @param v		index of the vertex;
+  * @param begin	pointer that will point to the weight of
+  * 			the first neighbor of `v` in `weights`
+  * @param count	pointer that will be write with the
+  * 			number of neighbors of `v`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  * 		GERROR_ACCESS_OUT_OF_BOUND in case that `v`
+  * 		is out of bound
+  * 		GERROR_UNSUPPORTED_OPERATION in case `g`
+  * 		is not frozen or not weighted
+  */
+gerror_t graph_neighbor_weights(graph_t* g, size_t v, const double** begin, size_t* count)
+{
+	if(!g) return GERROR_NULL_STRUCTURE;
+	if(!g->weights) return GERROR_UNSUPPORTED_OPERATION;
+	if(v >= g->V) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	if(begin)
+		*begin = g->weights + g->row_offsets[v];
+	if(count)
+		*count = g->row_offsets[v+1] - g->row_offsets[v];
+
+	return GERROR_OK;
+}
+
+/** Calls `visit` on every edge out of the vertex `v` of the graph
+  * `g`, in the order of the neighbors, frozen or not. `visit`
+  * must not add edges to `g`.
+  *
+  * @param g		pointer to a graph structure;
+  * @param v		index of the vertex;
+  * @param visit	function called on every edge
+  * @param argument	argument passed to `visit`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` or `visit` is
+  * 		a NULL pointer
+  * 		GERROR_ACCESS_OUT_OF_BOUND in case that `v`
+  * 		is out of bound
+  */
+gerror_t graph_foreach_neighbor(graph_t* g, size_t v, graph_neighbor_function visit, void* argument)
+{
+	if(!g || !visit) return GERROR_NULL_STRUCTURE;
+	if(v >= g->V) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	if(g->row_offsets){
+		size_t k;
+		for(k=g->row_offsets[v]; k<g->row_offsets[v+1]; k++)
+			if(visit(g, v, g->col_indices[k], g->weights? g->weights[k] : 1.0, argument))
+				break;
+		return GERROR_OK;
+	}
+
+	qnode_t* i;
+	for(i=g->adj[v].head; i!=NULL; i=i->next){
+		double weight = g->weighted? ((graph_edge_t*)i->data)->weight : 1.0;
+		if(visit(g, v, *(size_t*)i->data, weight, argument))
+			break;
+	}
+
+	return GERROR_OK;
+}
+
+/** Builds the transpose of the frozen graph `g`, that is, the
+  * edges that arrive at every vertex, in `in_offsets[V+1]` and
+  * `in_indices[E]`. The arriving neighbors of every vertex are
+  * sorted by index.
+  *
+  * @param g		pointer to a graph structure;
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  * 		GERROR_UNSUPPORTED_OPERATION in case `g`
+  * 		is not frozen
+  */
+gerror_t graph_build_transpose(graph_t* g)
+{
+	if(!g) return GERROR_NULL_STRUCTURE;
+	if(!g->row_offsets) return GERROR_UNSUPPORTED_OPERATION;
+	if(g->in_offsets) return GERROR_OK;
+
+	size_t* offsets = (size_t*) galloc_zeroed(g->allocator, ROWS_SIZE(g));
+	size_t* indices = (size_t*) GALLOC_ALLOC(g->allocator, COLS_SIZE(g));
+	size_t i, k;
+
+	for(k=0; k<g->E; k++)
+		offsets[g->col_indices[k] + 1]++;
+	for(i=0; i<g->V; i++)
+		offsets[i+1] += offsets[i];
+
+	/*
+	 * scatter, using offsets[v] as the cursor of `v`
+	 * and shifting the offsets back afterwards
+	 */
+	for(i=0; i<g->V; i++)
+		for(k=g->row_offsets[i]; k<g->row_offsets[i+1]; k++)
+			indices[offsets[g->col_indices[k]]++] = i;
+	for(i=g->V; i>0; i--)
+		offsets[i] = offsets[i-1];
+	offsets[0] = 0;
+
+	g->in_offsets = offsets;
+	g->in_indices = indices;
+	GSTATS_ADD(g, allocations, 2);
+
+	return GERROR_OK;
+}
+
+/** Gets the vertices with an edge to the vertex `v` of the graph
+  * `g`, whose transpose was built by `graph_build_transpose`.
+  *
+  * @param g		pointer to a graph structure;
+  * @param v		index of the vertex;
+  * @param begin	pointer that will point to the first
+  * 			neighbor of `v` in `in_indices`
+  * @param count	pointer that will be write with the
+  * 			number of neighbors of `v`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  * 		GERROR_ACCESS_OUT_OF_BOUND in case that `v`
+  * 		is out of bound
+  * 		GERROR_UNSUPPORTED_OPERATION in case the
+  * 		transpose of `g` was not built
+  */
+gerror_t graph_in_neighbors(graph_t* g, size_t v, const size_t** begin, size_t* count)
+{
+	if(!g) return GERROR_NULL_STRUCTURE;
+	if(!g->in_offsets) return GERROR_UNSUPPORTED_OPERATION;
+	if(v >= g->V) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	if(begin)
+		*begin = g->in_indices + g->in_offsets[v];
+	if(count)
+		*count = g->in_offsets[v+1] - g->in_offsets[v];
+
+	return GERROR_OK;
+}
+
 /** Deallocates the structures in `g`.
   * This function WILL NOT deallocate the pointer `g`.
   *
+  * When `g` owns its node pool the adjacency is released
+  * slab by slab, without visiting the adjacency queues.
+  *
   * @param g		pointer to a graph structure;
   *
   * @return	GERROR_OK in case of success operation;
@@ -132,17 +840,66 @@ gerror_t graph_set_label_at(graph_t* g, size_t index, void* label)
 gerror_t graph_destroy(graph_t* g)
 {
 	if(!g) return GERROR_NULL_STRUCTURE;
-	g->member_size = 0;
+	GSTATS_UNREGISTER(g);
 
-	size_t i;
-	for(i=0; i<g->V; i++){
-		queue_destroy(&g->adj[i]);
+	if(g->row_offsets){
+		GALLOC_FREE(g->allocator, g->row_offsets, ROWS_SIZE(g));
+		GALLOC_FREE(g->allocator, g->col_indices, COLS_SIZE(g));
+		g->row_offsets = g->col_indices = NULL;
+
+		if(g->weights){
+			GALLOC_FREE(g->allocator, g->weights, WEIGHTS_SIZE(g));
+			g->weights = NULL;
+		}
+
+		if(g->in_offsets){
+			GALLOC_FREE(g->allocator, g->in_offsets, ROWS_SIZE(g));
+			GALLOC_FREE(g->allocator, g->in_indices, COLS_SIZE(g));
+			g->in_offsets = g->in_indices = NULL;
+		}
+	}else{
+		graph_release_adjacency(g);
 	}
-	
-	free(g->adj);
+
 	if(g->label)
-		free(g->label);
+		GALLOC_FREE(g->allocator, g->label, g->member_size*g->V);
+	g->member_size = 0;
 	g->V = g->E = 0;
 
 	return GERROR_OK;
 }
+
+/** Writes the counters of `g` in `stats`, see gstats.h. The
+  * size is the number of edges and the nodes are the vertices.
+  *
+  * @param g		pointer to a graph structure;
+  * @param stats	pointer to the structure that receives
+  * 			the counters
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` or `stats` is a NULL
+  * 		GERROR_UNSUPPORTED_OPERATION in case the library
+  * 		was built without GENERICS_STATS
+  */
+gerror_t graph_get_stats(graph_t* g, gstats_t* stats)
+{
+	if(!g || !stats) return GERROR_NULL_STRUCTURE;
+
+#ifdef GENERICS_STATS
+	*stats = g->stats.counters;
+	stats->size = g->E;
+	stats->nodes = g->V;
+	return GERROR_OK;
+#else
+	return GERROR_UNSUPPORTED_OPERATION;
+#endif
+}
+
+/*
+ * auxiliar function;
+ * `graph_get_stats` for the registry
+ */
+gerror_t graph_stats_of(void* g, gstats_t* stats)
+{
+	return graph_get_stats((graph_t*) g, stats);
+}
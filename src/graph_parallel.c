@@ -0,0 +1,650 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#include <string.h>
+#include "graph_parallel.h"
+#include "bitset.h"
+
+/*
+ * vertices a worker collects before moving them to the
+ * next frontier
+ */
+#define GRAPH_PARALLEL_BATCH 256
+
+/*
+ * state shared by the workers that load an edge list
+ */
+typedef struct graph_edge_list_t{
+	size_t V;
+	const size_t* from;
+	const size_t* to;
+	const double* weight;
+	size_t* offsets;
+	size_t* cursor;
+	size_t* cols;
+	double* weights;
+	int invalid;
+}graph_edge_list_t;
+
+/*
+ * auxiliar function;
+ * counts the degrees of the edges from `begin` to `end`
+ */
+void graph_edge_list_count (size_t begin, size_t end, size_t worker, void* argument)
+{
+	graph_edge_list_t* l = (graph_edge_list_t*) argument;
+	size_t k;
+	(void)worker;
+
+	for(k=begin; k<end; k++){
+		if(l->from[k] >= l->V || l->to[k] >= l->V){
+			__atomic_store_n(&l->invalid, 1, __ATOMIC_RELAXED);
+			return;
+		}
+		__atomic_fetch_add(&l->offsets[l->from[k] + 1], 1, __ATOMIC_RELAXED);
+	}
+}
+
+/*
+ * auxiliar function;
+ * scatters the edges from `begin` to `end` to their rows
+ */
+void graph_edge_list_scatter (size_t begin, size_t end, size_t worker, void* argument)
+{
+	graph_edge_list_t* l = (graph_edge_list_t*) argument;
+	size_t k;
+	(void)worker;
+
+	for(k=begin; k<end; k++){
+		size_t at = __atomic_fetch_add(&l->cursor[l->from[k]], 1, __ATOMIC_RELAXED);
+
+		l->cols[at] = l->to[k];
+		if(l->weights)
+			l->weights[at] = l->weight[k];
+	}
+}
+
+/** Creates a frozen graph with the `n` edges from `from[k]` to
+  * `to[k]`, like `graph_create_from_edge_list`, with the counting
+  * of the degrees and the scattering of the edges split among
+  * the threads of `p`. The neighbors of a vertex are in no
+  * particular order; `graph_sort_neighbors` sorts them.
+  *
+  * @param g		pointer to a graph structure;
+  * @param p		pointer to a thread pool structure;
+  * @param size		number of vertices;
+  * @param member_size	size of the elements that will be
+  * 			indexed by `g`
+  * @param from		index of the first vertex of every edge;
+  * @param to		index of the incident vertex of every edge;
+  * @param weight	weight of every edge or NULL, in which
+  * 			case `g` is not weighted;
+  * @param n		number of edges.
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` or `p` is a NULL
+  * 		GERROR_TRY_ADD_EDGE_NO_VERTEX in case that
+  * 		any vertex of the edges not exists in the graph
+  */
+gerror_t graph_parallel_create_from_edge_list(graph_t* g, tpool_t* p, size_t size, size_t member_size,
+		const size_t* from, const size_t* to, const double* weight, size_t n)
+{
+	if(!g || !p) return GERROR_NULL_STRUCTURE;
+
+	graph_edge_list_t l;
+	size_t i;
+
+	l.V = size;
+	l.from = from;
+	l.to = to;
+	l.weight = weight;
+	l.invalid = 0;
+	l.offsets = (size_t*) calloc(size + 1, sizeof(size_t));
+
+	tpool_parallel_for(p, 0, n, GRAPH_PARALLEL_GRAIN, graph_edge_list_count, &l);
+	if(l.invalid){
+		free(l.offsets);
+		return GERROR_TRY_ADD_EDGE_NO_VERTEX;
+	}
+
+	for(i=0; i<size; i++)
+		l.offsets[i+1] += l.offsets[i];
+
+	l.cursor = (size_t*) malloc(sizeof(size_t)*(size? size : 1));
+	memcpy(l.cursor, l.offsets, sizeof(size_t)*size);
+	l.cols = (size_t*) malloc(sizeof(size_t)*(n? n : 1));
+	l.weights = weight? (double*) malloc(sizeof(double)*(n? n : 1)) : NULL;
+
+	tpool_parallel_for(p, 0, n, GRAPH_PARALLEL_GRAIN, graph_edge_list_scatter, &l);
+	free(l.cursor);
+
+	return graph_create_from_csr(g, size, member_size, l.offsets, l.cols, l.weights);
+}
+
+/*
+ * state shared by the workers of a level of the parallel BFS
+ */
+typedef struct graph_bfs_level_t{
+	graph_t* g;
+	bitset_t* visited;
+	bitset_t* in_frontier;
+	size_t* frontier;
+	size_t* next;
+	size_t n_next;
+	size_t edges_next;
+	size_t* batch;
+	size_t depth;
+	size_t* distance;
+	size_t* parent;
+}graph_bfs_level_t;
+
+/*
+ * auxiliar function;
+ * claims the vertex `v` for the calling worker, setting its bit
+ * with an atomic operation; returns zero in case another worker
+ * claimed it first
+ */
+int graph_claim (bitset_t* visited, size_t v)
+{
+	unsigned long mask = BITSET_MASK(v);
+	unsigned long old = __atomic_fetch_or(&visited->words[BITSET_WORD(v)], mask, __ATOMIC_RELAXED);
+	return !(old & mask);
+}
+
+/*
+ * auxiliar function;
+ * reads the bit of `v` while other workers may be setting
+ * bits of the same word
+ */
+int graph_is_claimed (bitset_t* visited, size_t v)
+{
+	return (__atomic_load_n(&visited->words[BITSET_WORD(v)], __ATOMIC_RELAXED) & BITSET_MASK(v)) != 0;
+}
+
+/*
+ * auxiliar function;
+ * moves the `n` vertices of `batch` to the next frontier
+ */
+void graph_flush_batch (graph_bfs_level_t* l, size_t* batch, size_t n)
+{
+	size_t i, edges = 0;
+	size_t at = __atomic_fetch_add(&l->n_next, n, __ATOMIC_RELAXED);
+
+	for(i=0; i<n; i++){
+		l->next[at + i] = batch[i];
+		edges += l->g->row_offsets[batch[i]+1] - l->g->row_offsets[batch[i]];
+	}
+	__atomic_fetch_add(&l->edges_next, edges, __ATOMIC_RELAXED);
+}
+
+/*
+ * auxiliar function;
+ * top-down step on the frontier vertices from `begin` to `end`
+ */
+void graph_bfs_top_down (size_t begin, size_t end, size_t worker, void* argument)
+{
+	graph_bfs_level_t* l = (graph_bfs_level_t*) argument;
+	graph_t* g = l->g;
+	size_t* batch = l->batch + worker*GRAPH_PARALLEL_BATCH;
+	size_t i, k, n = 0;
+
+	for(i=begin; i<end; i++){
+		size_t u = l->frontier[i];
+
+		for(k=g->row_offsets[u]; k<g->row_offsets[u+1]; k++){
+			size_t w = g->col_indices[k];
+
+			if(graph_is_claimed(l->visited, w) || !graph_claim(l->visited, w))
+				continue;
+
+			if(l->distance) l->distance[w] = l->depth;
+			if(l->parent) l->parent[w] = u;
+
+			batch[n++] = w;
+			if(n == GRAPH_PARALLEL_BATCH){
+				graph_flush_batch(l, batch, n);
+				n = 0;
+			}
+		}
+	}
+
+	if(n)
+		graph_flush_batch(l, batch, n);
+}
+
+/*
+ * auxiliar function;
+ * bottom-up step on the vertices from `begin` to `end`; every
+ * vertex is only written by the worker of its range
+ */
+void graph_bfs_bottom_up (size_t begin, size_t end, size_t worker, void* argument)
+{
+	graph_bfs_level_t* l = (graph_bfs_level_t*) argument;
+	graph_t* g = l->g;
+	size_t* batch = l->batch + worker*GRAPH_PARALLEL_BATCH;
+	size_t i, k, n = 0;
+
+	for(i=begin; i<end; i++){
+		if(graph_is_claimed(l->visited, i)) continue;
+
+		for(k=g->in_offsets[i]; k<g->in_offsets[i+1]; k++){
+			size_t u = g->in_indices[k];
+			if(!BITSET_TEST(l->in_frontier, u)) continue;
+
+			graph_claim(l->visited, i);
+			if(l->distance) l->distance[i] = l->depth;
+			if(l->parent) l->parent[i] = u;
+
+			batch[n++] = i;
+			if(n == GRAPH_PARALLEL_BATCH){
+				graph_flush_batch(l, batch, n);
+				n = 0;
+			}
+			break;
+		}
+	}
+
+	if(n)
+		graph_flush_batch(l, batch, n);
+}
+
+/** Level-synchronous breadth-first search on the frozen graph
+  * `g` from the vertex `source`, run by the threads of `p`.
+  * Every level of the search is split among the threads, which
+  * claim the vertices they reach by setting their visited bits
+  * atomically. In case the transpose of `g` was built, the
+  * large levels run bottom-up, like in `graph_bfs`.
+  *
+  * The distances found are the same of `graph_bfs`; the parent
+  * of a vertex may be any vertex of the previous level with an
+  * edge to it.
+  *
+  * @param g		pointer to a graph structure;
+  * @param p		pointer to a thread pool structure;
+  * @param source	index of the first vertex;
+  * @param distance	NULL or an array of V elements that will
+  * 			be write with the depth of every vertex
+  * @param parent	NULL or an array of V elements that will
+  * 			be write with the vertex from which every
+  * 			vertex was reached
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` or `p` is a NULL
+  * 		GERROR_ACCESS_OUT_OF_BOUND in case that `source`
+  * 		is out of bound
+  * 		GERROR_UNSUPPORTED_OPERATION in case `g`
+  * 		is not frozen
+  */
+gerror_t graph_parallel_bfs(graph_t* g, tpool_t* p, size_t source, size_t* distance, size_t* parent)
+{
+	if(!g || !p) return GERROR_NULL_STRUCTURE;
+	if(!g->row_offsets) return GERROR_UNSUPPORTED_OPERATION;
+	if(source >= g->V) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	size_t i;
+	for(i=0; i<g->V; i++){
+		if(distance) distance[i] = GRAPH_UNREACHED;
+		if(parent) parent[i] = GRAPH_UNREACHED;
+	}
+
+	bitset_t visited, in_frontier;
+	bitset_create(&visited, g->V);
+
+	int can_bottom_up = g->in_offsets != NULL;
+	if(can_bottom_up)
+		bitset_create(&in_frontier, g->V);
+
+	graph_bfs_level_t l;
+	l.g = g;
+	l.visited = &visited;
+	l.in_frontier = &in_frontier;
+	l.frontier = (size_t*) malloc(sizeof(size_t)*g->V);
+	l.next = (size_t*) malloc(sizeof(size_t)*g->V);
+	l.batch = (size_t*) malloc(sizeof(size_t)*GRAPH_PARALLEL_BATCH*p->n_threads);
+	l.distance = distance;
+	l.parent = parent;
+	l.depth = 0;
+
+	size_t n_frontier = 1;
+	size_t edges_frontier = g->row_offsets[source+1] - g->row_offsets[source];
+	size_t edges_unvisited = g->E - edges_frontier;
+	int bottom_up = 0;
+
+	l.frontier[0] = source;
+	BITSET_SET(&visited, source);
+	if(distance) distance[source] = 0;
+	if(parent) parent[source] = source;
+
+	while( n_frontier ){
+		if(can_bottom_up){
+			if(!bottom_up && edges_frontier > edges_unvisited/GRAPH_BFS_ALPHA)
+				bottom_up = 1;
+			else if(bottom_up && n_frontier < g->V/GRAPH_BFS_BETA)
+				bottom_up = 0;
+		}
+
+		l.depth++;
+		l.n_next = 0;
+		l.edges_next = 0;
+
+		if(!bottom_up){
+			tpool_parallel_for(p, 0, n_frontier, GRAPH_PARALLEL_GRAIN, graph_bfs_top_down, &l);
+		}else{
+			bitset_clear(&in_frontier);
+			for(i=0; i<n_frontier; i++)
+				BITSET_SET(&in_frontier, l.frontier[i]);
+
+			tpool_parallel_for(p, 0, g->V, GRAPH_PARALLEL_GRAIN, graph_bfs_bottom_up, &l);
+		}
+
+		edges_frontier = l.edges_next;
+		edges_unvisited -= edges_frontier;
+
+		size_t* t = l.frontier;
+		l.frontier = l.next;
+		l.next = t;
+		n_frontier = l.n_next;
+	}
+
+	free(l.frontier);
+	free(l.next);
+	free(l.batch);
+	bitset_destroy(&visited);
+	if(can_bottom_up)
+		bitset_destroy(&in_frontier);
+
+	return GERROR_OK;
+}
+
+/*
+ * state shared by the workers of the connected components
+ */
+typedef struct graph_components_t{
+	graph_t* g;
+	size_t* root;
+}graph_components_t;
+
+/*
+ * auxiliar function;
+ * root of the set of `v` in the concurrent forest `root`;
+ * the halving only moves links to ancestors, so racing
+ * writers never break the forest
+ */
+size_t graph_concurrent_find (size_t* root, size_t v)
+{
+	size_t r = __atomic_load_n(&root[v], __ATOMIC_RELAXED);
+
+	while(r != v){
+		size_t rr = __atomic_load_n(&root[r], __ATOMIC_RELAXED);
+		__atomic_compare_exchange_n(&root[v], &r, rr, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+		v = r;
+		r = __atomic_load_n(&root[v], __ATOMIC_RELAXED);
+	}
+
+	return v;
+}
+
+/*
+ * auxiliar function;
+ * joins the sets of `u` and `v`, linking the root with the
+ * larger index under the other one with a compare-and-swap
+ */
+void graph_concurrent_union (size_t* root, size_t u, size_t v)
+{
+	for(;;){
+		u = graph_concurrent_find(root, u);
+		v = graph_concurrent_find(root, v);
+		if(u == v) return;
+
+		if(u < v){
+			size_t t = u;
+			u = v;
+			v = t;
+		}
+
+		size_t expected = u;
+		if(__atomic_compare_exchange_n(&root[u], &expected, v, 0,
+					__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			return;
+	}
+}
+
+/*
+ * auxiliar function;
+ * joins every edge leaving the vertices from `begin` to `end`
+ */
+void graph_components_union (size_t begin, size_t end, size_t worker, void* argument)
+{
+	graph_components_t* c = (graph_components_t*) argument;
+	graph_t* g = c->g;
+	size_t i, k;
+	(void)worker;
+
+	for(i=begin; i<end; i++){
+		if(g->row_offsets){
+			for(k=g->row_offsets[i]; k<g->row_offsets[i+1]; k++)
+				graph_concurrent_union(c->root, i, g->col_indices[k]);
+		}else{
+			qnode_t* j;
+			for(j=g->adj[i].head; j!=NULL; j = j->next)
+				graph_concurrent_union(c->root, i, *(size_t*)j->data);
+		}
+	}
+}
+
+/*
+ * auxiliar function;
+ * points every vertex from `begin` to `end` straight to its root
+ */
+void graph_components_compress (size_t begin, size_t end, size_t worker, void* argument)
+{
+	graph_components_t* c = (graph_components_t*) argument;
+	size_t i;
+	(void)worker;
+
+	for(i=begin; i<end; i++)
+		__atomic_store_n(&c->root[i], graph_concurrent_find(c->root, i), __ATOMIC_RELAXED);
+}
+
+/** Finds the weakly connected components of the graph `g`, like
+  * `graph_connected_components`, with the edges split among the
+  * threads of `p`. The sets are joined in a concurrent
+  * union-find forest by compare-and-swap. The components are
+  * numbered in the same way of `graph_connected_components`.
+  *
+  * @param g		pointer to a graph structure;
+  * @param p		pointer to a thread pool structure;
+  * @param component	an array of V elements that will be
+  * 			write with the component of every vertex
+  * @param n_components	NULL or pointer that will be write with
+  * 			the number of components
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` or `p` is a NULL
+  */
+gerror_t graph_parallel_connected_components(graph_t* g, tpool_t* p, size_t* component, size_t* n_components)
+{
+	if(!g || !p) return GERROR_NULL_STRUCTURE;
+
+	graph_components_t c;
+	size_t i, n = 0;
+
+	c.g = g;
+	c.root = (size_t*) malloc(sizeof(size_t)*(g->V? g->V : 1));
+	for(i=0; i<g->V; i++)
+		c.root[i] = i;
+
+	tpool_parallel_for(p, 0, g->V, GRAPH_PARALLEL_GRAIN, graph_components_union, &c);
+	tpool_parallel_for(p, 0, g->V, GRAPH_PARALLEL_GRAIN, graph_components_compress, &c);
+
+	for(i=0; i<g->V; i++)
+		component[i] = GRAPH_UNREACHED;
+	for(i=0; i<g->V; i++){
+		size_t r = c.root[i];
+		if(component[r] == GRAPH_UNREACHED)
+			component[r] = n++;
+		component[i] = component[r];
+	}
+
+	free(c.root);
+	if(n_components) *n_components = n;
+
+	return GERROR_OK;
+}
+
+/*
+ * state shared by the workers of an iteration of PageRank
+ */
+typedef struct graph_pagerank_t{
+	graph_t* g;
+	double damping;
+	double* rank;
+	double* next;
+	double* contribution;
+	double* partial;
+	double base;
+}graph_pagerank_t;
+
+/*
+ * auxiliar function;
+ * share of the rank of every vertex given to each of its
+ * neighbors; the ranks of the vertices with no edges are
+ * added to the partial sum of the worker
+ */
+void graph_pagerank_scatter (size_t begin, size_t end, size_t worker, void* argument)
+{
+	graph_pagerank_t* pr = (graph_pagerank_t*) argument;
+	graph_t* g = pr->g;
+	double dangling = 0.0;
+	size_t i;
+
+	for(i=begin; i<end; i++){
+		size_t degree = g->row_offsets[i+1] - g->row_offsets[i];
+
+		if(degree){
+			pr->contribution[i] = pr->rank[i]/(double)degree;
+		}else{
+			pr->contribution[i] = 0.0;
+			dangling += pr->rank[i];
+		}
+	}
+
+	pr->partial[worker] += dangling;
+}
+
+/*
+ * auxiliar function;
+ * new rank of every vertex, pulled from the vertices with edges
+ * to it; the change of the ranks is added to the partial sum
+ * of the worker
+ */
+void graph_pagerank_gather (size_t begin, size_t end, size_t worker, void* argument)
+{
+	graph_pagerank_t* pr = (graph_pagerank_t*) argument;
+	graph_t* g = pr->g;
+	double change = 0.0;
+	size_t i, k;
+
+	for(i=begin; i<end; i++){
+		double sum = 0.0;
+
+		for(k=g->in_offsets[i]; k<g->in_offsets[i+1]; k++)
+			sum += pr->contribution[g->in_indices[k]];
+
+		pr->next[i] = pr->base + pr->damping*sum;
+		change += pr->next[i] > pr->rank[i]?
+			pr->next[i] - pr->rank[i] : pr->rank[i] - pr->next[i];
+	}
+
+	pr->partial[worker] += change;
+}
+
+/** Computes the PageRank of the vertices of the frozen graph `g`
+  * with the vertex sweeps split among the threads of `p`. Every
+  * iteration pulls the ranks through the transpose of `g`, so no
+  * two workers write the same vertex. The rank of the vertices
+  * with no edges is spread over all the vertices.
+  *
+  * @param g			pointer to a graph structure;
+  * @param p			pointer to a thread pool structure;
+  * @param damping		probability of following an edge,
+  * 				usually 0.85;
+  * @param max_iterations	maximum number of iterations;
+  * @param tolerance		the iterations stop when the sum of
+  * 				the changes of the ranks is lower;
+  * @param rank			an array of V elements that will be
+  * 				write with the rank of every vertex
+  * @param iterations		NULL or pointer that will be write
+  * 				with the number of iterations run
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` or `p` is a NULL
+  * 		GERROR_UNSUPPORTED_OPERATION in case the
+  * 		transpose of `g` was not built
+  */
+gerror_t graph_parallel_pagerank(graph_t* g, tpool_t* p, double damping,
+		size_t max_iterations, double tolerance, double* rank, size_t* iterations)
+{
+	if(!g || !p) return GERROR_NULL_STRUCTURE;
+	if(!g->in_offsets) return GERROR_UNSUPPORTED_OPERATION;
+	if(iterations) *iterations = 0;
+	if(!g->V) return GERROR_OK;
+
+	graph_pagerank_t pr;
+	size_t i, w, it;
+
+	pr.g = g;
+	pr.damping = damping;
+	pr.rank = rank;
+	pr.next = (double*) malloc(sizeof(double)*g->V);
+	pr.contribution = (double*) malloc(sizeof(double)*g->V);
+	pr.partial = (double*) malloc(sizeof(double)*p->n_threads);
+
+	for(i=0; i<g->V; i++)
+		rank[i] = 1.0/(double)g->V;
+
+	for(it=0; it<max_iterations; it++){
+		double dangling = 0.0, change = 0.0;
+
+		memset(pr.partial, 0, sizeof(double)*p->n_threads);
+		tpool_parallel_for(p, 0, g->V, GRAPH_PARALLEL_GRAIN, graph_pagerank_scatter, &pr);
+		for(w=0; w<p->n_threads; w++)
+			dangling += pr.partial[w];
+
+		pr.base = (1.0 - damping + damping*dangling)/(double)g->V;
+
+		memset(pr.partial, 0, sizeof(double)*p->n_threads);
+		tpool_parallel_for(p, 0, g->V, GRAPH_PARALLEL_GRAIN, graph_pagerank_gather, &pr);
+		for(w=0; w<p->n_threads; w++)
+			change += pr.partial[w];
+
+		memcpy(rank, pr.next, sizeof(double)*g->V);
+
+		if(change < tolerance){
+			it++;
+			break;
+		}
+	}
+
+	free(pr.next);
+	free(pr.contribution);
+	free(pr.partial);
+	if(iterations) *iterations = it;
+
+	return GERROR_OK;
+}
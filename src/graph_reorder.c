@@ -0,0 +1,353 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#include "graph_reorder.h"
+#include "graph_search.h"
+#include "bitset.h"
+
+/*
+ * degree of a vertex and its index, sorted together
+ */
+typedef struct graph_order_key_t{
+	size_t degree;
+	size_t v;
+}graph_order_key_t;
+
+/*
+ * auxiliar function;
+ * orders by ascending degree and then by index
+ */
+int graph_order_key_compare (const void* a, const void* b)
+{
+	const graph_order_key_t* x = (const graph_order_key_t*) a;
+	const graph_order_key_t* y = (const graph_order_key_t*) b;
+
+	if(x->degree != y->degree) return (x->degree > y->degree) - (x->degree < y->degree);
+	return (x->v > y->v) - (x->v < y->v);
+}
+
+/*
+ * auxiliar function;
+ * writes the degree of every vertex of the frozen graph `g`
+ * in `degree`, counting the edges in when the transpose is
+ * built, and returns the sum of the degrees
+ */
+size_t graph_order_degrees (graph_t* g, size_t* degree)
+{
+	size_t v, total = 0;
+
+	for(v=0; v<g->V; v++){
+		degree[v] = g->row_offsets[v+1] - g->row_offsets[v];
+		if(g->in_offsets)
+			degree[v] += g->in_offsets[v+1] - g->in_offsets[v];
+		total += degree[v];
+	}
+
+	return total;
+}
+
+/*
+ * auxiliar function;
+ * stable counting sort of the vertices by descending degree
+ */
+void graph_order_by_degree (graph_t* g, const size_t* degree, size_t* perm)
+{
+	size_t v, d, max_degree = 0;
+
+	for(v=0; v<g->V; v++)
+		if(degree[v] > max_degree)
+			max_degree = degree[v];
+
+	size_t* start = (size_t*) calloc(max_degree + 2, sizeof(size_t));
+
+	/*
+	 * the vertices of degree `d` start after all the
+	 * vertices of higher degree
+	 */
+	for(v=0; v<g->V; v++)
+		start[max_degree - degree[v] + 1]++;
+	for(d=0; d<=max_degree; d++)
+		start[d+1] += start[d];
+	for(v=0; v<g->V; v++)
+		perm[v] = start[max_degree - degree[v]]++;
+
+	free(start);
+}
+
+/*
+ * auxiliar function;
+ * the vertices of degree above the average first, in their
+ * original relative order, followed by the others
+ */
+void graph_order_by_hub (graph_t* g, const size_t* degree, size_t total, size_t* perm)
+{
+	size_t v, hubs = 0, next_hub = 0, next_other;
+
+	/*
+	 * degree > total/V, without the rounding of the division
+	 */
+	for(v=0; v<g->V; v++)
+		if(degree[v]*g->V > total)
+			hubs++;
+
+	next_other = hubs;
+	for(v=0; v<g->V; v++)
+		perm[v] = degree[v]*g->V > total? next_hub++ : next_other++;
+}
+
+/*
+ * auxiliar function;
+ * appends to `order` the neighbors of `u` in `rows`/`cols` not
+ * yet placed, marking their position in `perm`
+ */
+void graph_order_reach (const size_t* rows, const size_t* cols, size_t u,
+		size_t* order, size_t* tail, size_t* perm)
+{
+	size_t k;
+
+	for(k=rows[u]; k<rows[u+1]; k++){
+		size_t w = cols[k];
+		if(perm[w] != GRAPH_UNREACHED) continue;
+		perm[w] = *tail;
+		order[(*tail)++] = w;
+	}
+}
+
+/*
+ * auxiliar function;
+ * reverse Cuthill-McKee. `order` is the queue of the breadth
+ * first search and, at the end, the vertices in Cuthill-McKee
+ * order; every component starts at its unplaced vertex of the
+ * lowest degree
+ */
+void graph_order_by_rcm (graph_t* g, const size_t* degree, size_t* perm)
+{
+	size_t V = g->V;
+	size_t* order = (size_t*) malloc(sizeof(size_t)*(V? V : 1));
+	graph_order_key_t* start = (graph_order_key_t*) malloc(sizeof(graph_order_key_t)*(V? V : 1));
+	graph_order_key_t* level = (graph_order_key_t*) malloc(sizeof(graph_order_key_t)*(V? V : 1));
+	size_t i, k, s, head = 0, tail = 0;
+
+	for(i=0; i<V; i++){
+		start[i].degree = degree[i];
+		start[i].v = i;
+		perm[i] = GRAPH_UNREACHED;
+	}
+	qsort(start, V, sizeof(graph_order_key_t), graph_order_key_compare);
+
+	for(s=0; s<V; s++){
+		if(perm[start[s].v] != GRAPH_UNREACHED) continue;
+
+		perm[start[s].v] = tail;
+		order[tail++] = start[s].v;
+
+		while( head < tail ){
+			size_t u = order[head++];
+			size_t first = tail;
+
+			graph_order_reach(g->row_offsets, g->col_indices, u, order, &tail, perm);
+			if(g->in_offsets)
+				graph_order_reach(g->in_offsets, g->in_indices, u, order, &tail, perm);
+
+			/*
+			 * the neighbors just placed by ascending degree
+			 */
+			if(tail - first < 2) continue;
+			for(k=first; k<tail; k++){
+				level[k-first].degree = degree[order[k]];
+				level[k-first].v = order[k];
+			}
+			qsort(level, tail - first, sizeof(graph_order_key_t), graph_order_key_compare);
+			for(k=first; k<tail; k++){
+				order[k] = level[k-first].v;
+				perm[order[k]] = k;
+			}
+		}
+	}
+
+	for(i=0; i<V; i++)
+		perm[i] = V - 1 - perm[i];
+
+	free(level);
+	free(start);
+	free(order);
+}
+
+/** Computes a vertex order of the frozen graph `g` that improves
+  * the locality of its traversals, see graph_reorder.h, without
+  * changing `g`. The result is a permutation in the form taken
+  * by `graph_permute`.
+  *
+  * @param g		pointer to a graph structure;
+  * @param strategy	order of the vertices;
+  * @param perm		an array of V elements that will be write
+  * 			with the new index of every vertex
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` or `perm` is a
+  * 		NULL pointer
+  * 		GERROR_UNSUPPORTED_OPERATION in case `g` is not
+  * 		frozen
+  * 		GERROR_INVALID_ARGUMENT in case `strategy` is not
+  * 		a graph_order_t
+  */
+gerror_t graph_order_permutation(graph_t* g, graph_order_t strategy, size_t* perm)
+{
+	if(!g || !perm) return GERROR_NULL_STRUCTURE;
+	if(!g->row_offsets) return GERROR_UNSUPPORTED_OPERATION;
+	if(strategy != GRAPH_ORDER_DEGREE && strategy != GRAPH_ORDER_RCM
+	&& strategy != GRAPH_ORDER_HUB)
+		return GERROR_INVALID_ARGUMENT;
+
+	size_t* degree = (size_t*) malloc(sizeof(size_t)*(g->V? g->V : 1));
+	size_t total = graph_order_degrees(g, degree);
+
+	if(strategy == GRAPH_ORDER_DEGREE)
+		graph_order_by_degree(g, degree, perm);
+	else if(strategy == GRAPH_ORDER_RCM)
+		graph_order_by_rcm(g, degree, perm);
+	else
+		graph_order_by_hub(g, degree, total, perm);
+
+	free(degree);
+	return GERROR_OK;
+}
+
+/** Relabels the vertices of the frozen graph `g`: the vertex `v`
+  * becomes the vertex `perm[v]`. The compressed rows, the weights
+  * and the labels are moved to the new indices, every neighbor
+  * list keeps its order with the neighbors renamed, and the
+  * transpose is rebuilt in case it was built. A mapped snapshot
+  * must not be permuted; permute the graph before `graph_save`.
+  *
+  * @param g		pointer to a graph structure;
+  * @param perm		an array of V elements with the new index
+  * 			of every vertex, a permutation of 0 to V-1
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` or `perm` is a
+  * 		NULL pointer
+  * 		GERROR_UNSUPPORTED_OPERATION in case `g` is not
+  * 		frozen
+  * 		GERROR_INVALID_ARGUMENT in case `perm` is not a
+  * 		permutation of the vertices
+  */
+gerror_t graph_permute(graph_t* g, const size_t* perm)
+{
+	if(!g || !perm) return GERROR_NULL_STRUCTURE;
+	if(!g->row_offsets) return GERROR_UNSUPPORTED_OPERATION;
+
+	size_t V = g->V, E = g->E;
+	size_t rows_size = sizeof(size_t)*(V + 1), cols_size = sizeof(size_t)*(E? E : 1);
+	size_t v, k;
+	bitset_t seen;
+
+	bitset_create(&seen, V);
+	for(v=0; v<V; v++){
+		if(perm[v] >= V || BITSET_TEST(&seen, perm[v])){
+			bitset_destroy(&seen);
+			return GERROR_INVALID_ARGUMENT;
+		}
+		BITSET_SET(&seen, perm[v]);
+	}
+	bitset_destroy(&seen);
+
+	size_t* rows = (size_t*) GALLOC_ALLOC(g->allocator, rows_size);
+	size_t* cols = (size_t*) GALLOC_ALLOC(g->allocator, cols_size);
+	double* weights = NULL;
+	if(g->weights)
+		weights = (double*) GALLOC_ALLOC(g->allocator, sizeof(double)*(E? E : 1));
+
+	rows[0] = 0;
+	for(v=0; v<V; v++)
+		rows[perm[v] + 1] = g->row_offsets[v+1] - g->row_offsets[v];
+	for(v=0; v<V; v++)
+		rows[v+1] += rows[v];
+
+	for(v=0; v<V; v++){
+		size_t at = rows[perm[v]];
+		for(k=g->row_offsets[v]; k<g->row_offsets[v+1]; k++, at++){
+			cols[at] = perm[g->col_indices[k]];
+			if(weights)
+				weights[at] = g->weights[k];
+		}
+	}
+
+	GALLOC_FREE(g->allocator, g->row_offsets, rows_size);
+	GALLOC_FREE(g->allocator, g->col_indices, cols_size);
+	if(weights)
+		GALLOC_FREE(g->allocator, g->weights, sizeof(double)*(E? E : 1));
+	g->row_offsets = rows;
+	g->col_indices = cols;
+	g->weights = weights;
+	GSTATS_ADD(g, allocations, weights? 3 : 2);
+	GSTATS_ADD(g, bytes_moved, E*(weights? sizeof(size_t) + sizeof(double) : sizeof(size_t)));
+
+	if(g->label && g->member_size){
+		char* label = (char*) GALLOC_ALLOC(g->allocator, g->member_size*V);
+		for(v=0; v<V; v++)
+			memcpy(label + perm[v]*g->member_size,
+				(char*) g->label + v*g->member_size, g->member_size);
+		GALLOC_FREE(g->allocator, g->label, g->member_size*V);
+		g->label = label;
+		GSTATS_ADD(g, allocations, 1);
+		GSTATS_ADD(g, bytes_moved, g->member_size*V);
+	}
+
+	if(g->in_offsets){
+		GALLOC_FREE(g->allocator, g->in_offsets, rows_size);
+		GALLOC_FREE(g->allocator, g->in_indices, cols_size);
+		g->in_offsets = g->in_indices = NULL;
+		graph_build_transpose(g);
+	}
+
+	return GERROR_OK;
+}
+
+/** Reorders the vertices of the frozen graph `g` for the locality
+  * of its traversals: computes the order `strategy`, see
+  * graph_reorder.h, and relabels `g` with it as `graph_permute`
+  * does. Meant to be called once, after the graph is loaded and
+  * before it is traversed.
+  *
+  * @param g		pointer to a graph structure;
+  * @param strategy	order of the vertices;
+  * @param perm		NULL or an array of V elements that will be
+  * 			write with the new index of every vertex,
+  * 			to map the old indices to the new ones
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  * 		GERROR_UNSUPPORTED_OPERATION in case `g` is not
+  * 		frozen
+  * 		GERROR_INVALID_ARGUMENT in case `strategy` is not
+  * 		a graph_order_t
+  */
+gerror_t graph_reorder(graph_t* g, graph_order_t strategy, size_t* perm)
+{
+	if(!g) return GERROR_NULL_STRUCTURE;
+
+	size_t* order = perm? perm : (size_t*) malloc(sizeof(size_t)*(g->V? g->V : 1));
+	gerror_t s = graph_order_permutation(g, strategy, order);
+
+	if(s == GERROR_OK)
+		s = graph_permute(g, order);
+
+	if(!perm) free(order);
+	return s;
+}
@@ -0,0 +1,514 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#include "graph_search.h"
+#include "bitset.h"
+#include "priority_queue.h"
+
+/*
+ * auxiliar function;
+ * number of edges that leave the vertex `v`
+ */
+size_t graph_out_degree (graph_t* g, size_t v)
+{
+	if(g->row_offsets)
+		return g->row_offsets[v+1] - g->row_offsets[v];
+	return g->adj[v].size;
+}
+
+/*
+ * auxiliar function;
+ * marks `v` as reached from `from` at `depth` and calls `visit`
+ */
+int graph_search_reach (graph_t* g, bitset_t* visited, size_t* distance, size_t* parent,
+		size_t v, size_t from, size_t depth,
+		graph_visit_function visit, void* argument)
+{
+	BITSET_SET(visited, v);
+	if(distance) distance[v] = depth;
+	if(parent) parent[v] = from;
+
+	return visit? visit(g, v, from, depth, argument) : 0;
+}
+
+/** Breadth-first search on the graph `g` from the vertex `source`.
+  *
+  * The visited vertices are kept in a bitset and the frontiers in
+  * contiguous arrays. In case `g` is frozen and its transpose was
+  * built, the search is direction-optimizing: on the levels where
+  * the frontier is large, every unvisited vertex looks for a
+  * parent in the frontier instead of the frontier scanning all
+  * its edges. In the bottom-up levels the vertices of a level are
+  * reached in the order of their indexes.
+  *
+  * @param g		pointer to a graph structure;
+  * @param source	index of the first vertex;
+  * @param distance	NULL or an array of V elements that will
+  * 			be write with the depth of every vertex
+  * @param parent	NULL or an array of V elements that will
+  * 			be write with the vertex from which every
+  * 			vertex was reached
+  * @param visit	NULL or a function called on every
+  * 			vertex reached;
+  * @param argument	argument passed to `visit`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  * 		GERROR_ACCESS_OUT_OF_BOUND in case that `source`
+  * 		is out of bound
+  */
+gerror_t graph_bfs(graph_t* g, size_t source, size_t* distance, size_t* parent,
+		graph_visit_function visit, void* argument)
+{
+	if(!g) return GERROR_NULL_STRUCTURE;
+	if(source >= g->V) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	size_t i, k;
+	for(i=0; i<g->V; i++){
+		if(distance) distance[i] = GRAPH_UNREACHED;
+		if(parent) parent[i] = GRAPH_UNREACHED;
+	}
+
+	bitset_t visited, in_frontier;
+	bitset_create(&visited, g->V);
+
+	int can_bottom_up = g->row_offsets && g->in_offsets;
+	if(can_bottom_up)
+		bitset_create(&in_frontier, g->V);
+
+	size_t* frontier = (size_t*) malloc(sizeof(size_t)*g->V);
+	size_t* next = (size_t*) malloc(sizeof(size_t)*g->V);
+	size_t n_frontier = 1, n_next;
+
+	size_t depth = 0;
+	int bottom_up = 0;
+	size_t edges_frontier = graph_out_degree(g, source);
+	size_t edges_unvisited = g->E - edges_frontier;
+
+	frontier[0] = source;
+	if( graph_search_reach(g, &visited, distance, parent, source, source, 0, visit, argument) )
+		goto end;
+
+	while( n_frontier ){
+		if(can_bottom_up){
+			if(!bottom_up && edges_frontier > edges_unvisited/GRAPH_BFS_ALPHA)
+				bottom_up = 1;
+			else if(bottom_up && n_frontier < g->V/GRAPH_BFS_BETA)
+				bottom_up = 0;
+		}
+
+		depth++;
+		n_next = 0;
+
+		if(!bottom_up){
+			for(i=0; i<n_frontier; i++){
+				size_t u = frontier[i];
+
+				if(g->row_offsets){
+					for(k=g->row_offsets[u]; k<g->row_offsets[u+1]; k++){
+						size_t w = g->col_indices[k];
+						if(BITSET_TEST(&visited, w)) continue;
+
+						next[n_next++] = w;
+						if( graph_search_reach(g, &visited, distance, parent,
+									w, u, depth, visit, argument) )
+							goto end;
+					}
+				}else{
+					qnode_t* j;
+					for(j=g->adj[u].head; j!=NULL; j = j->next){
+						size_t w = *(size_t*)j->data;
+						if(BITSET_TEST(&visited, w)) continue;
+
+						next[n_next++] = w;
+						if( graph_search_reach(g, &visited, distance, parent,
+									w, u, depth, visit, argument) )
+							goto end;
+					}
+				}
+			}
+		}else{
+			bitset_clear(&in_frontier);
+			for(i=0; i<n_frontier; i++)
+				BITSET_SET(&in_frontier, frontier[i]);
+
+			for(i=0; i<g->V; i++){
+				if(BITSET_TEST(&visited, i)) continue;
+
+				for(k=g->in_offsets[i]; k<g->in_offsets[i+1]; k++){
+					size_t u = g->in_indices[k];
+					if(!BITSET_TEST(&in_frontier, u)) continue;
+
+					next[n_next++] = i;
+					if( graph_search_reach(g, &visited, distance, parent,
+								i, u, depth, visit, argument) )
+						goto end;
+					break;
+				}
+			}
+		}
+
+		edges_frontier = 0;
+		for(i=0; i<n_next; i++)
+			edges_frontier += graph_out_degree(g, next[i]);
+		edges_unvisited -= edges_frontier;
+
+		size_t* t = frontier;
+		frontier = next;
+		next = t;
+		n_frontier = n_next;
+	}
+
+end:
+	free(frontier);
+	free(next);
+	bitset_destroy(&visited);
+	if(can_bottom_up)
+		bitset_destroy(&in_frontier);
+
+	return GERROR_OK;
+}
+
+/*
+ * a vertex in the stack of the depth-first search and the
+ * position of its next neighbor
+ */
+typedef struct graph_dfs_frame_t{
+	size_t v;
+	size_t k;
+	qnode_t* node;
+}graph_dfs_frame_t;
+
+/** Depth-first search on the graph `g` from the vertex
+  * `source`. The vertices are visited in preorder and the
+  * search keeps an explicit stack, so its depth is not limited
+  * by the call stack.
+  *
+  * @param g		pointer to a graph structure;
+  * @param source	index of the first vertex;
+  * @param parent	NULL or an array of V elements that will
+  * 			be write with the vertex from which every
+  * 			vertex was reached
+  * @param visit	NULL or a function called on every
+  * 			vertex reached;
+  * @param argument	argument passed to `visit`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  * 		GERROR_ACCESS_OUT_OF_BOUND in case that `source`
+  * 		is out of bound
+  */
+gerror_t graph_dfs(graph_t* g, size_t source, size_t* parent,
+		graph_visit_function visit, void* argument)
+{
+	if(!g) return GERROR_NULL_STRUCTURE;
+	if(source >= g->V) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	size_t i;
+	if(parent)
+		for(i=0; i<g->V; i++)
+			parent[i] = GRAPH_UNREACHED;
+
+	bitset_t visited;
+	bitset_create(&visited, g->V);
+
+	graph_dfs_frame_t* stack = (graph_dfs_frame_t*) malloc(sizeof(graph_dfs_frame_t)*g->V);
+	size_t top = 0;
+
+	if( graph_search_reach(g, &visited, NULL, parent, source, source, 0, visit, argument) )
+		goto end;
+
+	stack[0].v = source;
+	stack[0].k = g->row_offsets? g->row_offsets[source] : 0;
+	stack[0].node = g->row_offsets? NULL : g->adj[source].head;
+	top = 1;
+
+	while( top ){
+		graph_dfs_frame_t* f = &stack[top-1];
+		size_t w;
+
+		if(g->row_offsets){
+			if(f->k == g->row_offsets[f->v+1]){
+				top--;
+				continue;
+			}
+			w = g->col_indices[f->k++];
+		}else{
+			if(!f->node){
+				top--;
+				continue;
+			}
+			w = *(size_t*)f->node->data;
+			f->node = f->node->next;
+		}
+
+		if(BITSET_TEST(&visited, w)) continue;
+
+		if( graph_search_reach(g, &visited, NULL, parent, w, f->v, top, visit, argument) )
+			goto end;
+
+		stack[top].v = w;
+		stack[top].k = g->row_offsets? g->row_offsets[w] : 0;
+		stack[top].node = g->row_offsets? NULL : g->adj[w].head;
+		top++;
+	}
+
+end:
+	free(stack);
+	bitset_destroy(&visited);
+
+	return GERROR_OK;
+}
+
+/*
+ * auxiliar function;
+ * root of the set of `v`, halving the path on the way
+ */
+size_t graph_find_root (size_t* root, size_t v)
+{
+	while(root[v] != v){
+		root[v] = root[root[v]];
+		v = root[v];
+	}
+	return v;
+}
+
+/*
+ * auxiliar function;
+ * joins the sets of `u` and `v`, the smaller under the larger
+ */
+void graph_union (size_t* root, size_t* rank, size_t u, size_t v)
+{
+	u = graph_find_root(root, u);
+	v = graph_find_root(root, v);
+	if(u == v) return;
+
+	if(rank[u] < rank[v]){
+		size_t t = u;
+		u = v;
+		v = t;
+	}
+	root[v] = u;
+	rank[u] += rank[v];
+}
+
+/** Finds the connected components of the graph `g`, ignoring
+  * the direction of the edges (weakly connected components).
+  * The components are numbered from 0 in the order of their
+  * vertex with the lowest index.
+  *
+  * @param g		pointer to a graph structure;
+  * @param component	an array of V elements that will be
+  * 			write with the component of every vertex
+  * @param n_components	NULL or pointer that will be write with
+  * 			the number of components
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  */
+gerror_t graph_connected_components(graph_t* g, size_t* component, size_t* n_components)
+{
+	if(!g) return GERROR_NULL_STRUCTURE;
+
+	size_t* rank = (size_t*) malloc(sizeof(size_t)*(g->V? g->V : 1));
+	size_t i, k, n = 0;
+
+	for(i=0; i<g->V; i++){
+		component[i] = i;
+		rank[i] = 1;
+	}
+
+	for(i=0; i<g->V; i++){
+		if(g->row_offsets){
+			for(k=g->row_offsets[i]; k<g->row_offsets[i+1]; k++)
+				graph_union(component, rank, i, g->col_indices[k]);
+		}else{
+			qnode_t* j;
+			for(j=g->adj[i].head; j!=NULL; j = j->next)
+				graph_union(component, rank, i, *(size_t*)j->data);
+		}
+	}
+
+	/*
+	 * `rank` is reused to keep the root of every vertex
+	 * and `component` to number the roots as they appear
+	 */
+	for(i=0; i<g->V; i++)
+		rank[i] = graph_find_root(component, i);
+	for(i=0; i<g->V; i++)
+		component[i] = GRAPH_UNREACHED;
+	for(i=0; i<g->V; i++){
+		size_t r = rank[i];
+		if(component[r] == GRAPH_UNREACHED)
+			component[r] = n++;
+		component[i] = component[r];
+	}
+
+	free(rank);
+	if(n_components) *n_components = n;
+
+	return GERROR_OK;
+}
+
+/*
+ * auxiliar function;
+ * the lower distance has the higher priority
+ */
+int graph_distance_compare (void* a, void* b, void* arg)
+{
+	double x = *(double*)a;
+	double y = *(double*)b;
+	(void)arg;
+
+	if(x < y) return G_PQUEUE_FIRST_PRIORITY;
+	if(x > y) return G_PQUEUE_SECOND_PRIORITY;
+	return G_PQUEUE_EQUAL_PRIORITY;
+}
+
+/*
+ * auxiliar function;
+ * relaxes the edge from `u`, at the distance `d`, to `to`; the
+ * element of `to` in the queue is moved instead of added again
+ */
+void graph_relax (pqueue_t* q, double* distance, size_t* parent,
+		size_t u, double d, size_t to, double weight)
+{
+	double candidate = d + weight;
+	if(candidate >= distance[to]) return;
+
+	distance[to] = candidate;
+	if(parent) parent[to] = u;
+
+	if(pqueue_contains_key(q, to))
+		pqueue_decrease_key(q, to, &candidate);
+	else
+		pqueue_add_indexed(q, to, &candidate);
+}
+
+/** Finds the shortest paths of the graph `g` from the vertex
+  * `source` with Dijkstra's algorithm. The vertices wait in an
+  * indexed priority queue, so every vertex is in the queue at
+  * most once and a shorter path only moves it up the queue.
+  * The edges of an unweighted graph weigh 1.
+  *
+  * @param g		pointer to a graph structure;
+  * @param source	index of the first vertex;
+  * @param target	index of a vertex at which the search
+  * 			stops once its distance is known, or
+  * 			GRAPH_UNREACHED to reach every vertex
+  * @param distance	an array of V elements that will be
+  * 			write with the distance of every vertex,
+  * 			or GRAPH_INFINITY
+  * @param parent	NULL or an array of V elements that will
+  * 			be write with the previous vertex in the
+  * 			shortest path to every vertex
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  * 		GERROR_ACCESS_OUT_OF_BOUND in case that `source`
+  * 		or `target` is out of bound
+  * 		GERROR_INVALID_ARGUMENT in case a negative
+  * 		weight is reached
+  */
+gerror_t graph_dijkstra(graph_t* g, size_t source, size_t target, double* distance, size_t* parent)
+{
+	if(!g) return GERROR_NULL_STRUCTURE;
+	if(source >= g->V) return GERROR_ACCESS_OUT_OF_BOUND;
+	if(target != GRAPH_UNREACHED && target >= g->V) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	size_t i, k, u;
+	for(i=0; i<g->V; i++){
+		distance[i] = GRAPH_INFINITY;
+		if(parent) parent[i] = GRAPH_UNREACHED;
+	}
+
+	pqueue_t q;
+	pqueue_create_indexed(&q, sizeof(double), g->V, graph_distance_compare, NULL);
+
+	double d = 0.0;
+	distance[source] = 0.0;
+	if(parent) parent[source] = source;
+	pqueue_add_indexed(&q, source, &d);
+
+	gerror_t s = GERROR_OK;
+	while( pqueue_extract_indexed(&q, &d, &u) == GERROR_OK ){
+		if(u == target) break;
+
+		if(g->row_offsets){
+			for(k=g->row_offsets[u]; k<g->row_offsets[u+1]; k++){
+				double weight = g->weights? g->weights[k] : 1.0;
+				if(weight < 0.0){
+					s = GERROR_INVALID_ARGUMENT;
+					goto end;
+				}
+				graph_relax(&q, distance, parent, u, d, g->col_indices[k], weight);
+			}
+		}else{
+			qnode_t* j;
+			for(j=g->adj[u].head; j!=NULL; j = j->next){
+				double weight = g->weighted? ((graph_edge_t*)j->data)->weight : 1.0;
+				if(weight < 0.0){
+					s = GERROR_INVALID_ARGUMENT;
+					goto end;
+				}
+				graph_relax(&q, distance, parent, u, d, *(size_t*)j->data, weight);
+			}
+		}
+	}
+
+end:
+	pqueue_destroy(&q);
+	return s;
+}
+
+/** Finds the shortest paths of the graph `g` from the vertex
+  * `source` to every vertex: with `graph_bfs` in case `g` is not
+  * weighted and with `graph_dijkstra` otherwise.
+  *
+  * @param g		pointer to a graph structure;
+  * @param source	index of the first vertex;
+  * @param distance	an array of V elements that will be
+  * 			write with the distance of every vertex,
+  * 			or GRAPH_INFINITY
+  * @param parent	NULL or an array of V elements that will
+  * 			be write with the previous vertex in the
+  * 			shortest path to every vertex
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  * 		GERROR_ACCESS_OUT_OF_BOUND in case that `source`
+  * 		is out of bound
+  * 		GERROR_INVALID_ARGUMENT in case a negative
+  * 		weight is reached
+  */
+gerror_t graph_sssp(graph_t* g, size_t source, double* distance, size_t* parent)
+{
+	if(!g) return GERROR_NULL_STRUCTURE;
+	if(g->weighted) return graph_dijkstra(g, source, GRAPH_UNREACHED, distance, parent);
+	if(source >= g->V) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	size_t* hops = (size_t*) malloc(sizeof(size_t)*g->V);
+	gerror_t s = graph_bfs(g, source, hops, parent, NULL, NULL);
+
+	size_t i;
+	for(i=0; i<g->V; i++)
+		distance[i] = hops[i] == GRAPH_UNREACHED? GRAPH_INFINITY : (double)hops[i];
+
+	free(hops);
+	return s;
+}
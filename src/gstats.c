@@ -0,0 +1,168 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#include <pthread.h>
+#include <string.h>
+#include "gstats.h"
+
+pthread_mutex_t gstats_lock = PTHREAD_MUTEX_INITIALIZER;
+gstats_entry_t* gstats_head = NULL;
+
+/*
+ * auxiliar function;
+ * unlinks `entry` in case it is in the registry. An entry is
+ * registered only when it points to itself, so an entry of
+ * uninitialized memory or a copy of a registered one is not
+ * taken for one in the registry. `gstats_lock` is held.
+ */
+void gstats_unlink (gstats_entry_t* entry)
+{
+	if( entry->self != entry ) return;
+
+	if( entry->prev )
+		entry->prev->next = entry->next;
+	else
+		gstats_head = entry->next;
+	if( entry->next )
+		entry->next->prev = entry->prev;
+
+	entry->prev = entry->next = NULL;
+	entry->self = NULL;
+}
+
+/** Clears the counters of `entry`, leaving the registry in case
+  * the container was created again without its `*_destroy`.
+  *
+  * @param entry	the `stats` member of the container
+  */
+void gstats_init (gstats_entry_t* entry)
+{
+	pthread_mutex_lock(&gstats_lock);
+	gstats_unlink(entry);
+	pthread_mutex_unlock(&gstats_lock);
+
+	memset(entry, 0, sizeof(gstats_entry_t));
+}
+
+/** Adds `entry` of the `container` of `type` to the registry,
+  * `get` reads its counters for `gstats_dump`. An entry already
+  * in the registry is moved to its head, not added twice.
+  *
+  * @param entry	the `stats` member of the container;
+  * @param type		name of the type of the container;
+  * @param container	pointer to the container;
+  * @param get		the `*_get_stats` function of the type
+  */
+void gstats_register (gstats_entry_t* entry, const char* type, void* container, gstats_function get)
+{
+	entry->type = type;
+	entry->container = container;
+	entry->get = get;
+
+	pthread_mutex_lock(&gstats_lock);
+	gstats_unlink(entry);
+	entry->prev = NULL;
+	entry->next = gstats_head;
+	if( gstats_head )
+		gstats_head->prev = entry;
+	gstats_head = entry;
+	entry->self = entry;
+	pthread_mutex_unlock(&gstats_lock);
+}
+
+/** Removes `entry` from the registry, in case it is there; the
+  * counters are kept.
+  *
+  * @param entry	the `stats` member of the container
+  */
+void gstats_unregister (gstats_entry_t* entry)
+{
+	pthread_mutex_lock(&gstats_lock);
+	gstats_unlink(entry);
+	pthread_mutex_unlock(&gstats_lock);
+}
+
+/** Removes from the registry every entry that lives in the `size`
+  * bytes at `begin`, the containers whose memory is given back
+  * at once without their `*_destroy`, see `garena_reset`.
+  *
+  * @param begin	first byte of the memory;
+  * @param size		number of bytes
+  */
+void gstats_unregister_range (const void* begin, size_t size)
+{
+	const char* first = (const char*) begin;
+	gstats_entry_t* entry, *next;
+
+	pthread_mutex_lock(&gstats_lock);
+	for( entry=gstats_head; entry; entry=next ){
+		next = entry->next;
+		if( (const char*) entry >= first && (const char*) entry < first + size )
+			gstats_unlink(entry);
+	}
+	pthread_mutex_unlock(&gstats_lock);
+}
+
+/** Adds the counters of `other`, a container owned by the
+  * container of `stats`, to `stats`. The sizes and the depth
+  * are the ones of the owner.
+  */
+void gstats_merge (gstats_t* stats, gstats_t* other)
+{
+	stats->allocations += other->allocations;
+	stats->reallocations += other->reallocations;
+	stats->bytes_moved += other->bytes_moved;
+	stats->comparisons += other->comparisons;
+	stats->nodes += other->nodes;
+}
+
+/** Prints one line with the counters of every registered
+  * container to `out`.
+  *
+  * @param out	the stream, usually `stderr`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_UNSUPPORTED_OPERATION in case the library
+  * 		was built without GENERICS_STATS
+  */
+gerror_t gstats_dump (FILE* out)
+{
+#ifdef GENERICS_STATS
+	gstats_entry_t* entry;
+	gstats_t s;
+
+	pthread_mutex_lock(&gstats_lock);
+	for( entry=gstats_head; entry; entry=entry->next ){
+		memset(&s, 0, sizeof(s));
+		entry->get(entry->container, &s);
+		fprintf(out, "%s %p size=%lu peak_size=%lu allocations=%lu reallocations=%lu "
+				"bytes_moved=%lu comparisons=%lu nodes=%lu depth=%lu\n",
+			entry->type, entry->container,
+			(unsigned long)s.size, (unsigned long)s.peak_size,
+			(unsigned long)s.allocations, (unsigned long)s.reallocations,
+			(unsigned long)s.bytes_moved, (unsigned long)s.comparisons,
+			(unsigned long)s.nodes, (unsigned long)s.depth);
+	}
+	pthread_mutex_unlock(&gstats_lock);
+
+	return GERROR_OK;
+#else
+	(void) out;
+	return GERROR_UNSUPPORTED_OPERATION;
+#endif
+}
@@ -0,0 +1,643 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#include "hashmap.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define HASHMAP_STRIDE 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define HASHMAP_STRIDE 4
+#else
+#define HASHMAP_STRIDE 1
+#endif
+
+#define HASHMAP_ALIGN(n) (((n) + 7) & ~(size_t)7)
+#define HASHMAP_INDEX(mask) ((size_t)__builtin_ctzll(mask) / HASHMAP_STRIDE)
+
+#define HASHMAP_SLOT(h, i) ((h)->slots + (i)*(h)->slot_size)
+#define HASHMAP_LENGTH(slot) (*(size_t*)(slot))
+#define HASHMAP_VALUE(h, slot) ((slot) + (h)->value_offset)
+
+/*
+ * auxiliar function;
+ * mask of the slots of `group` whose control byte is `byte`,
+ * one bit every HASHMAP_STRIDE bits
+ */
+uint64_t hashmap_match (const unsigned char* group, unsigned char byte)
+{
+#if defined(__SSE2__)
+	__m128i cmp = _mm_cmpeq_epi8(	_mm_set1_epi8((char)byte),
+					_mm_loadu_si128((const __m128i*)group) );
+	return (uint64_t)_mm_movemask_epi8(cmp);
+#elif defined(__ARM_NEON)
+	uint8x16_t cmp = vceqq_u8(vdupq_n_u8(byte), vld1q_u8(group));
+	return vget_lane_u64(vreinterpret_u64_u8(
+			vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4)), 0) & 0x8888888888888888ULL;
+#else
+	uint64_t mask = 0;
+	int i;
+	for( i=0; i<HASHMAP_GROUP; i++ )
+		if( group[i] == byte )
+			mask |= (uint64_t)1 << i;
+	return mask;
+#endif
+}
+
+/*
+ * auxiliar function;
+ * mask of the slots of `group` that are empty or deleted, that
+ * is, whose control byte has the high bit set
+ */
+uint64_t hashmap_match_free (const unsigned char* group)
+{
+#if defined(__SSE2__)
+	return (uint64_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#elif defined(__ARM_NEON)
+	int8x16_t sign = vshrq_n_s8(vreinterpretq_s8_u8(vld1q_u8(group)), 7);
+	return vget_lane_u64(vreinterpret_u64_u8(
+			vshrn_n_u16(vreinterpretq_u16_s8(sign), 4)), 0) & 0x8888888888888888ULL;
+#else
+	uint64_t mask = 0;
+	int i;
+	for( i=0; i<HASHMAP_GROUP; i++ )
+		if( group[i] & 0x80 )
+			mask |= (uint64_t)1 << i;
+	return mask;
+#endif
+}
+
+/*
+ * auxiliar function;
+ * finalizer of murmur3, spreads every bit of `x` to all the
+ * bits of the result
+ */
+uint64_t hashmap_mix (uint64_t x)
+{
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+	return x;
+}
+
+/** Default hash function of the hash maps: reads the key 8 bytes
+  * at a time and mixes every word with a multiply.
+  *
+  * @param key		pointer to the bytes of the key;
+  * @param size		size of the key
+  *
+  * @return the hash of the key
+  */
+uint64_t hashmap_hash_default (const void* key, size_t size)
+{
+	const unsigned char* p = (const unsigned char*) key;
+	uint64_t hash = 0x9e3779b97f4a7c15ULL ^ size, word;
+
+	for( ; size >= 8; size -= 8, p += 8 ){
+		memcpy(&word, p, 8);
+		hash = (hash ^ hashmap_mix(word)) * 0x9e3779b97f4a7c15ULL;
+	}
+	if( size ){
+		word = 0;
+		memcpy(&word, p, size);
+		hash = (hash ^ hashmap_mix(word)) * 0x9e3779b97f4a7c15ULL;
+	}
+
+	return hashmap_mix(hash);
+}
+
+/*
+ * auxiliar function;
+ * the bytes of the key kept by `slot`
+ */
+void* hashmap_key (hashmap_t* h, char* slot)
+{
+	if( HASHMAP_LENGTH(slot) > h->key_size )
+		return *(void**)(slot + sizeof(size_t));
+	return slot + sizeof(size_t);
+}
+
+/*
+ * auxiliar function;
+ * `hashmap_get_stats` for the registry
+ */
+gerror_t hashmap_stats_of (void* h, gstats_t* stats)
+{
+	return hashmap_get_stats((hashmap_t*) h, stats);
+}
+
+/** Inicialize the hash map `h`, that maps keys of any size to
+  * elements of `member_size` bytes, with the default hash
+  * function. The h has to be allocated.
+  *
+  * @param h		pointer to the allocated hashmap_t;
+  * @param key_size	size in bytes of the longest key kept
+  * 			inline in the slots;
+  * @param member_size	size in bytes of the elements
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `h` is a NULL
+  */
+gerror_t hashmap_create (hashmap_t* h, size_t key_size, size_t member_size)
+{
+	return hashmap_create_with_allocator(h, key_size, member_size, NULL, &galloc_default);
+}
+
+/** Inicialize the hash map `h` as `hashmap_create`, but the keys
+  * are hashed by `hash`.
+  *
+  * @param h		pointer to the allocated hashmap_t;
+  * @param key_size	size in bytes of the longest key kept
+  * 			inline in the slots;
+  * @param member_size	size in bytes of the elements;
+  * @param hash		hash function of the keys, NULL for
+  * 			`hashmap_hash_default`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `h` is a NULL
+  */
+gerror_t hashmap_create_with_hash (hashmap_t* h, size_t key_size, size_t member_size,
+		hashmap_hash_function hash)
+{
+	return hashmap_create_with_allocator(h, key_size, member_size, hash, &galloc_default);
+}
+
+/** Inicialize the hash map `h` as `hashmap_create_with_hash`, but
+  * its memory comes from `allocator`.
+  *
+  * @param h		pointer to the allocated hashmap_t;
+  * @param key_size	size in bytes of the longest key kept
+  * 			inline in the slots;
+  * @param member_size	size in bytes of the elements;
+  * @param hash		hash function of the keys, NULL for
+  * 			`hashmap_hash_default`;
+  * @param allocator	allocator of the table and the long keys
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `h` or `allocator`
+  * 		is a NULL pointer
+  */
+gerror_t hashmap_create_with_allocator (hashmap_t* h, size_t key_size, size_t member_size,
+		hashmap_hash_function hash, const galloc_t* allocator)
+{
+	if(!h || !allocator) return GERROR_NULL_STRUCTURE;
+
+	/* a slot has room for the pointer to a long key */
+	if( key_size < sizeof(void*) )
+		key_size = sizeof(void*);
+
+	h->size = 0;
+	h->key_size = HASHMAP_ALIGN(key_size);
+	h->member_size = member_size;
+	h->capacity = 0;
+	h->deleted = 0;
+	h->value_offset = HASHMAP_ALIGN(sizeof(size_t) + h->key_size);
+	h->slot_size = HASHMAP_ALIGN(h->value_offset + member_size);
+	h->control = NULL;
+	h->slots = NULL;
+	h->hash = hash? hash : hashmap_hash_default;
+	h->allocator = allocator;
+
+	GSTATS_INIT(h);
+	GSTATS_REGISTER(h, "hashmap", hashmap_stats_of);
+	return GERROR_OK;
+}
+
+/*
+ * auxiliar function;
+ * frees the long keys of the full slots of `h`
+ */
+void hashmap_free_keys (hashmap_t* h)
+{
+	size_t i;
+	for( i=0; i<h->capacity; i++ ){
+		char* slot = HASHMAP_SLOT(h, i);
+		if( !(h->control[i] & 0x80) && HASHMAP_LENGTH(slot) > h->key_size )
+			GALLOC_FREE(h->allocator, hashmap_key(h, slot), HASHMAP_LENGTH(slot));
+	}
+}
+
+/** Destroy the members pointed by `h`.
+  * The structure is not freed.
+  *
+  * @param h		pointer to the hashmap_t
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `h` is a NULL
+  */
+gerror_t hashmap_destroy (hashmap_t* h)
+{
+	if(!h) return GERROR_NULL_STRUCTURE;
+
+	GSTATS_UNREGISTER(h);
+
+	if( h->capacity ){
+		hashmap_free_keys(h);
+		GALLOC_FREE(h->allocator, h->control, h->capacity);
+		GALLOC_FREE(h->allocator, h->slots, h->capacity*h->slot_size);
+	}
+
+	h->control = NULL;
+	h->slots = NULL;
+	h->size = h->capacity = h->deleted = 0;
+	h->member_size = 0;
+
+	return GERROR_OK;
+}
+
+/*
+ * auxiliar function;
+ * a free slot for a key of hash `hash`, that is not in the map;
+ * `h` has at least one empty slot
+ */
+size_t hashmap_find_free (hashmap_t* h, uint64_t hash)
+{
+	size_t mask = h->capacity/HASHMAP_GROUP - 1;
+	size_t group = (size_t)(hash >> 7) & mask, step = 0;
+
+	for(;;){
+		uint64_t free_slots = hashmap_match_free(h->control + group*HASHMAP_GROUP);
+		if( free_slots )
+			return group*HASHMAP_GROUP + HASHMAP_INDEX(free_slots);
+
+		step++;
+		group = (group + step) & mask;
+	}
+}
+
+/*
+ * auxiliar function;
+ * moves the elements of `h` to a new table of `capacity` slots,
+ * that drops the deleted slots
+ */
+void hashmap_rehash (hashmap_t* h, size_t capacity)
+{
+	unsigned char* control = h->control;
+	char* slots = h->slots;
+	size_t old_capacity = h->capacity, i;
+
+	h->control = (unsigned char*) GALLOC_ALLOC(h->allocator, capacity);
+	h->slots = (char*) GALLOC_ALLOC(h->allocator, capacity*h->slot_size);
+	h->capacity = capacity;
+	h->deleted = 0;
+	memset(h->control, HASHMAP_EMPTY, capacity);
+
+	GSTATS_ADD(h, allocations, 2);
+	if( old_capacity )
+		GSTATS_ADD(h, reallocations, 1);
+
+	for( i=0; i<old_capacity; i++ ){
+		if( control[i] & 0x80 ) continue;
+
+		char* slot = slots + i*h->slot_size;
+		uint64_t hash = h->hash(hashmap_key(h, slot), HASHMAP_LENGTH(slot));
+		size_t to = hashmap_find_free(h, hash);
+
+		h->control[to] = control[i];
+		memcpy(HASHMAP_SLOT(h, to), slot, h->slot_size);
+		GSTATS_ADD(h, bytes_moved, h->slot_size);
+	}
+
+	if( old_capacity ){
+		GALLOC_FREE(h->allocator, control, old_capacity);
+		GALLOC_FREE(h->allocator, slots, old_capacity*h->slot_size);
+	}
+}
+
+/*
+ * auxiliar function;
+ * smallest capacity in which `n` elements fill at most 7/8 of
+ * the slots
+ */
+size_t hashmap_capacity_for (size_t n)
+{
+	size_t capacity = HASHMAP_GROUP;
+	while( capacity - capacity/8 < n )
+		capacity *= 2;
+	return capacity;
+}
+
+/** Makes room in `h` for `n_elements` elements, so that they can
+  * be added without rehashing the map.
+  *
+  * @param h		pointer to the hashmap_t;
+  * @param n_elements	number of elements
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `h` is a NULL
+  */
+gerror_t hashmap_reserve (hashmap_t* h, size_t n_elements)
+{
+	if(!h) return GERROR_NULL_STRUCTURE;
+
+	size_t capacity = hashmap_capacity_for(n_elements);
+	if( capacity > h->capacity )
+		hashmap_rehash(h, capacity);
+
+	return GERROR_OK;
+}
+
+/** Removes all the elements of `h`. The table is kept, so it can
+  * be filled again without allocating.
+  *
+  * @param h		pointer to the hashmap_t
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `h` is a NULL
+  */
+gerror_t hashmap_clear (hashmap_t* h)
+{
+	if(!h) return GERROR_NULL_STRUCTURE;
+
+	if( h->capacity ){
+		hashmap_free_keys(h);
+		memset(h->control, HASHMAP_EMPTY, h->capacity);
+	}
+	h->size = h->deleted = 0;
+
+	return GERROR_OK;
+}
+
+/*
+ * auxiliar function;
+ * index of the slot that maps `key` or `h->capacity` in case
+ * the key is not in `h`
+ */
+size_t hashmap_find (hashmap_t* h, void* key, size_t size, uint64_t hash)
+{
+	if( !h->capacity ) return 0;
+
+	unsigned char h2 = (unsigned char)(hash & 0x7F);
+	size_t mask = h->capacity/HASHMAP_GROUP - 1;
+	size_t group = (size_t)(hash >> 7) & mask, step;
+
+	for( step=0; step<=mask; step++ ){
+		const unsigned char* control = h->control + group*HASHMAP_GROUP;
+		uint64_t match = hashmap_match(control, h2);
+
+		while( match ){
+			size_t i = group*HASHMAP_GROUP + HASHMAP_INDEX(match);
+			char* slot = HASHMAP_SLOT(h, i);
+
+			GSTATS_ADD(h, comparisons, 1);
+			if( HASHMAP_LENGTH(slot) == size && !memcmp(hashmap_key(h, slot), key, size) )
+				return i;
+			match &= match - 1;
+		}
+
+		if( hashmap_match(control, HASHMAP_EMPTY) )
+			break;
+		group = (group + step + 1) & mask;
+	}
+
+	return h->capacity;
+}
+
+/*
+ * auxiliar function;
+ * the value mapped by `key`, in a new slot in case the key is
+ * not mapped yet
+ */
+void* hashmap_value_slot (hashmap_t* h, void* key, size_t size)
+{
+	uint64_t hash = h->hash(key, size);
+	size_t i = hashmap_find(h, key, size, hash);
+	if( i < h->capacity )
+		return HASHMAP_VALUE(h, HASHMAP_SLOT(h, i));
+
+	if( h->size + h->deleted + 1 > h->capacity - h->capacity/8 )
+		hashmap_rehash(h, hashmap_capacity_for(h->size + 1));
+
+	i = hashmap_find_free(h, hash);
+	if( h->control[i] == HASHMAP_DELETED )
+		h->deleted--;
+	h->control[i] = (unsigned char)(hash & 0x7F);
+
+	char* slot = HASHMAP_SLOT(h, i);
+	HASHMAP_LENGTH(slot) = size;
+	if( size > h->key_size ){
+		void* copy = GALLOC_ALLOC(h->allocator, size);
+		memcpy(copy, key, size);
+		*(void**)(slot + sizeof(size_t)) = copy;
+		GSTATS_ADD(h, allocations, 1);
+	}else if( size ){
+		memcpy(slot + sizeof(size_t), key, size);
+	}
+
+	h->size++;
+	GSTATS_PEAK(h, h->size);
+	return HASHMAP_VALUE(h, slot);
+}
+
+/** Adds the `elem` and maps it with the `key` with size `size`.
+  * This function overwrite any data left in the map mapped with
+  * key.
+  *
+  * @param h		pointer to the hash map structure;
+  * @param key		pointer to the bytes of the key;
+  * @param size		size of the key
+  * @param elem		pointer to the element to add
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `h` is a NULL
+  */
+gerror_t hashmap_add_element (hashmap_t* h, void* key, size_t size, void* elem)
+{
+	if(!h) return GERROR_NULL_STRUCTURE;
+
+	void* value = hashmap_value_slot(h, key, size);
+	if( h->member_size && elem )
+		memcpy(value, elem, h->member_size);
+
+	return GERROR_OK;
+}
+
+/** Returns the slot of the value mapped by `key`, that is added
+  * in case it is not mapped yet, so the value is written in place.
+  * The pointer is valid until the map rehashes, that is, until
+  * the next add or reserve.
+  *
+  * @param h		pointer to the hash map structure;
+  * @param key		pointer to the bytes of the key;
+  * @param size		size of the key
+  *
+  * @return	pointer to the value or NULL in case `h` is a
+  * 		NULL pointer
+  */
+void* hashmap_emplace (hashmap_t* h, void* key, size_t size)
+{
+	if(!h) return NULL;
+	return hashmap_value_slot(h, key, size);
+}
+
+/** Removes the element mapped by `key`.
+  *
+  * @param h		pointer to the hash map structure;
+  * @param key		pointer to the bytes of the key;
+  * @param size		size of the key.
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `h` is a NULL
+  * 		GERROR_ACCESS_OUT_OF_BOUND in case `key` is not
+  * 		mapped
+  */
+gerror_t hashmap_remove_element (hashmap_t* h, void* key, size_t size)
+{
+	if(!h) return GERROR_NULL_STRUCTURE;
+
+	size_t i = hashmap_find(h, key, size, h->hash(key, size));
+	if( i >= h->capacity ) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	char* slot = HASHMAP_SLOT(h, i);
+	if( size > h->key_size )
+		GALLOC_FREE(h->allocator, hashmap_key(h, slot), size);
+
+	/* no probe went past a group that still has an empty slot,
+	 * so the slot can be empty again */
+	if( hashmap_match(h->control + (i - i%HASHMAP_GROUP), HASHMAP_EMPTY) ){
+		h->control[i] = HASHMAP_EMPTY;
+	}else{
+		h->control[i] = HASHMAP_DELETED;
+		h->deleted++;
+	}
+	h->size--;
+
+	return GERROR_OK;
+}
+
+/** Returns the element mapped by `key`.
+  *
+  * @param h		pointer to the hash map structure;
+  * @param key		pointer to the bytes of the key;
+  * @param size		size of the key.
+  * @param elem		pointer to the memory allocated that
+  * 			will be write with the elem mapped by `key`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `h` is a NULL
+  * 		GERROR_ACCESS_OUT_OF_BOUND in case `key` is not
+  * 		mapped
+  */
+gerror_t hashmap_get_element (hashmap_t* h, void* key, size_t size, void* elem)
+{
+	if(!h) return GERROR_NULL_STRUCTURE;
+
+	void* value = hashmap_get_ref(h, key, size);
+	if( !value ) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	if( h->member_size && elem )
+		memcpy(elem, value, h->member_size);
+
+	return GERROR_OK;
+}
+
+/** Returns a pointer to the value mapped by `key`, without
+  * copying it. The pointer is valid until the map rehashes, that
+  * is, until the next add or reserve.
+  *
+  * @param h		pointer to the hash map structure;
+  * @param key		pointer to the bytes of the key;
+  * @param size		size of the key.
+  *
+  * @return	pointer to the value or NULL in case `key` is not
+  * 		mapped or `h` is a NULL pointer
+  */
+void* hashmap_get_ref (hashmap_t* h, void* key, size_t size)
+{
+	if(!h) return NULL;
+
+	size_t i = hashmap_find(h, key, size, h->hash(key, size));
+	if( i >= h->capacity ) return NULL;
+
+	return HASHMAP_VALUE(h, HASHMAP_SLOT(h, i));
+}
+
+/** Calls `visit` on every element of `h`, in the order of the
+  * table, with the key that maps it. `h` must not be changed
+  * during the walk. A non-zero return of `visit` stops the walk.
+  *
+  * @param h		pointer to the hash map structure;
+  * @param visit	function called on every element;
+  * @param argument	last argument of `visit`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `h` or `visit` is
+  * 		a NULL pointer
+  */
+gerror_t hashmap_foreach (hashmap_t* h, hashmap_visit_function visit, void* argument)
+{
+	if(!h || !visit) return GERROR_NULL_STRUCTURE;
+
+	size_t i;
+	for( i=0; i<h->capacity; i++ ){
+		if( h->control[i] & 0x80 ) continue;
+
+		char* slot = HASHMAP_SLOT(h, i);
+		if( visit(hashmap_key(h, slot), HASHMAP_LENGTH(slot), HASHMAP_VALUE(h, slot), argument) )
+			break;
+	}
+
+	return GERROR_OK;
+}
+
+/** Writes the counters of `h` in `stats`, see gstats.h. `nodes`
+  * is the number of slots and `depth` the most groups probed to
+  * reach an element.
+  *
+  * @param h		pointer to the hash map structure;
+  * @param stats	pointer to the structure that receives
+  * 			the counters
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCTURE in case `h` or `stats` is
+  * 		a NULL pointer
+  * 		GERROR_UNSUPPORTED_OPERATION in case the library
+  * 		was built without GENERICS_STATS
+  */
+gerror_t hashmap_get_stats (hashmap_t* h, gstats_t* stats)
+{
+	if(!h || !stats) return GERROR_NULL_STRUCTURE;
+
+#ifdef GENERICS_STATS
+	*stats = h->stats.counters;
+	stats->size = h->size;
+	stats->nodes = h->capacity;
+	stats->depth = 0;
+
+	size_t i, mask = h->capacity/HASHMAP_GROUP - 1;
+	for( i=0; i<h->capacity; i++ ){
+		if( h->control[i] & 0x80 ) continue;
+
+		char* slot = HASHMAP_SLOT(h, i);
+		uint64_t hash = h->hash(hashmap_key(h, slot), HASHMAP_LENGTH(slot));
+		size_t group = (size_t)(hash >> 7) & mask, step = 0;
+		while( group != i/HASHMAP_GROUP ){
+			step++;
+			group = (group + step) & mask;
+		}
+		if( step + 1 > stats->depth )
+			stats->depth = step + 1;
+	}
+	return GERROR_OK;
+#else
+	return GERROR_UNSUPPORTED_OPERATION;
+#endif
+}
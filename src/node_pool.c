@@ -0,0 +1,197 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#include "node_pool.h"
+
+#define NPOOL_SLAB_SIZE (1 << 16)
+#define NPOOL_MIN_BLOCKS_PER_SLAB 16
+#define NPOOL_SLAB_BYTES(p) (NPOOL_ALIGNMENT + (p)->blocks_per_slab*(p)->block_size)
+
+/** Populates the node pool pointed by `p`. Every block
+  * of the pool has room for a node header (`pnode_t`)
+  * plus `member_size` bytes of payload.
+  *
+  * @param p			pointer to a npool_t structure;
+  * @param member_size		size of the payload of every block;
+  * @param blocks_per_slab	number of blocks allocated at once,
+  * 				0 chooses a slab of about 64KiB.
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` is a NULL
+  * 		pointer
+  */
+gerror_t npool_create (struct npool_t* p, size_t member_size, size_t blocks_per_slab)
+{
+	return npool_create_with_allocator(p, member_size, blocks_per_slab, &galloc_default);
+}
+
+/** Populates the node pool pointed by `p` as `npool_create`
+  * does, but the slabs come from `allocator`.
+  *
+  * @param p			pointer to a npool_t structure;
+  * @param member_size		size of the payload of every block;
+  * @param blocks_per_slab	number of blocks allocated at once,
+  * 				0 chooses a slab of about 64KiB;
+  * @param allocator		allocator of the slabs
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` or `allocator`
+  * 		is a NULL pointer
+  */
+gerror_t npool_create_with_allocator (struct npool_t* p, size_t member_size, size_t blocks_per_slab,
+		const galloc_t* allocator)
+{
+	if(!p || !allocator) return GERROR_NULL_STRUCTURE;
+
+	p->member_size = member_size;
+	p->block_size = NPOOL_HEADER_SIZE + NPOOL_ALIGN(member_size);
+
+	if( !blocks_per_slab ){
+		blocks_per_slab = NPOOL_SLAB_SIZE/p->block_size;
+		if( blocks_per_slab < NPOOL_MIN_BLOCKS_PER_SLAB )
+			blocks_per_slab = NPOOL_MIN_BLOCKS_PER_SLAB;
+	}
+	p->blocks_per_slab = blocks_per_slab;
+
+	p->slabs = NULL;
+	p->free_list = NULL;
+	p->next_block = NULL;
+	p->remaining = 0;
+	p->allocator = allocator;
+
+	return GERROR_OK;
+}
+
+/** Releases every slab of the pool `p`, and so every block
+  * handed out by `p`, at once. This function WILL NOT
+  * deallocate the pointer `p`.
+  *
+  * @param p	pointer to a npool_t structure;
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` is a NULL
+  * 		pointer
+  */
+gerror_t npool_destroy (struct npool_t* p)
+{
+	if(!p) return GERROR_NULL_STRUCTURE;
+
+	void* i, *j;
+	for( i=p->slabs; i!=NULL; i=j ){
+		j = *(void**)i;
+		GALLOC_FREE(p->allocator, i, NPOOL_SLAB_BYTES(p));
+	}
+
+	p->slabs = NULL;
+	p->free_list = NULL;
+	p->next_block = NULL;
+	p->remaining = 0;
+
+	return GERROR_OK;
+}
+
+/** Returns a block of `p->block_size` bytes. The block comes
+  * from the free list when possible, otherwise it is carved
+  * from the current slab, allocating a new slab only when the
+  * current one is exhausted.
+  *
+  * @param p	pointer to a npool_t structure;
+  *
+  * @return	pointer to the block or NULL in case `p`
+  * 		is a NULL pointer.
+  */
+void* npool_alloc (struct npool_t* p)
+{
+	if(!p) return NULL;
+
+	void* block = p->free_list;
+	if( block ){
+		p->free_list = *(void**)block;
+		return block;
+	}
+
+	if( !p->remaining ){
+		void* slab = GALLOC_ALLOC(p->allocator, NPOOL_SLAB_BYTES(p));
+		*(void**)slab = p->slabs;
+		p->slabs = slab;
+		p->next_block = slab + NPOOL_ALIGNMENT;
+		p->remaining = p->blocks_per_slab;
+	}
+
+	block = p->next_block;
+	p->next_block += p->block_size;
+	p->remaining--;
+
+	return block;
+}
+
+/** Gives the `block` back to the pool `p`.
+  *
+  * @param p		pointer to a npool_t structure;
+  * @param block	block previous returned by `npool_alloc`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` is a NULL
+  * 		pointer
+  * 		GERROR_NULL_NODE in case `block` is NULL;
+  */
+gerror_t npool_free (struct npool_t* p, void* block)
+{
+	if(!p)		return GERROR_NULL_STRUCTURE;
+	if(!block)	return GERROR_NULL_NODE;
+
+	*(void**)block = p->free_list;
+	p->free_list = block;
+
+	return GERROR_OK;
+}
+
+/** Gives back to the pool `p` a whole chain of blocks in O(1).
+  * The blocks from `first` to `last` must be linked through
+  * their first word, as the `next` field of a `pnode_t` does.
+  *
+  * @param p		pointer to a npool_t structure;
+  * @param first	first block of the chain;
+  * @param last		last block of the chain
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` is a NULL
+  * 		pointer
+  * 		GERROR_NULL_NODE in case `first` or `last` is NULL;
+  */
+gerror_t npool_free_chain (struct npool_t* p, void* first, void* last)
+{
+	if(!p)			return GERROR_NULL_STRUCTURE;
+	if(!first || !last)	return GERROR_NULL_NODE;
+
+	*(void**)last = p->free_list;
+	p->free_list = first;
+
+	return GERROR_OK;
+}
+
+/** Calculates the pointer to the inline payload of `block`.
+  *
+  * @param block	block previous returned by `npool_alloc`
+  *
+  * @return	pointer to the first byte after the node header
+  */
+void* npool_payload (void* block)
+{
+	return block + NPOOL_HEADER_SIZE;
+}
@@ -19,13 +19,32 @@
 
 #include "priority_queue.h"
 
-#define PARENT(i) ((i-1)/2)
-#define LEFT(i)   (((i+1)*2)-1)
-#define RIGHT(i)  (LEFT(i)+1)
+#define PQUEUE_DEFAULT_ARITY 2
+
+#define PARENT(p, i)      (((i)-1)/(p)->arity)
+#define FIRST_CHILD(p, i) ((i)*(p)->arity + 1)
+
+#define AT(p, i)  ((p)->queue.data + (i)*(p)->member_size)
+
+#define NODE_ELEM(n)    ((char*)(n) + sizeof(pqueue_node_t))
+#define NODE_SIZE(p)    (sizeof(pqueue_node_t) + (p)->member_size)
+
+/*
+ * pqueue_add_n heapifies the whole heap instead of sifting up
+ * every new element when the batch has at least `size` divided
+ * by PQUEUE_HEAPIFY_RATIO elements
+ */
+#define PQUEUE_HEAPIFY_RATIO 1
 
-void nswap (void* a, void* b, size_t n);
 int default_compare_function(void* a, void* b, void* arg);
-void max_heapify(pqueue_t* p, size_t i);
+void pqueue_move(pqueue_t* p, size_t to, size_t from);
+void pqueue_place_scratch(pqueue_t* p, size_t i, size_t key);
+void pqueue_sift_up(pqueue_t* p, size_t i);
+void pqueue_sift_down(pqueue_t* p, size_t i);
+pqueue_node_t* pqueue_link(pqueue_t* p, pqueue_node_t* a, pqueue_node_t* b);
+pqueue_node_t* pqueue_merge_pairs(pqueue_t* p, pqueue_node_t* first);
+void pqueue_free_nodes(const galloc_t* allocator, pqueue_node_t* node, size_t size);
+gerror_t pqueue_stats_of(void* p, gstats_t* stats);
 
 /** Populates the `p` structure and inicialize it.
   * A priority queue needs a compare_function. The default function
@@ -48,11 +67,144 @@ void max_heapify(pqueue_t* p, size_t i);
   */
 gerror_t pqueue_create (pqueue_t* p, size_t member_size)
 {
-	if(!p) return GERROR_NULL_STRUCTURE;
+	return pqueue_create_with_allocator(p, member_size, &galloc_default);
+}
+
+/** Populates the `p` structure as `pqueue_create` does, but
+  * the heap and its auxiliar arrays come from `allocator`.
+  *
+  * @param p		previous allocated pqueue_t struct
+  * @param member_size	size in bytes of the indexed elements
+  * @param allocator	allocator of the heap
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` or `allocator`
+  * 		is a NULL pointer
+  */
+gerror_t pqueue_create_with_allocator (pqueue_t* p, size_t member_size, const galloc_t* allocator)
+{
+	if(!p || !allocator) return GERROR_NULL_STRUCTURE;
+	p->allocator = allocator;
+	p->size = 0;
 	p->member_size = member_size;
+	p->arity = PQUEUE_DEFAULT_ARITY;
 	p->compare = default_compare_function;
 	p->compare_argument = &p->member_size;
-	vector_create(&p->queue, 0, member_size);
+	p->scratch = GALLOC_ALLOC(p->allocator, member_size);
+	vector_create_with_allocator(&p->queue, 0, member_size, p->allocator);
+	p->n_keys = 0;
+	p->key_of = NULL;
+	p->position = NULL;
+	p->mode = PQUEUE_HEAP;
+	p->root = NULL;
+
+	GSTATS_UNREGISTER(&p->queue);
+	GSTATS_INIT(p);
+	GSTATS_ADD(p, allocations, 1);
+	GSTATS_REGISTER(p, "pqueue", pqueue_stats_of);
+	return GERROR_OK;
+}
+
+/** Populates the `p` structure as `pqueue_create` does, but the
+  * heap will be `arity`-ary instead of binary. For large heaps
+  * of small elements a 4-ary or 8-ary heap keeps all children
+  * of a node in the same cache line and halves the height, so a
+  * sift-down does less cache misses.
+  *
+  * @param p		previous allocated pqueue_t struct
+  * @param member_size	size in bytes of the indexed elements
+  * @param arity	number of children of each node, at least 2
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` is a NULL
+  * 		GERROR_INVALID_ARGUMENT in case `arity` is less than 2
+  */
+gerror_t pqueue_create_with_arity (pqueue_t* p, size_t member_size, size_t arity)
+{
+	if(arity < 2) return GERROR_INVALID_ARGUMENT;
+
+	gerror_t s = pqueue_create(p, member_size);
+	if(s != GERROR_OK) return s;
+
+	p->arity = arity;
+	return GERROR_OK;
+}
+
+/** Changes the number of children of each node of the heap `p`
+  * and rearranges the elements already in `p` in O(n).
+  *
+  * @param p		previous allocated pqueue_t struct
+  * @param arity	number of children of each node, at least 2
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` is a NULL
+  * 		GERROR_INVALID_ARGUMENT in case `arity` is less than 2
+  * 		GERROR_UNSUPPORTED_OPERATION in case `p` is a
+  * 		pairing heap
+  */
+gerror_t pqueue_set_arity (pqueue_t* p, size_t arity)
+{
+	if(!p) return GERROR_NULL_STRUCTURE;
+	if(arity < 2) return GERROR_INVALID_ARGUMENT;
+	if(p->mode == PQUEUE_PAIRING) return GERROR_UNSUPPORTED_OPERATION;
+
+	p->arity = arity;
+	return pqueue_heapify(p);
+}
+
+/** Populates the `p` structure with the `n` elements of `array`
+  * and turns them in a heap in O(n) with Floyd's algorithm, what
+  * is cheaper than `n` calls of `pqueue_add`.
+  *
+  * @param p		previous allocated pqueue_t struct
+  * @param member_size	size in bytes of the indexed elements
+  * @param array	pointer to `n` contiguous elements
+  * @param n		number of elements in `array`
+  * @param function	comparison function, see
+  * 			`pqueue_set_compare_function`, or NULL
+  * 			for the default comparison function
+  * @param argument	argument of `function`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` is a NULL
+  */
+gerror_t pqueue_create_from_array (pqueue_t* p, size_t member_size, void* array, size_t n,
+		compare_function function, void* argument)
+{
+	gerror_t s = pqueue_create(p, member_size);
+	if(s != GERROR_OK) return s;
+
+	if(function)
+		pqueue_set_compare_function(p, function, argument);
+
+	vector_reserve(&p->queue, n);
+	vector_append_n(&p->queue, array, n);
+	return pqueue_heapify(p);
+}
+
+/** Restores the heap property of all the elements of `p` in O(n).
+  * It may be used after changing the priorities in the buffer
+  * `p->queue` or after replacing the comparison function.
+  *
+  * @param p	previous allocated pqueue_t struct
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` is a NULL
+  * 		GERROR_UNSUPPORTED_OPERATION in case `p` is a
+  * 		pairing heap
+  */
+gerror_t pqueue_heapify (pqueue_t* p)
+{
+	if(!p) return GERROR_NULL_STRUCTURE;
+	if(p->mode == PQUEUE_PAIRING) return GERROR_UNSUPPORTED_OPERATION;
+
+	p->size = p->queue.size;
+	if(p->size < 2) return GERROR_OK;
+
+	size_t i;
+	for( i=PARENT(p, p->size-1)+1; i>0; i-- )
+		pqueue_sift_down(p, i-1);
+
 	return GERROR_OK;
 }
 
@@ -66,11 +218,22 @@ gerror_t pqueue_create (pqueue_t* p, size_t member_size)
 gerror_t pqueue_destroy (pqueue_t* p)
 {
 	if(!p) return GERROR_NULL_STRUCTURE;
+	GSTATS_UNREGISTER(p);
+	pqueue_free_nodes(p->allocator, p->root, NODE_SIZE(p));
+	p->root = NULL;
+	GALLOC_FREE(p->allocator, p->scratch, p->member_size);
+	p->scratch = NULL;
 	p->size = 0;
 	p->member_size = 0;
 	p->compare = NULL;
 	p->compare_argument = NULL;
 	vector_destroy(&p->queue);
+	if(p->position){
+		GALLOC_FREE(p->allocator, p->key_of, sizeof(size_t)*(p->n_keys? p->n_keys : 1));
+		GALLOC_FREE(p->allocator, p->position, sizeof(size_t)*(p->n_keys? p->n_keys : 1));
+		p->key_of = p->position = NULL;
+	}
+	p->n_keys = 0;
 	return GERROR_OK;
 }
 
@@ -106,28 +269,29 @@ gerror_t pqueue_set_compare_function (pqueue_t* p, compare_function function, vo
   *
   * @return	GERROR_OK in case of success operation;
   * 		GERROR_NULL_STRUCURE in case `t` is a NULL
+  * 		GERROR_UNSUPPORTED_OPERATION in case `p` is
+  * 		indexed, see `pqueue_add_indexed`
   */
 gerror_t pqueue_add (pqueue_t* p, void* e)
 {
 	if(!p) return GERROR_NULL_STRUCTURE;
+	if(p->position) return GERROR_UNSUPPORTED_OPERATION;
+
+	if(p->mode == PQUEUE_PAIRING){
+		pqueue_node_t* node = (pqueue_node_t*) GALLOC_ALLOC(p->allocator, NODE_SIZE(p));
+		node->child = node->sibling = NULL;
+		memcpy(NODE_ELEM(node), e, p->member_size);
+
+		p->root = pqueue_link(p, p->root, node);
+		p->size++;
+		GSTATS_ADD(p, allocations, 1);
+		GSTATS_PEAK(p, p->size);
+		return GERROR_OK;
+	}
 
 	vector_add( &p->queue, e );
 	p->size = p->queue.size;
-	size_t i = p->size - 1;
-
-	if(i>0){
-		void* child, *parent;
-		do{
-			child = vector_ptr_at(&p->queue, i),
-			parent = vector_ptr_at(&p->queue, PARENT(i));
-			queue_priority_t priority;
-			priority = p->compare(child, parent, p->compare_argument);
-			
-			if (i>0 && priority == G_PQUEUE_FIRST_PRIORITY)
-				nswap(child, parent, p->member_size);
-			i = PARENT(i);
-		}while ( i > 0 && i < p->size );
-	}
+	pqueue_sift_up(p, p->size - 1);
 
 	return GERROR_OK;
 }
@@ -148,7 +312,10 @@ gerror_t pqueue_max_priority (pqueue_t* p, void* e)
 {
 	if(!p) return GERROR_NULL_STRUCTURE;
 	if(p->size == 0) return GERROR_ACCESS_OUT_OF_BOUND;
-	vector_at( &p->queue, 0, e );
+	if(p->mode == PQUEUE_PAIRING)
+		memcpy(e, NODE_ELEM(p->root), p->member_size);
+	else
+		vector_at( &p->queue, 0, e );
 	return GERROR_OK;
 }
 
@@ -163,33 +330,524 @@ gerror_t pqueue_max_priority (pqueue_t* p, void* e)
   * 		GERROR_NULL_STRUCURE in case `t` is a NULL
   */
 gerror_t pqueue_extract (pqueue_t* p, void* e)
+{
+	return pqueue_extract_indexed(p, e, NULL);
+}
+
+/** Returns a pointer to the highest priority element of the
+  * queue, without copying or removing it. The element must not
+  * be changed in a way that changes its priority; the pointer is
+  * valid until the queue is changed.
+  *
+  * @param p	previous allocated pqueue_t struct
+  *
+  * @return	pointer to the element or NULL in case `p` is a
+  * 		NULL pointer or is empty
+  */
+void* pqueue_top_ptr (pqueue_t* p)
+{
+	if(!p || p->size == 0) return NULL;
+	if(p->mode == PQUEUE_PAIRING) return NODE_ELEM(p->root);
+	return AT(p, 0);
+}
+
+/** Reserves the slot of a new element at the end of the heap
+  * and returns it, so the caller builds the element in place
+  * instead of copying it from a temporary. The element only
+  * enters the queue with `pqueue_emplace_commit`, that must be
+  * called before any other operation on `p`.
+  *
+  * @param p	previous allocated pqueue_t struct
+  *
+  * @return	pointer to the slot of the new element or NULL in
+  * 		case `p` is a NULL pointer, is indexed or is a
+  * 		pairing heap
+  */
+void* pqueue_emplace (pqueue_t* p)
+{
+	if(!p || p->position || p->mode == PQUEUE_PAIRING) return NULL;
+
+	vector_append_n(&p->queue, NULL, 1);
+	return AT(p, p->queue.size - 1);
+}
+
+/** Adds to the queue the element written in the slot given by
+  * `pqueue_emplace`.
+  *
+  * @param p	previous allocated pqueue_t struct
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` is a NULL
+  * 		GERROR_UNSUPPORTED_OPERATION in case no slot
+  * 		was reserved by `pqueue_emplace`
+  */
+gerror_t pqueue_emplace_commit (pqueue_t* p)
+{
+	if(!p) return GERROR_NULL_STRUCTURE;
+	if(p->queue.size != p->size + 1) return GERROR_UNSUPPORTED_OPERATION;
+
+	p->size = p->queue.size;
+	pqueue_sift_up(p, p->size - 1);
+
+	return GERROR_OK;
+}
+
+/** Adds the `n` contiguous elements of `elems` in the queue at
+  * once. A batch of at least the size of the heap is appended
+  * and the heap rebuilt in O(n), a smaller one is sifted up
+  * element by element.
+  *
+  * @param p	previous allocated pqueue_t struct
+  * @param elems	pointer to `n` contiguous elements
+  * @param n	number of elements in `elems`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` or `elems` is a
+  * 		NULL pointer
+  * 		GERROR_UNSUPPORTED_OPERATION in case `p` is
+  * 		indexed, see `pqueue_add_indexed`
+  */
+gerror_t pqueue_add_n (pqueue_t* p, void* elems, size_t n)
+{
+	if(!p || (!elems && n)) return GERROR_NULL_STRUCTURE;
+	if(p->position) return GERROR_UNSUPPORTED_OPERATION;
+
+	size_t i, old = p->size;
+
+	if(p->mode == PQUEUE_PAIRING){
+		for( i=0; i<n; i++ )
+			pqueue_add(p, (char*) elems + i*p->member_size);
+		return GERROR_OK;
+	}
+
+	vector_append_n(&p->queue, elems, n);
+	if( n*PQUEUE_HEAPIFY_RATIO >= old )
+		return pqueue_heapify(p);
+
+	p->size = p->queue.size;
+	for( i=old; i<p->size; i++ )
+		pqueue_sift_up(p, i);
+
+	return GERROR_OK;
+}
+
+/** Extracts the `n` highest priority elements of the queue, or
+  * all of them in case it has less, and writes them in `elems`
+  * in priority order.
+  *
+  * @param p	previous allocated pqueue_t struct
+  * @param elems	pointer to room for `n` contiguous elements
+  * 		or NULL to drop them
+  * @param n	number of elements to extract
+  * @param count	pointer that receives the number of
+  * 		extracted elements or NULL
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` is a NULL
+  * 		GERROR_UNSUPPORTED_OPERATION in case `p` is
+  * 		indexed, see `pqueue_extract_indexed`
+  */
+gerror_t pqueue_extract_n (pqueue_t* p, void* elems, size_t n, size_t* count)
+{
+	if(!p) return GERROR_NULL_STRUCTURE;
+	if(p->position) return GERROR_UNSUPPORTED_OPERATION;
+
+	if( n > p->size )
+		n = p->size;
+
+	size_t i;
+	for( i=0; i<n; i++ )
+		pqueue_extract_indexed(p, elems? (char*) elems + i*p->member_size : NULL, NULL);
+
+	if(count) *count = n;
+	return GERROR_OK;
+}
+
+/*
+ * auxiliar function;
+ * compares the elements of the heap at the indices `a` and `b`,
+ * for the frontier of `pqueue_top_k`
+ */
+int pqueue_index_compare (void* a, void* b, void* arg)
+{
+	pqueue_t* p = (pqueue_t*) arg;
+	return p->compare(AT(p, *(size_t*)a), AT(p, *(size_t*)b), p->compare_argument);
+}
+
+/*
+ * auxiliar function;
+ * compares the elements of the nodes `a` and `b`, for the
+ * frontier of `pqueue_top_k`
+ */
+int pqueue_node_compare (void* a, void* b, void* arg)
+{
+	pqueue_t* p = (pqueue_t*) arg;
+	return p->compare(	NODE_ELEM(*(pqueue_node_t**)a),
+				NODE_ELEM(*(pqueue_node_t**)b), p->compare_argument );
+}
+
+/** Writes in `elems` the `k` highest priority elements of the
+  * queue, or all of them in case it has less, in priority
+  * order, without removing them. It walks the heap from the top
+  * through a frontier of the children of the nodes already
+  * written, so the queue is not changed: O(k log k) for a heap
+  * and O(k d log(k d)) for a pairing heap whose nodes have up to
+  * d children.
+  *
+  * @param p	previous allocated pqueue_t struct
+  * @param elems	pointer to room for `k` contiguous elements
+  * @param k	number of elements to write
+  * @param count	pointer that receives the number of
+  * 		written elements or NULL
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` or `elems` is a
+  * 		NULL pointer
+  */
+gerror_t pqueue_top_k (pqueue_t* p, void* elems, size_t k, size_t* count)
+{
+	if(!p || !elems) return GERROR_NULL_STRUCTURE;
+
+	if( k > p->size )
+		k = p->size;
+	if(count) *count = k;
+	if( !k ) return GERROR_OK;
+
+	pqueue_t frontier;
+	size_t i, j;
+
+	gerror_t s = pqueue_create_with_allocator(&frontier,
+			p->mode == PQUEUE_PAIRING? sizeof(pqueue_node_t*) : sizeof(size_t), p->allocator);
+	if(s != GERROR_OK) return s;
+	GSTATS_UNREGISTER(&frontier);
+
+	if(p->mode == PQUEUE_PAIRING){
+		pqueue_node_t* node = p->root;
+
+		pqueue_set_compare_function(&frontier, pqueue_node_compare, p);
+		pqueue_add(&frontier, &node);
+
+		for( i=0; i<k; i++ ){
+			pqueue_node_t* child;
+			pqueue_extract(&frontier, &node);
+			memcpy((char*) elems + i*p->member_size, NODE_ELEM(node), p->member_size);
+			for( child=node->child; child; child=child->sibling )
+				pqueue_add(&frontier, &child);
+		}
+	}else{
+		size_t index = 0;
+
+		pqueue_set_compare_function(&frontier, pqueue_index_compare, p);
+		pqueue_add(&frontier, &index);
+
+		for( i=0; i<k; i++ ){
+			pqueue_extract(&frontier, &index);
+			memcpy((char*) elems + i*p->member_size, AT(p, index), p->member_size);
+			for( j=FIRST_CHILD(p, index); j<FIRST_CHILD(p, index) + p->arity && j<p->size; j++ )
+				pqueue_add(&frontier, &j);
+		}
+	}
+
+	GSTATS_ADD(p, comparisons, frontier.stats.counters.comparisons);
+	pqueue_destroy(&frontier);
+	return GERROR_OK;
+}
+
+/** Populates the `p` structure as `pqueue_create` does, but the
+  * elements are kept in the nodes of a pairing heap: an add and
+  * a merge with `pqueue_merge` take O(1), an extract O(log n)
+  * amortized. It has no arity, no heapify and no emplace.
+  *
+  * @param p		previous allocated pqueue_t struct
+  * @param member_size	size in bytes of the indexed elements
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` is a NULL
+  */
+gerror_t pqueue_create_pairing (pqueue_t* p, size_t member_size)
+{
+	return pqueue_create_pairing_with_allocator(p, member_size, &galloc_default);
+}
+
+/** Populates the `p` structure as `pqueue_create_pairing` does,
+  * but the nodes come from `allocator`.
+  *
+  * @param p		previous allocated pqueue_t struct
+  * @param member_size	size in bytes of the indexed elements
+  * @param allocator	allocator of the nodes
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` or `allocator`
+  * 		is a NULL pointer
+  */
+gerror_t pqueue_create_pairing_with_allocator (pqueue_t* p, size_t member_size,
+		const galloc_t* allocator)
+{
+	gerror_t s = pqueue_create_with_allocator(p, member_size, allocator);
+	if(s != GERROR_OK) return s;
+
+	p->mode = PQUEUE_PAIRING;
+	return GERROR_OK;
+}
+
+/** Moves all the elements of `other` to `p`, leaving `other`
+  * empty. Two pairing heaps on the same allocator merge in O(1)
+  * by linking their roots; otherwise the elements of `other`
+  * are added to `p`, the heap of a batch in O(n). Both queues
+  * must order the elements by the same compare function.
+  *
+  * @param p		previous allocated pqueue_t struct
+  * @param other	queue whose elements are moved to `p`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` or `other` is a
+  * 		NULL pointer
+  * 		GERROR_INVALID_ARGUMENT in case the elements of
+  * 		`p` and `other` have different sizes or they are
+  * 		the same queue
+  * 		GERROR_UNSUPPORTED_OPERATION in case `p` or
+  * 		`other` is indexed
+  */
+gerror_t pqueue_merge (pqueue_t* p, pqueue_t* other)
+{
+	if(!p || !other) return GERROR_NULL_STRUCTURE;
+	if(p == other || p->member_size != other->member_size) return GERROR_INVALID_ARGUMENT;
+	if(p->position || other->position) return GERROR_UNSUPPORTED_OPERATION;
+
+	if(other->mode == PQUEUE_HEAP){
+		pqueue_add_n(p, other->queue.data, other->size);
+		other->queue.size = other->size = 0;
+		return GERROR_OK;
+	}
+
+	if(p->mode == PQUEUE_PAIRING && p->allocator == other->allocator){
+		p->root = pqueue_link(p, p->root, other->root);
+		p->size += other->size;
+		GSTATS_PEAK(p, p->size);
+	}else{
+		/* the nodes of `other` go back to its own allocator */
+		pqueue_node_t* node = other->root;
+		while(node){
+			if(node->child){
+				pqueue_node_t* child = node->child;
+				node->child = child->sibling;
+				child->sibling = node->sibling;
+				node->sibling = child;
+				continue;
+			}
+			pqueue_node_t* next = node->sibling;
+			pqueue_add(p, NODE_ELEM(node));
+			GALLOC_FREE(other->allocator, node, NODE_SIZE(other));
+			node = next;
+		}
+	}
+
+	other->root = NULL;
+	other->size = 0;
+	return GERROR_OK;
+}
+
+/** Populates the `p` structure as an indexed priority queue,
+  * where every element has a key from 0 to `n_keys - 1` and
+  * the priority of the element of a key can be raised with
+  * `pqueue_decrease_key`. The heap keeps at most one element per
+  * key, so it never holds more than `n_keys` elements.
+  *
+  * @param p		previous allocated pqueue_t struct
+  * @param member_size	size in bytes of the indexed elements
+  * @param n_keys	number of keys
+  * @param function	comparison function, see
+  * 			`pqueue_set_compare_function`, or NULL
+  * 			for the default comparison function
+  * @param argument	argument of `function`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` is a NULL
+  */
+gerror_t pqueue_create_indexed (pqueue_t* p, size_t member_size, size_t n_keys,
+		compare_function function, void* argument)
+{
+	gerror_t s = pqueue_create(p, member_size);
+	if(s != GERROR_OK) return s;
+
+	if(function)
+		pqueue_set_compare_function(p, function, argument);
+
+	p->n_keys = n_keys;
+	p->key_of = (size_t*) GALLOC_ALLOC(p->allocator, sizeof(size_t)*(n_keys? n_keys : 1));
+	p->position = (size_t*) GALLOC_ALLOC(p->allocator, sizeof(size_t)*(n_keys? n_keys : 1));
+	GSTATS_ADD(p, allocations, 2);
+
+	size_t i;
+	for(i=0; i<n_keys; i++)
+		p->position[i] = PQUEUE_NO_POSITION;
+
+	vector_reserve(&p->queue, n_keys);
+	return GERROR_OK;
+}
+
+/** Adds the element `e` with the key `key` in the indexed
+  * priority queue `p`.
+  *
+  * @param p	previous allocated pqueue_t struct
+  * @param key	key of the element, lower than `n_keys`
+  * @param e	the element to be added
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` is a NULL
+  * 		GERROR_UNSUPPORTED_OPERATION in case `p` is
+  * 		not indexed
+  * 		GERROR_INVALID_ARGUMENT in case `key` is out
+  * 		of range or already in `p`
+  */
+gerror_t pqueue_add_indexed (pqueue_t* p, size_t key, void* e)
+{
+	if(!p) return GERROR_NULL_STRUCTURE;
+	if(!p->position) return GERROR_UNSUPPORTED_OPERATION;
+	if(key >= p->n_keys || p->position[key] != PQUEUE_NO_POSITION)
+		return GERROR_INVALID_ARGUMENT;
+
+	vector_add( &p->queue, e );
+	p->size = p->queue.size;
+
+	p->key_of[p->size - 1] = key;
+	p->position[key] = p->size - 1;
+	pqueue_sift_up(p, p->size - 1);
+
+	return GERROR_OK;
+}
+
+/** Replaces the element of the key `key` by `e`, that must have
+  * the same or a higher priority, and moves it to its new place
+  * in O(log n).
+  *
+  * @param p	previous allocated pqueue_t struct
+  * @param key	key of the element
+  * @param e	the new element of `key`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` is a NULL
+  * 		GERROR_UNSUPPORTED_OPERATION in case `p` is
+  * 		not indexed
+  * 		GERROR_ACCESS_OUT_OF_BOUND in case `key` is
+  * 		not in `p`
+  * 		GERROR_INVALID_ARGUMENT in case `e` has less
+  * 		priority than the element of `key`
+  */
+gerror_t pqueue_decrease_key (pqueue_t* p, size_t key, void* e)
+{
+	if(!p) return GERROR_NULL_STRUCTURE;
+	if(!p->position) return GERROR_UNSUPPORTED_OPERATION;
+	if(!pqueue_contains_key(p, key)) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	size_t i = p->position[key];
+	GSTATS_ADD(p, comparisons, 1);
+	if( p->compare(e, AT(p, i), p->compare_argument) == G_PQUEUE_SECOND_PRIORITY )
+		return GERROR_INVALID_ARGUMENT;
+
+	memcpy(AT(p, i), e, p->member_size);
+	pqueue_sift_up(p, i);
+
+	return GERROR_OK;
+}
+
+/** Extracts the highest priority element in the queue and
+  * writes in `e` pointer and its key in `key`, in case `p`
+  * is indexed.
+  *
+  * @param p	previous allocated pqueue_t struct
+  * @param e	pointer to previous allocated variable or NULL
+  * @param key	pointer that will be write with the key of
+  * 		the element or NULL
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_ACESS_OUT_OF_BOUND in case the queue is empty
+  * 		GERROR_NULL_STRUCURE in case `t` is a NULL
+  */
+gerror_t pqueue_extract_indexed (pqueue_t* p, void* e, size_t* key)
 {
 	if(!p) return GERROR_NULL_STRUCTURE;
 	if(p->size == 0) return GERROR_ACCESS_OUT_OF_BOUND;
 
-	vector_at( &p->queue, 0, e );
-	void* ptr = vector_ptr_at( &p->queue, p->size-1 );
-	vector_set_elem_at( &p->queue, 0, ptr );
+	if(p->mode == PQUEUE_PAIRING){
+		pqueue_node_t* top = p->root;
+		if(e) memcpy(e, NODE_ELEM(top), p->member_size);
 
-	vector_resize_buffer( &p->queue, p->size-1 );
+		p->root = pqueue_merge_pairs(p, top->child);
+		p->size--;
+		GALLOC_FREE(p->allocator, top, NODE_SIZE(p));
+		return GERROR_OK;
+	}
+
+	if(e) memcpy(e, AT(p, 0), p->member_size);
+
+	if(p->position){
+		if(key) *key = p->key_of[0];
+		p->position[p->key_of[0]] = PQUEUE_NO_POSITION;
+	}
+
+	p->queue.size--;
 	p->size = p->queue.size;
 
-	max_heapify( p, 0 );
-	
+	if(p->size){
+		memcpy(AT(p, 0), AT(p, p->size), p->member_size);
+		if(p->position){
+			p->key_of[0] = p->key_of[p->size];
+			p->position[p->key_of[0]] = 0;
+		}
+		pqueue_sift_down( p, 0 );
+	}
+
 	return GERROR_OK;
 }
 
+/** Returns non-zero in case the key `key` has an element in
+  * the indexed priority queue `p`.
+  */
+int pqueue_contains_key (pqueue_t* p, size_t key)
+{
+	return	p && p->position && key < p->n_keys &&
+		p->position[key] != PQUEUE_NO_POSITION;
+}
+
+/** Writes the counters of `p` in `stats`, see gstats.h, with
+  * the counters of its vector.
+  *
+  * @param p		previous allocated pqueue_t struct
+  * @param stats	pointer to the structure that receives
+  * 			the counters
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` or `stats` is NULL
+  * 		GERROR_UNSUPPORTED_OPERATION in case the library
+  * 		was built without GENERICS_STATS
+  */
+gerror_t pqueue_get_stats (pqueue_t* p, gstats_t* stats)
+{
+	if(!p || !stats) return GERROR_NULL_STRUCTURE;
+
+#ifdef GENERICS_STATS
+	*stats = p->stats.counters;
+	stats->size = p->size;
+	if(p->mode == PQUEUE_PAIRING){
+		stats->nodes = p->size;
+		return GERROR_OK;
+	}
+	stats->peak_size = p->queue.stats.counters.peak_size;
+	gstats_merge(stats, &p->queue.stats.counters);
+	return GERROR_OK;
+#else
+	return GERROR_UNSUPPORTED_OPERATION;
+#endif
+}
+
 /*
- * auxiliar function to swap n bytes in
- * a to b
+ * auxiliar function;
+ * `pqueue_get_stats` for the registry
  */
-void nswap (void* a, void* b, size_t n)
+gerror_t pqueue_stats_of (void* p, gstats_t* stats)
 {
-	void* cup = malloc(n);
-	memcpy(cup, a, n);
-	memcpy(a, b, n);
-	memcpy(b, cup, n);
-	free(cup);
+	return pqueue_get_stats((pqueue_t*) p, stats);
 }
 
 /*
@@ -221,36 +879,167 @@ int default_compare_function(void* a, void* b, void* arg)
 }
 
 /*
- * classical heapify algorithm
+ * moves the element at `from` to the hole at `to`,
+ * with its key in case `p` is indexed
  */
-void max_heapify(pqueue_t* p, size_t i)
+void pqueue_move (pqueue_t* p, size_t to, size_t from)
 {
-	size_t left = LEFT(i);
-	size_t right = RIGHT(i);
-	size_t largest;
+	memcpy(AT(p, to), AT(p, from), p->member_size);
+	if(p->position){
+		p->key_of[to] = p->key_of[from];
+		p->position[p->key_of[to]] = to;
+	}
+}
 
-	void* ptr_i = vector_ptr_at(&p->queue, i);
-	void* pleft = vector_ptr_at(&p->queue, left);
-	void* pright = vector_ptr_at(&p->queue, right);
-	void* plargest;
+/*
+ * puts the element waiting in the scratch slot, whose
+ * key is `key`, in the hole at `i`
+ */
+void pqueue_place_scratch (pqueue_t* p, size_t i, size_t key)
+{
+	memcpy(AT(p, i), p->scratch, p->member_size);
+	if(p->position){
+		p->key_of[i] = key;
+		p->position[key] = i;
+	}
+}
 
-	if( left < p->size &&
-	    p->compare(pleft, ptr_i, p->compare_argument) == G_PQUEUE_FIRST_PRIORITY ) {
-		largest = left;
-		plargest = pleft;
-	}else{
-		largest = i;
-		plargest = ptr_i;
+/*
+ * moves the element at `i` up to its place. The element waits in
+ * the scratch slot while its ancestors with less priority move down
+ * into the hole, so a sift does no swap and no allocation.
+ */
+void pqueue_sift_up (pqueue_t* p, size_t i)
+{
+	size_t key = p->position? p->key_of[i] : 0;
+	memcpy(p->scratch, AT(p, i), p->member_size);
+
+	while( i > 0 ){
+		size_t parent = PARENT(p, i);
+		GSTATS_ADD(p, comparisons, 1);
+		if( p->compare(p->scratch, AT(p, parent), p->compare_argument)
+				!= G_PQUEUE_FIRST_PRIORITY )
+			break;
+
+		pqueue_move(p, i, parent);
+		i = parent;
+	}
+
+	pqueue_place_scratch(p, i, key);
+}
+
+/*
+ * moves the element at `i` down to its place, iteratively. The
+ * children with more priority move up into the hole while the
+ * element waits in the scratch slot.
+ */
+void pqueue_sift_down (pqueue_t* p, size_t i)
+{
+	size_t key = p->position? p->key_of[i] : 0;
+	memcpy(p->scratch, AT(p, i), p->member_size);
+
+	for(;;){
+		size_t first = FIRST_CHILD(p, i);
+		if( first >= p->size )
+			break;
+
+		size_t last = first + p->arity;
+		if( last > p->size )
+			last = p->size;
+
+		size_t j, child = first;
+		GSTATS_ADD(p, comparisons, last - first);
+		for( j=first+1; j<last; j++ )
+			if( p->compare(AT(p, j), AT(p, child), p->compare_argument)
+					== G_PQUEUE_FIRST_PRIORITY )
+				child = j;
+
+		if( p->compare(AT(p, child), p->scratch, p->compare_argument)
+				!= G_PQUEUE_FIRST_PRIORITY )
+			break;
+
+		pqueue_move(p, i, child);
+		i = child;
+	}
+
+	pqueue_place_scratch(p, i, key);
+}
+
+/*
+ * auxiliar function;
+ * links the roots of two pairing heaps: the one with less
+ * priority becomes the first child of the other
+ */
+pqueue_node_t* pqueue_link (pqueue_t* p, pqueue_node_t* a, pqueue_node_t* b)
+{
+	if(!a) return b;
+	if(!b) return a;
+
+	GSTATS_ADD(p, comparisons, 1);
+	if( p->compare(NODE_ELEM(b), NODE_ELEM(a), p->compare_argument) == G_PQUEUE_FIRST_PRIORITY ){
+		pqueue_node_t* swap = a;
+		a = b;
+		b = swap;
+	}
+
+	b->sibling = a->child;
+	a->child = b;
+	return a;
+}
+
+/*
+ * auxiliar function;
+ * merges the list of siblings from `first` in a single heap, in
+ * two passes: links them in pairs from left to right, then links
+ * the pairs from right to left
+ */
+pqueue_node_t* pqueue_merge_pairs (pqueue_t* p, pqueue_node_t* first)
+{
+	pqueue_node_t* pairs = NULL, *root = NULL;
+
+	/* `pairs` is linked by the siblings in the reverse order */
+	while(first){
+		pqueue_node_t* a = first, *b = first->sibling;
+		first = b? b->sibling : NULL;
+
+		a->sibling = NULL;
+		if(b){
+			b->sibling = NULL;
+			a = pqueue_link(p, a, b);
+		}
+		a->sibling = pairs;
+		pairs = a;
 	}
 
-	if( right < p->size &&
-	    p->compare(pright, plargest, p->compare_argument) == G_PQUEUE_FIRST_PRIORITY){
-		largest = right;
-		plargest = pright;
+	while(pairs){
+		pqueue_node_t* next = pairs->sibling;
+		pairs->sibling = NULL;
+		root = pqueue_link(p, root, pairs);
+		pairs = next;
 	}
 
-	if( largest != i ){
-		nswap(ptr_i, plargest, p->member_size);
-		max_heapify(p, largest);
+	return root;
+}
+
+/*
+ * auxiliar function;
+ * frees the nodes of `size` bytes of the heap from `node`
+ * without recursion: the children are moved to the list of
+ * siblings, one at a time, before their parent is freed
+ */
+void pqueue_free_nodes (const galloc_t* allocator, pqueue_node_t* node, size_t size)
+{
+	while(node){
+		if(node->child){
+			pqueue_node_t* child = node->child;
+			node->child = child->sibling;
+			child->sibling = node->sibling;
+			node->sibling = child;
+			continue;
+		}
+
+		pqueue_node_t* next = node->sibling;
+		GALLOC_FREE(allocator, node, size);
+		node = next;
 	}
 }
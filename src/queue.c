@@ -18,6 +18,78 @@
  */
 #include "queue.h"
 
+#define QUEUE_RING_MIN_CAPACITY 16
+
+/*
+ * auxiliar function;
+ * pointer to the slot `i` positions after the first
+ * element of a ring queue
+ */
+void* queue_ring_slot (struct queue_t* q, size_t i)
+{
+	return q->buffer + ((q->first + i) & (q->capacity - 1))*q->member_size;
+}
+
+/*
+ * auxiliar function;
+ * copies the element of a unlinked `node` to `e` and
+ * deallocates the node. The node of an intrusive queue
+ * belongs to the caller, `e` receives its container.
+ */
+void queue_release_node (struct queue_t* q, struct qnode_t* node, void* e)
+{
+	if(q->mode == QUEUE_INTRUSIVE){
+		if(e) *(void**) e = node->data;
+		return;
+	}
+
+	if(q->member_size && e)
+		memcpy(e, node->data, q->member_size);
+
+	if(q->pool){
+		npool_free(q->pool, node);
+	}else{
+		if(node->data)
+			GALLOC_FREE(q->allocator, node->data, q->member_size);
+		GALLOC_FREE(q->allocator, node, sizeof(qnode_t));
+	}
+}
+
+/*
+ * auxiliar function;
+ * doubles the capacity of a full ring queue. The elements
+ * that wrapped around the end of the buffer are moved after
+ * the old end, so the queue stays contiguous from `first`.
+ */
+void queue_ring_grow (struct queue_t* q)
+{
+	size_t old_capacity = q->capacity;
+	q->capacity = old_capacity*2;
+
+	if(!q->member_size) return;
+
+	q->buffer = GALLOC_REALLOC(q->allocator, q->buffer,
+			old_capacity*q->member_size, q->capacity*q->member_size);
+	GSTATS_ADD(q, reallocations, 1);
+	GSTATS_ADD(q, bytes_moved, old_capacity*q->member_size);
+	if( q->first + q->size > old_capacity ){
+		size_t wrapped = q->first + q->size - old_capacity;
+		memcpy(	q->buffer + old_capacity*q->member_size,
+			q->buffer,
+			wrapped*q->member_size );
+		GSTATS_ADD(q, bytes_moved, wrapped*q->member_size);
+	}
+}
+
+/*
+ * auxiliar function;
+ * `queue_get_stats` for the registry
+ */
+gerror_t queue_stats_of (void* q, gstats_t* stats)
+{
+	return queue_get_stats((struct queue_t*) q, stats);
+}
+
 /** Creates a queue and populates the previous
   * allocated structure pointed by `q`;
   *
@@ -31,18 +103,157 @@
   */
 gerror_t queue_create(struct queue_t* q, size_t member_size)
 {
-	if(!q) return GERROR_NULL_STRUCTURE;
+	return queue_create_with_allocator(q, member_size, &galloc_default);
+}
+
+/** Creates a queue as `queue_create` does, but its nodes come
+  * from `allocator`, and populates the previous allocated
+  * structure pointed by `q`;
+  *
+  * @param q		pointer to a queue structure;
+  * @param member_size	size of the elements that will be
+  * 			indexed by `q`
+  * @param allocator	allocator of the nodes
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `q` or `allocator`
+  * 		is a NULL pointer
+  */
+gerror_t queue_create_with_allocator(struct queue_t* q, size_t member_size, const galloc_t* allocator)
+{
+	if(!q || !allocator) return GERROR_NULL_STRUCTURE;
 
 	q->member_size = member_size;
 	q->size = 0;
 	q->head = NULL;
 	q->tail = NULL;
 
+	q->mode = QUEUE_LIST;
+	q->buffer = NULL;
+	q->capacity = 0;
+	q->first = 0;
+	q->link_offset = 0;
+
+	q->pool = NULL;
+	q->owns_pool = 0;
+	q->allocator = allocator;
+
+	GSTATS_INIT(q);
+	GSTATS_REGISTER(q, "queue", queue_stats_of);
+	return GERROR_OK;
+}
+
+/** Creates a queue whose nodes are blocks of the node pool
+  * `pool`, each one holding the element inline, and populates
+  * the previous allocated structure pointed by `q`.
+  *
+  * @param q		pointer to a queue structure;
+  * @param member_size	size of the elements that will be
+  * 			indexed by `q`
+  * @param pool		pool shared with other containers or NULL,
+  * 			in which case `q` creates and owns a
+  * 			private pool.
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `q` is a NULL
+  * 		pointer
+  * 		GERROR_INVALID_ARGUMENT in case the blocks of
+  * 		`pool` are too small for `member_size`
+  */
+gerror_t queue_create_pooled(struct queue_t* q, size_t member_size, struct npool_t* pool)
+{
+	if(pool && pool->member_size < member_size)
+		return GERROR_INVALID_ARGUMENT;
+
+	gerror_t s = queue_create(q, member_size);
+	if(s != GERROR_OK) return s;
+
+	if(!pool){
+		pool = (npool_t*) GALLOC_ALLOC(q->allocator, sizeof(npool_t));
+		npool_create_with_allocator(pool, member_size, 0, q->allocator);
+		q->owns_pool = 1;
+	}
+	q->pool = pool;
+
+	return GERROR_OK;
+}
+
+/** Creates a queue that stores its elements in a contiguous
+  * circular buffer and populates the previous allocated
+  * structure pointed by `q`.
+  *
+  * The buffer has a power of two number of slots and doubles
+  * when it is full, so `queue_enqueue` and `queue_dequeue` do
+  * not allocate memory in steady state. A ring queue has no
+  * nodes: `head`, `tail` and `queue_remove` are not available.
+  *
+  * @param q			pointer to a queue structure;
+  * @param member_size		size of the elements that will be
+  * 				indexed by `q`
+  * @param initial_capacity	number of elements that fit in the
+  * 				initial buffer, it is rounded up to
+  * 				a power of two
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `q` is a NULL
+  * 		pointer
+  */
+gerror_t queue_create_ring(struct queue_t* q, size_t member_size, size_t initial_capacity)
+{
+	gerror_t s = queue_create(q, member_size);
+	if(s != GERROR_OK) return s;
+
+	q->mode = QUEUE_RING;
+	q->capacity = QUEUE_RING_MIN_CAPACITY;
+	while( q->capacity < initial_capacity )
+		q->capacity *= 2;
+
+	if(q->member_size){
+		q->buffer = GALLOC_ALLOC(q->allocator, q->capacity*q->member_size);
+		GSTATS_ADD(q, allocations, 1);
+	}
+
+	return GERROR_OK;
+}
+
+/** Creates an intrusive queue and populates the previous
+  * allocated structure pointed by `q`.
+  *
+  * The elements of an intrusive queue are structures of the
+  * caller that embed a qnode_t `link_offset` bytes after their
+  * start, usually `offsetof(type, member)`. `queue_enqueue`,
+  * `queue_dequeue` and `queue_remove` only relink those nodes:
+  * they do not allocate memory and do not copy the elements.
+  *
+  * `queue_enqueue` takes a pointer to the structure,
+  * `queue_dequeue` and `queue_remove` write a pointer to the
+  * structure in the `void*` pointed by `e`, and `queue_front_ptr`
+  * and `queue_foreach` give the structures themselves. A node
+  * may be in only one queue at a time, and the structure must
+  * outlive its stay in the queue. `queue_emplace` is not
+  * available.
+  *
+  * @param q		pointer to a queue structure;
+  * @param link_offset	offset of the qnode_t field in the
+  * 			elements
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `q` is a NULL
+  * 		pointer
+  */
+gerror_t queue_create_intrusive(struct queue_t* q, size_t link_offset)
+{
+	gerror_t s = queue_create(q, 0);
+	if(s != GERROR_OK) return s;
+
+	q->mode = QUEUE_INTRUSIVE;
+	q->link_offset = link_offset;
 	return GERROR_OK;
 }
 
 /** Enqueues the element pointed by `e` in the
-  * queue `q`.
+  * queue `q`. In an intrusive queue `e` is the structure
+  * that embeds the node, which is linked in place.
   *
   * @param q	pointer to a queue structure;
   * @param e	pointer to the element that will be indexed
@@ -51,24 +262,49 @@ gerror_t queue_create(struct queue_t* q, size_t member_size)
   * @return	GERROR_OK in case of success operation;
   * 		GERROR_NULL_STRUCURE in case `q` is a NULL
   * 		pointer
+  * 		GERROR_NULL_NODE in case `q` is an intrusive
+  * 		queue and `e` is NULL
   *
   */
 gerror_t queue_enqueue(struct queue_t* q, void* e)
 {
 	if(!q) return GERROR_NULL_STRUCTURE;
-	
-	struct qnode_t* new_node = (qnode_t*) malloc(sizeof(qnode_t));
 
-	if(q->member_size)
-		new_node->data = malloc(q->member_size);
-	else
-		new_node->data = NULL;
+	if(q->mode == QUEUE_RING){
+		if(q->size == q->capacity)
+			queue_ring_grow(q);
 
-	new_node->next = new_node->prev = NULL;
+		if(q->member_size && e)
+			memcpy(queue_ring_slot(q, q->size), e, q->member_size);
+
+		q->size++;
+		GSTATS_PEAK(q, q->size);
+		return GERROR_OK;
+	}
+
+	struct qnode_t* new_node;
+
+	if(q->mode == QUEUE_INTRUSIVE){
+		if(!e) return GERROR_NULL_NODE;
+		new_node = (qnode_t*)((char*) e + q->link_offset);
+		new_node->data = e;
+	}else if(q->pool){
+		new_node = (qnode_t*) npool_alloc(q->pool);
+		new_node->data = q->member_size? npool_payload(new_node) : NULL;
+	}else{
+		new_node = (qnode_t*) GALLOC_ALLOC(q->allocator, sizeof(qnode_t));
+		if(q->member_size)
+			new_node->data = GALLOC_ALLOC(q->allocator, q->member_size);
+		else
+			new_node->data = NULL;
+		GSTATS_ADD(q, allocations, q->member_size? 2 : 1);
+	}
 
 	if(q->member_size && e)
 		memcpy(new_node->data, e, q->member_size);
 
+	new_node->next = new_node->prev = NULL;
+
 	if(q->tail){
 		q->tail->next = new_node;
 		new_node->prev = q->tail;
@@ -79,6 +315,7 @@ gerror_t queue_enqueue(struct queue_t* q, void* e)
 	}
 
 	q->size++;
+	GSTATS_PEAK(q, q->size);
 
 	return GERROR_OK;
 }
@@ -88,7 +325,8 @@ gerror_t queue_enqueue(struct queue_t* q, void* e)
   * @param q	pointer to a queue structure;
   * @param e	pointer to the previous allocated element
   * 		memory that will be write with de dequeued
-  * 		element.
+  * 		element, or with a pointer to it in an
+  * 		intrusive queue.
   * 
   * @return	GERROR_OK in case of success operation;
   * 		GERROR_NULL_HEAD in case that the head `q->head`
@@ -101,10 +339,21 @@ gerror_t queue_enqueue(struct queue_t* q, void* e)
 gerror_t queue_dequeue(struct queue_t* q, void* e)
 {
 	if(!q)		return GERROR_NULL_STRUCTURE;
+
+	if(q->mode == QUEUE_RING){
+		if(!q->size) return GERROR_TRY_REMOVE_EMPTY_STRUCTURE;
+
+		if(q->member_size && e)
+			memcpy(e, queue_ring_slot(q, 0), q->member_size);
+
+		q->first = (q->first + 1) & (q->capacity - 1);
+		q->size--;
+		return GERROR_OK;
+	}
+
 	if(!q->head)	return GERROR_NULL_HEAD;
 	if(!q->size)	return GERROR_TRY_REMOVE_EMPTY_STRUCTURE;
 
-	void* ptr = q->head->data;
 	struct qnode_t* old_node = q->head;
 
 	q->head = q->head->next;
@@ -115,20 +364,59 @@ gerror_t queue_dequeue(struct queue_t* q, void* e)
 		q->tail = NULL;
 
 	q->size--;
-	free(old_node);
-	if(q->member_size && e)
-		memcpy(e, ptr, q->member_size);
-	if(ptr)
-		free(ptr);
+	queue_release_node(q, old_node, e);
 	return GERROR_OK;
 }
 
+/** Returns a pointer to the element at the front of the queue
+  * `q`, the next one `queue_dequeue` would remove, without
+  * copying it. The pointer is valid until the element is
+  * dequeued or, in a ring queue, until the buffer grows.
+  *
+  * @param q	pointer to a queue structure;
+  *
+  * @return	pointer to the element or NULL in case `q` is a
+  * 		NULL pointer, is empty or has `member_size` 0
+  */
+void* queue_front_ptr(struct queue_t* q)
+{
+	if(!q || !q->size) return NULL;
+
+	if(q->mode == QUEUE_RING)
+		return q->member_size? queue_ring_slot(q, 0) : NULL;
+
+	return q->head->data;
+}
+
+/** Enqueues an element in the queue `q` and returns the slot
+  * of the new element, so the caller writes it in place instead
+  * of copying it from a temporary. The slot is not initialized.
+  *
+  * @param q	pointer to a queue structure;
+  *
+  * @return	pointer to the slot of the new element or NULL in
+  * 		case `q` is a NULL pointer or has `member_size` 0
+  */
+void* queue_emplace(struct queue_t* q)
+{
+	if(queue_enqueue(q, NULL) != GERROR_OK) return NULL;
+	if(!q->member_size) return NULL;
+
+	if(q->mode == QUEUE_RING)
+		return queue_ring_slot(q, q->size - 1);
+
+	return q->tail->data;
+}
+
 /** Removes the element `node` of the queue `q`.
+  * In an intrusive queue `node` is the field embedded in the
+  * element, and the removal is O(1) with no deallocation.
   * 
   * @param q	pointer to a queue structure;
   * @param node	element to be removed from the queue
   * @param e	pointer to the memory that will be
-  * 		write with the removed element
+  * 		write with the removed element, or with a
+  * 		pointer to it in an intrusive queue
   *
   * @return	GERROR_OK in case of success operation;
   * 		GERROR_NULL_STRUCURE in case `q` is a NULL
@@ -136,11 +424,14 @@ gerror_t queue_dequeue(struct queue_t* q, void* e)
   * 		GERROR_NULL_NODE in case `node` is NULL;
   * 		GERROR_TRY_REMOVE_EMPTY_STRUCTURE in case
   * 		that `q` has no element.
+  * 		GERROR_UNSUPPORTED_OPERATION in case `q` is
+  * 		a ring queue, that has no nodes.
   *
   */
 gerror_t queue_remove(struct queue_t* q, struct qnode_t* node, void* e)
 {
 	if(!q)		return GERROR_NULL_STRUCTURE;
+	if(q->mode == QUEUE_RING) return GERROR_UNSUPPORTED_OPERATION;
 	if(!node)	return GERROR_NULL_NODE;
 	if(!q->size)	return GERROR_TRY_REMOVE_EMPTY_STRUCTURE;
 
@@ -156,19 +447,18 @@ gerror_t queue_remove(struct queue_t* q, struct qnode_t* node, void* e)
 
 	q->size--;
 	node->next = node->prev = NULL;
-	void* ptr = node->data;
-	free(node);
-	
-	if(q->member_size && e)
-		memcpy(e, ptr, q->member_size);
-	if(ptr)
-		free(ptr);
+	queue_release_node(q, node, e);
 	return GERROR_OK;
 }
 
 /** Deallocate the nodes of the queue q.
   * This function WILL NOT deallocate the pointer q.
   *
+  * A pooled queue gives its whole chain of nodes back to
+  * the shared pool in O(1), or releases the slabs of its
+  * private pool, without visiting the nodes. An intrusive
+  * queue only forgets its nodes, they belong to the caller.
+  *
   * @param q	pointer to a queue structure;
   *
   * @return	GERROR_OK in case of success operation;
@@ -179,14 +469,103 @@ gerror_t queue_destroy(struct queue_t* q)
 {
 	if(!q) return GERROR_NULL_STRUCTURE;
 
+	GSTATS_UNREGISTER(q);
+
+	if(q->mode == QUEUE_RING){
+		GALLOC_FREE(q->allocator, q->buffer, q->capacity*q->member_size);
+		q->buffer = NULL;
+		q->capacity = q->first = q->size = 0;
+		return GERROR_OK;
+	}
+
+	if(q->mode == QUEUE_INTRUSIVE){
+		q->head = q->tail = NULL;
+		q->size = 0;
+		return GERROR_OK;
+	}
+
+	if(q->pool){
+		if(q->owns_pool){
+			npool_destroy(q->pool);
+			GALLOC_FREE(q->allocator, q->pool, sizeof(npool_t));
+		}else if(q->head){
+			npool_free_chain(q->pool, q->head, q->tail);
+		}
+		q->pool = NULL;
+		q->owns_pool = 0;
+		q->head = q->tail = NULL;
+		q->size = 0;
+		return GERROR_OK;
+	}
+
 	struct qnode_t* i, *j;
 
 	for( i=q->head; i!=NULL; i=j ){
 		j = i->next;
 		if(i->data)
-			free(i->data);
-		free(i);
+			GALLOC_FREE(q->allocator, i->data, q->member_size);
+		GALLOC_FREE(q->allocator, i, sizeof(qnode_t));
+	}
+
+	return GERROR_OK;
+}
+
+/** Calls `visit` on every element of `q`, from the front to the
+  * back, with a pointer to the element in the queue, without
+  * dequeuing them. `visit` may change the elements but not
+  * enqueue or dequeue.
+  *
+  * @param q		pointer to a queue structure;
+  * @param visit	function called on every element
+  * @param argument	argument passed to `visit`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `q` or `visit` is
+  * 		a NULL pointer
+  */
+gerror_t queue_foreach(struct queue_t* q, queue_visit_function visit, void* argument)
+{
+	if(!q || !visit) return GERROR_NULL_STRUCTURE;
+
+	size_t i;
+	if(q->mode == QUEUE_RING){
+		for( i=0; i<q->size; i++ )
+			if( visit(q->member_size? queue_ring_slot(q, i) : NULL, i, argument) )
+				break;
+		return GERROR_OK;
 	}
 
+	qnode_t* node;
+	for( node=q->head, i=0; node!=NULL; node=node->next, i++ )
+		if( visit(node->data, i, argument) )
+			break;
+
+	return GERROR_OK;
+}
+
+/** Writes the counters of `q` in `stats`, see gstats.h. In the
+  * QUEUE_LIST and QUEUE_INTRUSIVE modes every element is a node.
+  *
+  * @param q		pointer to a queue structure;
+  * @param stats	pointer to the structure that receives
+  * 			the counters
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `q` or `stats` is
+  * 		a NULL pointer
+  * 		GERROR_UNSUPPORTED_OPERATION in case the library
+  * 		was built without GENERICS_STATS
+  */
+gerror_t queue_get_stats(struct queue_t* q, gstats_t* stats)
+{
+	if(!q || !stats) return GERROR_NULL_STRUCTURE;
+
+#ifdef GENERICS_STATS
+	*stats = q->stats.counters;
+	stats->size = q->size;
+	stats->nodes = q->mode != QUEUE_RING? q->size : 0;
 	return GERROR_OK;
+#else
+	return GERROR_UNSUPPORTED_OPERATION;
+#endif
 }
@@ -0,0 +1,478 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "snapshot.h"
+
+#define SNAPSHOT_ALIGN(n) (((n) + 7) & ~(size_t)7)
+
+/*
+ * auxiliar function;
+ * fills `h` with the fields every snapshot of `kind` has
+ */
+void snapshot_header_init (snapshot_header_t* h, snapshot_kind_t kind)
+{
+	memset(h, 0, sizeof(*h));
+	memcpy(h->magic, SNAPSHOT_MAGIC, sizeof(h->magic));
+	h->version = SNAPSHOT_VERSION;
+	h->kind = kind;
+}
+
+/*
+ * auxiliar function;
+ * offsets of the sections of a graph snapshot from the beginning
+ * of the image
+ *
+ * @return the length of the image
+ */
+size_t snapshot_graph_layout (size_t V, size_t E, size_t member_size, int weighted,
+		size_t* cols, size_t* weights, size_t* label)
+{
+	size_t at = SNAPSHOT_HEADER_SIZE + SNAPSHOT_ALIGN((V + 1)*sizeof(uint64_t));
+
+	*cols = at;
+	at += SNAPSHOT_ALIGN(E*sizeof(uint64_t));
+	*weights = at;
+	if( weighted )
+		at += SNAPSHOT_ALIGN(E*sizeof(double));
+	*label = at;
+
+	return at + SNAPSHOT_ALIGN(V*member_size);
+}
+
+/*
+ * auxiliar function;
+ * non-zero in case `count` items of `size` bytes fit in `length`
+ * bytes, checked without computing the product, which may
+ * overflow for the fields of a corrupt header
+ */
+int snapshot_fits (uint64_t count, uint64_t size, uint64_t length)
+{
+	return !size || count <= length/size;
+}
+
+/*
+ * auxiliar function;
+ * checks the compressed rows of a mapped graph: the offsets
+ * start at zero, never decrease and end at E, and every
+ * neighbor is a vertex of the graph
+ */
+int snapshot_graph_valid (const size_t* rows, const size_t* cols, size_t V, size_t E)
+{
+	size_t v, k;
+
+	if( rows[0] != 0 || rows[V] != E ) return 0;
+	for(v=0; v<V; v++)
+		if( rows[v] > rows[v+1] ) return 0;
+	for(k=0; k<E; k++)
+		if( cols[k] >= V ) return 0;
+
+	return 1;
+}
+
+/*
+ * auxiliar function;
+ * writes the `bytes` bytes of `data` in `file` and pads them
+ * with zeros to 8 bytes
+ *
+ * @return non-zero in case the write failed
+ */
+int snapshot_write (FILE* file, const void* data, size_t bytes)
+{
+	static const char zeros[SNAPSHOT_HEADER_SIZE];
+	size_t pad = SNAPSHOT_ALIGN(bytes) - bytes;
+
+	if( bytes && fwrite(data, 1, bytes, file) != bytes )
+		return 1;
+	return pad && fwrite(zeros, 1, pad, file) != pad;
+}
+
+/*
+ * auxiliar function;
+ * writes the header `h`, padded to SNAPSHOT_HEADER_SIZE bytes
+ *
+ * @return non-zero in case the write failed
+ */
+int snapshot_write_header (FILE* file, snapshot_header_t* h)
+{
+	char header[SNAPSHOT_HEADER_SIZE];
+
+	memset(header, 0, sizeof(header));
+	memcpy(header, h, sizeof(*h));
+	return fwrite(header, 1, sizeof(header), file) != sizeof(header);
+}
+
+/*
+ * auxiliar function;
+ * maps read-only the snapshot of `kind` in the file `path` and
+ * copies its header to `h`
+ */
+gerror_t snapshot_open (const char* path, snapshot_kind_t kind, snapshot_header_t* h, void** base)
+{
+	int fd = open(path, O_RDONLY);
+	if( fd < 0 ) return GERROR_IO;
+
+	struct stat st;
+	if( fstat(fd, &st) ){
+		close(fd);
+		return GERROR_IO;
+	}
+
+	size_t length = (size_t)st.st_size;
+	if( length < SNAPSHOT_HEADER_SIZE ){
+		close(fd);
+		return GERROR_INVALID_FORMAT;
+	}
+
+	void* mapping = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if( mapping == MAP_FAILED ) return GERROR_IO;
+
+	memcpy(h, mapping, sizeof(*h));
+	if(	memcmp(h->magic, SNAPSHOT_MAGIC, sizeof(h->magic)) ||
+		h->version != SNAPSHOT_VERSION ||
+		h->kind != (uint32_t)kind ||
+		h->length != length ){
+		munmap(mapping, length);
+		return GERROR_INVALID_FORMAT;
+	}
+
+	*base = mapping;
+	return GERROR_OK;
+}
+
+/** Writes to the file `path` a snapshot of the elements of `v`,
+  * that can be mapped with `vector_map`. The vector `v` is not
+  * changed.
+  *
+  * @param v		a pointer to `vector_t`
+  * @param path		path of the file to be written
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCTURE in case `v` is a NULL
+  * 		pointer
+  * 		GERROR_IO in case the file could not be written
+  */
+gerror_t vector_save (vector_t* v, const char* path)
+{
+	if( !v ) return GERROR_NULL_STRUCTURE;
+
+	snapshot_header_t h;
+	size_t bytes = v->size*v->member_size;
+
+	snapshot_header_init(&h, SNAPSHOT_VECTOR);
+	h.member_size = v->member_size;
+	h.size = v->size;
+	h.length = SNAPSHOT_HEADER_SIZE + SNAPSHOT_ALIGN(bytes);
+
+	gerror_t s = GERROR_OK;
+	FILE* file = fopen(path, "wb");
+	if( !file || snapshot_write_header(file, &h) || snapshot_write(file, v->data, bytes) )
+		s = GERROR_IO;
+	if( file && fclose(file) )
+		s = GERROR_IO;
+
+	return s;
+}
+
+/** Maps read-only the snapshot of a vector in the file `path` and
+  * populates the structure pointed by `v`, whose buffer is the
+  * mapping itself: nothing is copied and the pages are shared by
+  * every process that maps the file. The elements are read with
+  * the usual functions, but `v` must not be changed and it is
+  * released with `vector_unmap` instead of `vector_destroy`.
+  *
+  * @param v		a pointer to `vector_t`
+  * @param path		path of a file written by `vector_save`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCTURE in case `v` is a NULL
+  * 		pointer
+  * 		GERROR_IO in case the file could not be mapped
+  * 		GERROR_INVALID_FORMAT in case the file is not a
+  * 		snapshot of a vector of this version, or its sizes
+  * 		are not consistent
+  */
+gerror_t vector_map (vector_t* v, const char* path)
+{
+	if( !v ) return GERROR_NULL_STRUCTURE;
+
+	snapshot_header_t h;
+	void* base;
+	gerror_t s = snapshot_open(path, SNAPSHOT_VECTOR, &h, &base);
+	if( s != GERROR_OK ) return s;
+
+	if(	!snapshot_fits(h.size, h.member_size, h.length) ||
+		h.length != SNAPSHOT_HEADER_SIZE + SNAPSHOT_ALIGN(h.size*h.member_size) ){
+		munmap(base, (size_t)h.length);
+		return GERROR_INVALID_FORMAT;
+	}
+
+	v->data = (char*) base + SNAPSHOT_HEADER_SIZE;
+	v->size = (size_t)h.size;
+	v->member_size = (size_t)h.member_size;
+	v->buffer_size = v->size*v->member_size;
+	v->min_size = 0;
+	v->growth_factor = 2.0;
+	v->growth_cap = 0;
+	v->epoch = NULL;
+	v->allocator = &galloc_default;
+	GSTATS_INIT(v);
+
+	return GERROR_OK;
+}
+
+/** Unmaps the vector `v` mapped by `vector_map`. The pointer `v`
+  * is not freed.
+  *
+  * @param v		a pointer to `vector_t`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCTURE in case `v` is a NULL
+  * 		pointer
+  */
+gerror_t vector_unmap (vector_t* v)
+{
+	if( !v ) return GERROR_NULL_STRUCTURE;
+
+	if( v->data )
+		munmap(	(char*) v->data - SNAPSHOT_HEADER_SIZE,
+			SNAPSHOT_HEADER_SIZE + SNAPSHOT_ALIGN(v->buffer_size) );
+
+	v->data = NULL;
+	v->size = v->buffer_size = 0;
+
+	return GERROR_OK;
+}
+
+/*
+ * auxiliar function;
+ * argument of `snapshot_write_neighbor`
+ */
+typedef struct snapshot_writer_t{
+	FILE* file;
+	int weights;
+	int failed;
+}snapshot_writer_t;
+
+/*
+ * auxiliar function;
+ * writes the index or the weight of an adjacency entry
+ */
+int snapshot_write_neighbor (graph_t* g, size_t v, size_t to, double weight, void* argument)
+{
+	snapshot_writer_t* w = (snapshot_writer_t*) argument;
+	uint64_t index = to;
+
+	(void) g;
+	(void) v;
+	if( w->weights )
+		w->failed = fwrite(&weight, sizeof(weight), 1, w->file) != 1;
+	else
+		w->failed = fwrite(&index, sizeof(index), 1, w->file) != 1;
+
+	return w->failed;
+}
+
+/*
+ * auxiliar function;
+ * writes the compressed rows of `g`, built from the adjacency
+ * queues in case `g` is not frozen
+ *
+ * @return non-zero in case the write failed
+ */
+int snapshot_write_rows (FILE* file, graph_t* g)
+{
+	size_t E = g->E, i;
+
+	if( g->row_offsets )
+		return	snapshot_write(file, g->row_offsets, (g->V + 1)*sizeof(size_t)) ||
+			snapshot_write(file, g->col_indices, E*sizeof(size_t)) ||
+			(g->weights && snapshot_write(file, g->weights, E*sizeof(double)));
+
+	uint64_t offset = 0;
+	for( i=0; i<=g->V; i++ ){
+		if( fwrite(&offset, sizeof(offset), 1, file) != 1 )
+			return 1;
+		if( i < g->V )
+			offset += g->adj[i].size;
+	}
+
+	snapshot_writer_t w;
+	w.file = file;
+	w.failed = 0;
+	for( w.weights=0; w.weights <= g->weighted; w.weights++ )
+		for( i=0; i<g->V && !w.failed; i++ )
+			graph_foreach_neighbor(g, i, snapshot_write_neighbor, &w);
+
+	return w.failed;
+}
+
+/** Writes to the file `path` a snapshot of the graph `g`: its
+  * compressed rows, the weights and the labels, that can be
+  * mapped with `graph_map`. `g` does not have to be frozen and it
+  * is not changed.
+  *
+  * @param g		pointer to a graph structure;
+  * @param path		path of the file to be written
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  * 		GERROR_UNSUPPORTED_OPERATION in case `size_t`
+  * 		is not 64 bits wide
+  * 		GERROR_IO in case the file could not be written
+  */
+gerror_t graph_save (graph_t* g, const char* path)
+{
+	if( !g ) return GERROR_NULL_STRUCTURE;
+	if( sizeof(size_t) != sizeof(uint64_t) ) return GERROR_UNSUPPORTED_OPERATION;
+
+	snapshot_header_t h;
+	size_t cols, weights, label;
+
+	snapshot_header_init(&h, SNAPSHOT_GRAPH);
+	h.member_size = g->member_size;
+	h.size = g->V;
+	h.edges = g->E;
+	h.flags = g->weighted? SNAPSHOT_WEIGHTED : 0;
+	h.length = snapshot_graph_layout(g->V, g->E, g->member_size, g->weighted,
+			&cols, &weights, &label);
+
+	gerror_t s = GERROR_OK;
+	FILE* file = fopen(path, "wb");
+	if(	!file || snapshot_write_header(file, &h) ||
+		snapshot_write_rows(file, g) ||
+		snapshot_write(file, g->label, g->V*g->member_size) )
+		s = GERROR_IO;
+	if( file && fclose(file) )
+		s = GERROR_IO;
+
+	return s;
+}
+
+/** Maps read-only the snapshot of a graph in the file `path` and
+  * populates the structure pointed by `g` as a frozen graph,
+  * whose arrays are the mapping itself: nothing is copied and the
+  * pages are shared by every process that maps the file. The
+  * graph is read with the usual functions and its transpose may
+  * be built, but `g` must not be changed otherwise and it is
+  * released with `graph_unmap` instead of `graph_destroy`.
+  *
+  * The compressed rows are checked once here, so a corrupt file
+  * is refused instead of making the traversals read out of the
+  * mapping; this reads the offsets and the neighbors through.
+  *
+  * @param g		pointer to a graph structure;
+  * @param path		path of a file written by `graph_save`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  * 		GERROR_UNSUPPORTED_OPERATION in case `size_t`
+  * 		is not 64 bits wide
+  * 		GERROR_IO in case the file could not be mapped
+  * 		GERROR_INVALID_FORMAT in case the file is not a
+  * 		snapshot of a graph of this version, or its sizes
+  * 		or compressed rows are not consistent
+  */
+gerror_t graph_map (graph_t* g, const char* path)
+{
+	if( !g ) return GERROR_NULL_STRUCTURE;
+	if( sizeof(size_t) != sizeof(uint64_t) ) return GERROR_UNSUPPORTED_OPERATION;
+
+	snapshot_header_t h;
+	char* base;
+	gerror_t s = snapshot_open(path, SNAPSHOT_GRAPH, &h, (void**) &base);
+	if( s != GERROR_OK ) return s;
+
+	int weighted = (h.flags & SNAPSHOT_WEIGHTED) != 0;
+	size_t cols = 0, weights = 0, label = 0, length = 0;
+
+	/*
+	 * every section fits in the file on its own, so their
+	 * sum in the layout does not overflow
+	 */
+	if(	h.size < h.length/sizeof(uint64_t) &&
+		snapshot_fits(h.edges, sizeof(uint64_t), h.length) &&
+		snapshot_fits(h.size, h.member_size, h.length) )
+		length = snapshot_graph_layout((size_t)h.size, (size_t)h.edges,
+				(size_t)h.member_size, weighted, &cols, &weights, &label);
+	if(	h.length != length ||
+		!snapshot_graph_valid((size_t*)(base + SNAPSHOT_HEADER_SIZE),
+			(size_t*)(base + cols), (size_t)h.size, (size_t)h.edges) ){
+		munmap(base, (size_t)h.length);
+		return GERROR_INVALID_FORMAT;
+	}
+
+	g->V = (size_t)h.size;
+	g->E = (size_t)h.edges;
+	g->member_size = (size_t)h.member_size;
+	g->adj = NULL;
+	g->pool = NULL;
+	g->owns_pool = 0;
+	g->row_offsets = (size_t*)(base + SNAPSHOT_HEADER_SIZE);
+	g->col_indices = (size_t*)(base + cols);
+	g->in_offsets = NULL;
+	g->in_indices = NULL;
+	g->weighted = weighted;
+	g->weights = weighted? (double*)(base + weights) : NULL;
+	g->label = g->member_size? base + label : NULL;
+	g->allocator = &galloc_default;
+	GSTATS_INIT(g);
+
+	return GERROR_OK;
+}
+
+/** Unmaps the graph `g` mapped by `graph_map` and frees its
+  * transpose, in case it was built. The pointer `g` is not freed.
+  *
+  * @param g		pointer to a graph structure;
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `g` is a NULL
+  */
+gerror_t graph_unmap (graph_t* g)
+{
+	if( !g ) return GERROR_NULL_STRUCTURE;
+
+	if( g->in_offsets ){
+		GALLOC_FREE(g->allocator, g->in_offsets, sizeof(size_t)*(g->V + 1));
+		GALLOC_FREE(g->allocator, g->in_indices, sizeof(size_t)*(g->E? g->E : 1));
+	}
+
+	if( g->row_offsets ){
+		size_t cols, weights, label;
+		munmap(	(char*) g->row_offsets - SNAPSHOT_HEADER_SIZE,
+			snapshot_graph_layout(g->V, g->E, g->member_size, g->weighted,
+				&cols, &weights, &label) );
+	}
+
+	g->row_offsets = g->col_indices = g->in_offsets = g->in_indices = NULL;
+	g->weights = NULL;
+	g->label = NULL;
+	g->V = g->E = g->member_size = 0;
+
+	return GERROR_OK;
+}
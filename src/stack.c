@@ -18,6 +18,15 @@
  */
 #include "stack.h"
 
+/*
+ * auxiliar function;
+ * `stack_get_stats` for the registry
+ */
+gerror_t stack_stats_of (void* s, gstats_t* stats)
+{
+	return stack_get_stats((struct stack_t*) s, stats);
+}
+
 /** Creates a stack and populates the previous
   * allocated structure pointed by `s`;
   *
@@ -30,11 +39,99 @@
   */
 gerror_t stack_create(struct stack_t* s, size_t member_size)
 {
-	if(!s) return GERROR_NULL_STRUCTURE;
+	return stack_create_with_allocator(s, member_size, &galloc_default);
+}
+
+/** Creates a stack as `stack_create` does, but its nodes come
+  * from `allocator`, and populates the previous allocated
+  * structure pointed by `s`;
+  *
+  * @param s		pointer to a stack structure;
+  * @param member_size	size of the elements that will be
+  * 			indexed by `s`
+  * @param allocator	allocator of the nodes
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `s` or `allocator`
+  * 		is a NULL pointer
+  */
+gerror_t stack_create_with_allocator(struct stack_t* s, size_t member_size, const galloc_t* allocator)
+{
+	if(!s || !allocator) return GERROR_NULL_STRUCTURE;
 
 	s->member_size = member_size;
 	s->size = 0;
 	s->head = NULL;
+	s->pool = NULL;
+	s->owns_pool = 0;
+	s->mode = STACK_LIST;
+	s->allocator = allocator;
+
+	GSTATS_INIT(s);
+	GSTATS_REGISTER(s, "stack", stack_stats_of);
+	return GERROR_OK;
+}
+
+/** Creates a stack that keeps its elements contiguous in a
+  * `vector_t` and populates the previous allocated structure
+  * pointed by `s`. Push and pop only move `member_size` bytes
+  * and do not allocate until the buffer has to grow.
+  *
+  * @param s		pointer to a stack structure;
+  * @param member_size	size of the elements that will be
+  * 			indexed by `s`
+  * @param initial_size	number of elements that fit in the
+  * 			initial buffer
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `s` is a NULL
+  */
+gerror_t stack_create_array(struct stack_t* s, size_t member_size, size_t initial_size)
+{
+	gerror_t status = stack_create(s, member_size);
+	if(status != GERROR_OK) return status;
+
+	s->mode = STACK_ARRAY;
+	if(member_size){
+		vector_create_with_allocator(&s->vector, initial_size, member_size, s->allocator);
+		GSTATS_UNREGISTER(&s->vector);
+	}
+
+	return GERROR_OK;
+}
+
+
+/** Creates a stack whose nodes are blocks of the node pool
+  * `pool`, each one holding the element inline, and populates
+  * the previous allocated structure pointed by `s`.
+  *
+  * @param s		pointer to a stack structure;
+  * @param member_size	size of the elements that will be
+  * 			indexed by `s`
+  * @param pool		pool shared with other containers or NULL,
+  * 			in which case `s` creates and owns a
+  * 			private pool.
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `s` is a NULL
+  * 		GERROR_INVALID_ARGUMENT in case the blocks of
+  * 		`pool` are too small for `member_size`
+  */
+gerror_t stack_create_pooled(struct stack_t* s, size_t member_size, struct npool_t* pool)
+{
+	if(pool && pool->member_size < member_size)
+		return GERROR_INVALID_ARGUMENT;
+
+	gerror_t status = stack_create(s, member_size);
+	if(status != GERROR_OK) return status;
+
+	if(!pool){
+		pool = (npool_t*) GALLOC_ALLOC(s->allocator, sizeof(npool_t));
+		npool_create_with_allocator(pool, member_size, 0, s->allocator);
+		s->owns_pool = 1;
+	}
+	s->pool = pool;
+
 	return GERROR_OK;
 }
 
@@ -51,11 +148,21 @@ gerror_t stack_push(struct stack_t* s, void* e)
 {
 	if(!s) return GERROR_NULL_STRUCTURE;
 
-	struct snode_t* new_node = (snode_t*) malloc(sizeof(snode_t));
-	if( s->member_size )
-		new_node->data = malloc(s->member_size);
-	else
-		new_node->data = NULL;
+	if(s->mode == STACK_ARRAY)
+		return stack_push_n(s, e, 1);
+
+	struct snode_t* new_node;
+	if( s->pool ){
+		new_node = (snode_t*) npool_alloc(s->pool);
+		new_node->data = s->member_size? npool_payload(new_node) : NULL;
+	}else{
+		new_node = (snode_t*) GALLOC_ALLOC(s->allocator, sizeof(snode_t));
+		if( s->member_size )
+			new_node->data = GALLOC_ALLOC(s->allocator, s->member_size);
+		else
+			new_node->data = NULL;
+		GSTATS_ADD(s, allocations, s->member_size? 2 : 1);
+	}
 	new_node->prev = NULL;
 	new_node->next = s->head;
 
@@ -65,6 +172,7 @@ gerror_t stack_push(struct stack_t* s, void* e)
 	s->head = new_node;
 
 	s->size++;
+	GSTATS_PEAK(s, s->size);
 
 	return GERROR_OK;
 }
@@ -83,6 +191,9 @@ gerror_t stack_push(struct stack_t* s, void* e)
 gerror_t stack_pop (struct stack_t* s, void* e)
 {
 	if(!s)		return GERROR_NULL_STRUCTURE;
+
+	if(s->mode == STACK_ARRAY)
+		return stack_pop_n(s, e, 1);
 	if(!s->head)	return GERROR_NULL_HEAD;
 	if(!s->size)	return GERROR_TRY_REMOVE_EMPTY_STRUCTURE;
 
@@ -95,12 +206,121 @@ gerror_t stack_pop (struct stack_t* s, void* e)
 		s->head->prev = NULL;
 
 	s->size--;
-	free(old_node);
 
 	if(s->member_size && e)
 		memcpy(e, ptr, s->member_size);
-	if(ptr)
-		free(ptr);
+
+	if(s->pool){
+		npool_free(s->pool, old_node);
+	}else{
+		GALLOC_FREE(s->allocator, old_node, sizeof(snode_t));
+		if(ptr)
+			GALLOC_FREE(s->allocator, ptr, s->member_size);
+	}
+	return GERROR_OK;
+}
+
+/** Returns a pointer to the element on the top of the stack
+  * `s`, the next one `stack_pop` would remove, without copying
+  * it. The pointer is valid until the element is popped or, in
+  * an array stack, until the buffer grows.
+  *
+  * @param s	pointer to a stack structure;
+  *
+  * @return	pointer to the element or NULL in case `s` is a
+  * 		NULL pointer, is empty or has `member_size` 0
+  */
+void* stack_top_ptr (struct stack_t* s)
+{
+	if(!s || !s->size || !s->member_size) return NULL;
+
+	if(s->mode == STACK_ARRAY)
+		return s->vector.data + (s->vector.size - 1)*s->member_size;
+
+	return s->head->data;
+}
+
+/** Pushes an element in the stack `s` and returns the slot of
+  * the new element, so the caller writes it in place instead of
+  * copying it from a temporary. The slot is not initialized.
+  *
+  * @param s	pointer to a stack structure;
+  *
+  * @return	pointer to the slot of the new element or NULL in
+  * 		case `s` is a NULL pointer or has `member_size` 0
+  */
+void* stack_emplace (struct stack_t* s)
+{
+	if(stack_push(s, NULL) != GERROR_OK) return NULL;
+	return stack_top_ptr(s);
+}
+
+/** Pushes the `n` elements of the array `e` in the stack `s`,
+  * so `e[n-1]` ends on the top. In an array stack the whole
+  * batch is copied with a single memcpy.
+  *
+  * @param s	pointer to a stack structure;
+  * @param e	pointer to `n` contiguous elements, or NULL
+  * @param n	number of elements to push
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `s` is a NULL
+  */
+gerror_t stack_push_n (struct stack_t* s, void* e, size_t n)
+{
+	if(!s) return GERROR_NULL_STRUCTURE;
+
+	if(s->mode == STACK_ARRAY){
+		if(s->member_size)
+			vector_append_n(&s->vector, e, n);
+		s->size += n;
+		GSTATS_PEAK(s, s->size);
+		return GERROR_OK;
+	}
+
+	size_t i;
+	for( i=0; i<n; i++ )
+		stack_push(s, e? e + i*s->member_size : NULL);
+
+	return GERROR_OK;
+}
+
+/** Pops the `n` elements on the top of the stack `s` and writes
+  * them in `e` in the same order `stack_push_n` takes them, so
+  * the old top ends in `e[n-1]`. In an array stack the whole
+  * batch is copied with a single memcpy.
+  *
+  * @param s	pointer to a stack structure;
+  * @param e	pointer to room for `n` elements, or NULL
+  * @param n	number of elements to pop
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `s` is a NULL
+  * 		GERROR_TRY_REMOVE_EMPTY_STRUCTURE in case that `s`
+  * 			has less than `n` elements, in which case
+  * 			nothing is popped
+  */
+gerror_t stack_pop_n (struct stack_t* s, void* e, size_t n)
+{
+	if(!s)		return GERROR_NULL_STRUCTURE;
+	if(n > s->size)	return GERROR_TRY_REMOVE_EMPTY_STRUCTURE;
+
+	if(s->mode == STACK_ARRAY){
+		if(s->member_size){
+			s->vector.size -= n;
+			if(e)
+				memcpy(	e,
+					s->vector.data + s->vector.size*s->member_size,
+					n*s->member_size );
+		}
+		s->size -= n;
+		return GERROR_OK;
+	}
+
+	size_t i;
+	for( i=n; i>0; i-- )
+		stack_pop(s, e? e + (i-1)*s->member_size : NULL);
+
 	return GERROR_OK;
 }
 
@@ -109,6 +329,10 @@ gerror_t stack_pop (struct stack_t* s, void* e)
   * by `s`. This function WILL NOT deallocate the
   * pointer `q`.
   *
+  * A pooled stack gives its chain of nodes back to the
+  * shared pool, or releases the slabs of its private pool,
+  * without freeing the nodes one by one.
+  *
   * @param s		pointer to a stack structure;
   *
   * @return	GERROR_OK in case of success operation;
@@ -118,14 +342,103 @@ gerror_t stack_destroy(struct stack_t* s)
 {
 	if(!s) return GERROR_NULL_STRUCTURE;
 
+	GSTATS_UNREGISTER(s);
+
 	struct snode_t* i, *j;
 
+	if(s->mode == STACK_ARRAY){
+		if(s->member_size)
+			vector_destroy(&s->vector);
+		s->size = 0;
+		return GERROR_OK;
+	}
+
+	if(s->pool){
+		if(s->owns_pool){
+			npool_destroy(s->pool);
+			GALLOC_FREE(s->allocator, s->pool, sizeof(npool_t));
+		}else if(s->head){
+			for( i=s->head; i->next!=NULL; i=i->next );
+			npool_free_chain(s->pool, s->head, i);
+		}
+		s->pool = NULL;
+		s->owns_pool = 0;
+		s->head = NULL;
+		s->size = 0;
+		return GERROR_OK;
+	}
+
 	for( i=s->head; i!=NULL; i=j ){
 		j = i->next;
 		if(i->data)
-			free(i->data);
-		free(i);
+			GALLOC_FREE(s->allocator, i->data, s->member_size);
+		GALLOC_FREE(s->allocator, i, sizeof(snode_t));
 	}
 
 	return GERROR_OK;
 }
+
+/** Calls `visit` on every element of `s`, from the top to the
+  * bottom, with a pointer to the element in the stack, without
+  * popping them. `visit` may change the elements but not push
+  * or pop.
+  *
+  * @param s		pointer to a stack structure;
+  * @param visit	function called on every element
+  * @param argument	argument passed to `visit`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `s` or `visit` is
+  * 		a NULL pointer
+  */
+gerror_t stack_foreach(struct stack_t* s, stack_visit_function visit, void* argument)
+{
+	if(!s || !visit) return GERROR_NULL_STRUCTURE;
+
+	size_t i;
+	if(s->mode == STACK_ARRAY){
+		for( i=0; i<s->size; i++ )
+			if( visit(	s->member_size?
+					s->vector.data + (s->size - 1 - i)*s->member_size : NULL,
+					i, argument) )
+				break;
+		return GERROR_OK;
+	}
+
+	snode_t* node;
+	for( node=s->head, i=0; node!=NULL; node=node->next, i++ )
+		if( visit(node->data, i, argument) )
+			break;
+
+	return GERROR_OK;
+}
+
+/** Writes the counters of `s` in `stats`, see gstats.h. In the
+  * STACK_ARRAY mode the counters of the vector are included.
+  *
+  * @param s		pointer to a stack structure;
+  * @param stats	pointer to the structure that receives
+  * 			the counters
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `s` or `stats` is
+  * 		a NULL pointer
+  * 		GERROR_UNSUPPORTED_OPERATION in case the library
+  * 		was built without GENERICS_STATS
+  */
+gerror_t stack_get_stats(struct stack_t* s, gstats_t* stats)
+{
+	if(!s || !stats) return GERROR_NULL_STRUCTURE;
+
+#ifdef GENERICS_STATS
+	*stats = s->stats.counters;
+	stats->size = s->size;
+	if(s->mode == STACK_ARRAY && s->member_size)
+		gstats_merge(stats, &s->vector.stats.counters);
+	else
+		stats->nodes = s->size;
+	return GERROR_OK;
+#else
+	return GERROR_UNSUPPORTED_OPERATION;
+#endif
+}
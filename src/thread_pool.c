@@ -0,0 +1,325 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#define _POSIX_C_SOURCE 200112L
+#include <unistd.h>
+#include <sched.h>
+#include "thread_pool.h"
+
+/*
+ * the argument of every worker thread
+ */
+typedef struct tpool_worker_t{
+	tpool_t* pool;
+	size_t index;
+}tpool_worker_t;
+
+/*
+ * auxiliar function;
+ * pushes `r` at the bottom of `d`
+ */
+int tpool_push (tpool_deque_t* d, tpool_range_t r)
+{
+	int pushed = 0;
+
+	pthread_mutex_lock(&d->lock);
+	if(d->bottom - d->top < TPOOL_DEQUE_SIZE){
+		d->ranges[d->bottom % TPOOL_DEQUE_SIZE] = r;
+		d->bottom++;
+		pushed = 1;
+	}
+	pthread_mutex_unlock(&d->lock);
+
+	return pushed;
+}
+
+/*
+ * auxiliar function;
+ * pops a range from the bottom of `d`, if `steal` is zero,
+ * or from its top
+ */
+int tpool_pop (tpool_deque_t* d, tpool_range_t* r, int steal)
+{
+	int popped = 0;
+
+	pthread_mutex_lock(&d->lock);
+	if(d->bottom != d->top){
+		if(steal){
+			*r = d->ranges[d->top % TPOOL_DEQUE_SIZE];
+			d->top++;
+		}else{
+			d->bottom--;
+			*r = d->ranges[d->bottom % TPOOL_DEQUE_SIZE];
+		}
+		popped = 1;
+	}
+	pthread_mutex_unlock(&d->lock);
+
+	return popped;
+}
+
+/*
+ * auxiliar function;
+ * runs the current loop on the worker `index` until every
+ * index of the loop is done
+ */
+void tpool_work (tpool_t* p, size_t index)
+{
+	tpool_range_t r;
+	size_t i;
+
+	while( __atomic_load_n(&p->remaining, __ATOMIC_ACQUIRE) ){
+		int found = tpool_pop(&p->deques[index], &r, 0);
+
+		for(i=1; !found && i<p->n_threads; i++)
+			found = tpool_pop(&p->deques[(index + i) % p->n_threads], &r, 1);
+
+		if(!found){
+			sched_yield();
+			continue;
+		}
+
+		/*
+		 * keeps the lower half and offers the upper half
+		 * to the other workers
+		 */
+		while(r.end - r.begin > p->grain){
+			tpool_range_t upper;
+			upper.begin = r.begin + (r.end - r.begin)/2;
+			upper.end = r.end;
+
+			if(!tpool_push(&p->deques[index], upper))
+				break;
+			r.end = upper.begin;
+		}
+
+		p->function(r.begin, r.end, index, p->argument);
+		__atomic_sub_fetch(&p->remaining, r.end - r.begin, __ATOMIC_RELEASE);
+	}
+}
+
+/*
+ * auxiliar function;
+ * non-zero in case the calling thread is a worker of `p`,
+ * whose number is written in `index`
+ */
+int tpool_self (tpool_t* p, size_t* index)
+{
+	pthread_t self = pthread_self();
+	size_t i;
+
+	for(i=0; i<p->n_threads; i++)
+		if(pthread_equal(p->threads[i], self)){
+			*index = i;
+			return 1;
+		}
+
+	return 0;
+}
+
+/*
+ * auxiliar function;
+ * body of the worker threads
+ */
+void* tpool_worker (void* argument)
+{
+	tpool_worker_t* w = (tpool_worker_t*) argument;
+	tpool_t* p = w->pool;
+	size_t index = w->index;
+	size_t seen = 0;
+
+	free(w);
+
+	for(;;){
+		pthread_mutex_lock(&p->lock);
+		while(!p->stop && p->generation == seen)
+			pthread_cond_wait(&p->wake, &p->lock);
+		if(p->stop){
+			pthread_mutex_unlock(&p->lock);
+			break;
+		}
+		seen = p->generation;
+		pthread_mutex_unlock(&p->lock);
+
+		tpool_work(p, index);
+
+		pthread_mutex_lock(&p->lock);
+		if(--p->active == 0)
+			pthread_cond_signal(&p->done);
+		pthread_mutex_unlock(&p->lock);
+	}
+
+	return NULL;
+}
+
+/** Creates a pool of `n_threads` worker threads and populates
+  * the previous allocated structure pointed by `p`;
+  *
+  * @param p		pointer to a thread pool structure;
+  * @param n_threads	number of threads or 0 to start one
+  * 			thread per online processor
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` is a NULL
+  */
+gerror_t tpool_create (tpool_t* p, size_t n_threads)
+{
+	if(!p) return GERROR_NULL_STRUCTURE;
+
+	if(!n_threads){
+		long n = sysconf(_SC_NPROCESSORS_ONLN);
+		n_threads = n > 0? (size_t)n : 1;
+	}
+
+	p->n_threads = n_threads;
+	p->generation = 0;
+	p->active = 0;
+	p->stop = 0;
+	p->remaining = 0;
+	p->function = NULL;
+	p->argument = NULL;
+	p->grain = 1;
+
+	pthread_mutex_init(&p->lock, NULL);
+	pthread_mutex_init(&p->run, NULL);
+	pthread_cond_init(&p->wake, NULL);
+	pthread_cond_init(&p->done, NULL);
+
+	p->deques = (tpool_deque_t*) malloc(sizeof(tpool_deque_t)*n_threads);
+	p->threads = (pthread_t*) malloc(sizeof(pthread_t)*n_threads);
+
+	size_t i;
+	for(i=0; i<n_threads; i++){
+		pthread_mutex_init(&p->deques[i].lock, NULL);
+		p->deques[i].top = p->deques[i].bottom = 0;
+	}
+
+	for(i=0; i<n_threads; i++){
+		tpool_worker_t* w = (tpool_worker_t*) malloc(sizeof(tpool_worker_t));
+		w->pool = p;
+		w->index = i;
+		pthread_create(&p->threads[i], NULL, tpool_worker, w);
+	}
+
+	return GERROR_OK;
+}
+
+/** Calls `function` on the indexes from `begin` to `end - 1`
+  * split in ranges among the threads of `p`, and waits until
+  * every index is done. The range starts evenly split among the
+  * workers; a worker splits its ranges in halves down to
+  * `grain` indexes, and a worker with no range left steals the
+  * largest range waiting in the deque of another worker.
+  *
+  * The pool runs one loop at a time. A loop started from a
+  * worker of `p`, nested in the `function` of another loop, runs
+  * the whole range inline on that worker instead of waiting for
+  * the pool it occupies.
+  *
+  * @param p		pointer to a thread pool structure;
+  * @param begin	first index;
+  * @param end		index after the last;
+  * @param grain	least number of indexes of a range
+  * 			before it is no longer split, 0 is
+  * 			taken as 1;
+  * @param function	function called on every range;
+  * @param argument	argument passed to `function`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` is a NULL
+  */
+gerror_t tpool_parallel_for (tpool_t* p, size_t begin, size_t end, size_t grain,
+		tpool_range_function function, void* argument)
+{
+	if(!p) return GERROR_NULL_STRUCTURE;
+	if(begin >= end) return GERROR_OK;
+
+	size_t self;
+	if(tpool_self(p, &self)){
+		function(begin, end, self, argument);
+		return GERROR_OK;
+	}
+
+	pthread_mutex_lock(&p->run);
+
+	p->function = function;
+	p->argument = argument;
+	p->grain = grain? grain : 1;
+	p->remaining = end - begin;
+
+	size_t i, n = end - begin;
+	for(i=0; i<p->n_threads; i++){
+		tpool_range_t r;
+		r.begin = begin + n*i/p->n_threads;
+		r.end = begin + n*(i+1)/p->n_threads;
+		if(r.begin == r.end) continue;
+
+		p->deques[i].top = p->deques[i].bottom = 0;
+		tpool_push(&p->deques[i], r);
+	}
+
+	pthread_mutex_lock(&p->lock);
+	p->active = p->n_threads;
+	p->generation++;
+	pthread_cond_broadcast(&p->wake);
+	while(p->active)
+		pthread_cond_wait(&p->done, &p->lock);
+	pthread_mutex_unlock(&p->lock);
+
+	pthread_mutex_unlock(&p->run);
+
+	return GERROR_OK;
+}
+
+/** Stops and joins the threads of `p` and deallocates its
+  * structures. This function WILL NOT deallocate the pointer `p`.
+  *
+  * @param p		pointer to a thread pool structure;
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `p` is a NULL
+  */
+gerror_t tpool_destroy (tpool_t* p)
+{
+	if(!p) return GERROR_NULL_STRUCTURE;
+
+	pthread_mutex_lock(&p->lock);
+	p->stop = 1;
+	pthread_cond_broadcast(&p->wake);
+	pthread_mutex_unlock(&p->lock);
+
+	size_t i;
+	for(i=0; i<p->n_threads; i++)
+		pthread_join(p->threads[i], NULL);
+
+	for(i=0; i<p->n_threads; i++)
+		pthread_mutex_destroy(&p->deques[i].lock);
+
+	pthread_mutex_destroy(&p->lock);
+	pthread_mutex_destroy(&p->run);
+	pthread_cond_destroy(&p->wake);
+	pthread_cond_destroy(&p->done);
+
+	free(p->deques);
+	free(p->threads);
+	p->deques = NULL;
+	p->threads = NULL;
+	p->n_threads = 0;
+
+	return GERROR_OK;
+}
@@ -17,10 +17,31 @@
  * For more information, please refer to <http://unlicense.org/>
  */
 #include "trie.h"
+#include "epoch.h"
+
+/*
+ * number of walks interleaved by `trie_get_many`
+ */
+#define TRIE_LANES 8
+
+#define TRIE_PREFETCH(addr) __builtin_prefetch(addr)
+
+/*
+ * state of the walk of one key: `node` is reached after the
+ * first `depth` bytes of the key
+ */
+typedef struct trie_lane_t{
+	unsigned char* key;
+	size_t size;
+	size_t depth;
+	void* node;
+	size_t index;
+}trie_lane_t;
 
 /*
  * Auxiliar function;
  * find the node mapped by `string`, if necessary, allocates
+ * Only the TRIE_DENSE mode has tnode_t nodes.
  *
  * @return the node mapped with string and allocate
  */
@@ -29,20 +50,21 @@ tnode_t* trie_get_node_or_allocate (
 		void* string,
 		size_t size)
 {
-	if(!t || !string) return NULL;
+	if(!t || !string || t->mode != TRIE_DENSE) return NULL;
 	struct tnode_t* node = &t->root;
 	size_t i;
 	char *ptr = string;
 
 	for(i=0; i<size; i++){
-		int byte = (int)ptr[i];
+		unsigned char byte = (unsigned char)ptr[i];
 		if ( node->children[byte] == NULL ){
-			node->children[byte] = (tnode_t*)malloc(sizeof(tnode_t));
+			node->children[byte] = (tnode_t*)GALLOC_ALLOC(t->allocator, sizeof(tnode_t));
+			GSTATS_ADD(t, allocations, 1);
 			node->children[byte]->value = NULL;
 
 			int j;
 			for(j=0; j<NBYTE; j++)
-				node->children[byte]->children[i] = NULL;
+				node->children[byte]->children[j] = NULL;
 
 		}
 
@@ -76,6 +98,31 @@ tnode_t* node_at ( struct trie_t* t, void* string, size_t size)
 	return node;
 }
 
+/*
+ * Auxiliar function;
+ * find the value mapped by `string` in any mode
+ *
+ * @return	the value mapped with `string` or null case the mapped
+ * 		does not exists.
+ */
+void* trie_value_at ( struct trie_t* t, void* string, size_t size)
+{
+	if(t->mode == TRIE_ADAPTIVE)
+		return art_get(__atomic_load_n(&t->art_root, __ATOMIC_ACQUIRE), string, size);
+
+	struct tnode_t* node = node_at(t, string, size);
+	return node? node->value : NULL;
+}
+
+/*
+ * auxiliar function;
+ * `trie_get_stats` for the registry
+ */
+gerror_t trie_stats_of (void* t, gstats_t* stats)
+{
+	return trie_get_stats((struct trie_t*) t, stats);
+}
+
 /** Inicialize structure `t` with `member_size` size.
   * The t has to be allocated.
   *
@@ -85,16 +132,143 @@ tnode_t* node_at ( struct trie_t* t, void* string, size_t size)
   */
 gerror_t trie_create (struct trie_t* t, size_t member_size)
 {
-	if(!t) return GERROR_NULL_STRUCTURE;
+	return trie_create_with_allocator(t, member_size, &galloc_default);
+}
+
+/** Inicialize structure `t` as `trie_create`, but the nodes
+  * and the values come from `allocator`.
+  * The t has to be allocated.
+  *
+  * @param t		pointer to the allocated struct trie_t;
+  * @param member_size	size in bytes of the indexed elements
+  * 			by the trie;
+  * @param allocator	allocator of the nodes and the values
+  */
+gerror_t trie_create_with_allocator (struct trie_t* t, size_t member_size, const galloc_t* allocator)
+{
+	if(!t || !allocator) return GERROR_NULL_STRUCTURE;
 
 	t->size = 0;
 	t->member_size = member_size;
 	t->root.value = NULL;
+	t->mode = TRIE_DENSE;
+	t->art_root = NULL;
+	t->epoch = NULL;
+	t->allocator = allocator;
 	
 	int i;
 	for(i=0; i<NBYTE; i++)
 		t->root.children[i] = NULL;
 
+	GSTATS_INIT(t);
+	GSTATS_REGISTER(t, "trie", trie_stats_of);
+	return GERROR_OK;
+}
+
+/** Inicialize structure `t` with `member_size` size, using
+  * the adaptive node layout: the nodes have room for 4, 16,
+  * 48 or 256 children as needed and single-child chains are
+  * collapsed (see art.h). It uses much less memory than the
+  * dense layout for sparse keys, with the same interface.
+  * The t has to be allocated.
+  *
+  * @param t		pointer to the allocated struct trie_t;
+  * @param member_size	size in bytes of the indexed elements
+  * 			by the trie.
+  */
+gerror_t trie_create_adaptive (struct trie_t* t, size_t member_size)
+{
+	return trie_create_adaptive_with_allocator(t, member_size, &galloc_default);
+}
+
+/** Inicialize structure `t` as `trie_create_adaptive`, but the
+  * nodes and the values come from `allocator`.
+  * The t has to be allocated.
+  *
+  * @param t		pointer to the allocated struct trie_t;
+  * @param member_size	size in bytes of the indexed elements
+  * 			by the trie;
+  * @param allocator	allocator of the nodes and the values
+  */
+gerror_t trie_create_adaptive_with_allocator (struct trie_t* t, size_t member_size, const galloc_t* allocator)
+{
+	gerror_t s = trie_create_with_allocator(t, member_size, allocator);
+	if(s != GERROR_OK) return s;
+
+	t->mode = TRIE_ADAPTIVE;
+	return GERROR_OK;
+}
+
+/** Inicialize structure `t` as `trie_create_adaptive`, but
+  * `trie_get_element` may run concurrently with a single writer
+  * and needs no lock, as long as the reader is inside a read
+  * section of `e` (see epoch.h).
+  *
+  * The writer never changes a node that readers may see: it
+  * copies the nodes on the path of the key, publishes the new
+  * root at once and retires the replaced nodes and values in
+  * `e`. A reader sees either the old or the new tree.
+  *
+  * @param t		pointer to the allocated struct trie_t;
+  * @param member_size	size in bytes of the indexed elements
+  * 			by the trie;
+  * @param e		the epoch domain of the readers
+  */
+gerror_t trie_create_concurrent (struct trie_t* t, size_t member_size, struct epoch_t* e)
+{
+	if(!e) return GERROR_NULL_STRUCTURE;
+
+	gerror_t s = trie_create_adaptive(t, member_size);
+	if(s != GERROR_OK) return s;
+
+	t->epoch = e;
+	return GERROR_OK;
+}
+
+/*
+ * auxiliar function;
+ * publishes the tree `root` built by the writer and retires
+ * the nodes in `retired`, that are not reachable from `root`
+ */
+void trie_publish (struct trie_t* t, art_node_t* root, vector_t* retired)
+{
+	size_t i;
+
+	__atomic_store_n(&t->art_root, root, __ATOMIC_RELEASE);
+
+	for(i=0; i<retired->size; i++)
+		epoch_retire(t->epoch, *(void**)vector_ptr_at(retired, i), free);
+	vector_destroy(retired);
+
+	epoch_try_advance(t->epoch);
+}
+
+/*
+ * auxiliar function;
+ * `trie_add_element` of a concurrent trie, the old value is
+ * retired instead of overwritten
+ */
+gerror_t trie_add_concurrent (struct trie_t* t, void* string, size_t size, void* elem)
+{
+	art_node_t* root = t->art_root;
+	vector_t retired;
+
+	vector_create(&retired, 0, sizeof(art_node_t*));
+	GSTATS_UNREGISTER(&retired);
+	void** value = art_insert_copy(&root, string, size, &retired);
+
+	if(*value)
+		epoch_retire(t->epoch, *value, free);
+	else
+		t->size++;
+
+	*value = malloc(t->member_size? t->member_size : 1);
+	GSTATS_ADD(t, allocations, 1);
+	GSTATS_PEAK(t, t->size);
+	if(t->member_size && elem)
+		memcpy(*value, elem, t->member_size);
+
+	trie_publish(t, root, &retired);
 	return GERROR_OK;
 }
 
@@ -102,22 +276,23 @@ gerror_t trie_create (struct trie_t* t, size_t member_size)
  * auxiliar function.
  * destroy a node recursively.
  */
-void trie_destroy_tnode (struct tnode_t* node)
+void trie_destroy_tnode (struct trie_t* t, struct tnode_t* node)
 {
 	if( node ){
 		int i;
 		for(i=0; i<NBYTE; i++)
-			trie_destroy_tnode(node->children[i]);
+			trie_destroy_tnode(t, node->children[i]);
 
 		if( node->value )
-			free(node->value);
+			GALLOC_FREE(t->allocator, node->value, t->member_size? t->member_size : 1);
 
-		free(node);
+		GALLOC_FREE(t->allocator, node, sizeof(tnode_t));
 	}
 }
 
 /** Destroy the members pointed by `t`.
-  * The structure is not freed.
+  * The structure is not freed. A concurrent trie must have no
+  * reader left; the memory it retired is freed by its epoch.
   *
   * @return	GERROR_OK in case of success operation;
   * 		GERROR_NULL_STRUCURE in case `t` is a NULL
@@ -126,13 +301,18 @@ gerror_t trie_destroy (struct trie_t* t)
 {
 	if(!t) return GERROR_NULL_STRUCTURE;
 
+	GSTATS_UNREGISTER(t);
+
 	int i;
+
+	art_destroy(t->art_root, t->member_size? t->member_size : 1, t->allocator);
+	t->art_root = NULL;
 	
 	if(t->root.value)
-		free(t->root.value);
+		GALLOC_FREE(t->allocator, t->root.value, t->member_size? t->member_size : 1);
 	
 	for(i=0; i<NBYTE; i++){
-		trie_destroy_tnode(t->root.children[i]);
+		trie_destroy_tnode(t, t->root.children[i]);
 		t->root.children[i] = NULL;
 	}
 	t->size = 0;
@@ -141,6 +321,31 @@ gerror_t trie_destroy (struct trie_t* t)
 	return GERROR_OK;
 }
 
+/*
+ * auxiliar function;
+ * the value mapped by `string` in a trie that is not
+ * concurrent, allocated in case `string` is not mapped yet
+ */
+void* trie_value_slot (struct trie_t* t, void* string, size_t size)
+{
+	void** value;
+	if(t->mode == TRIE_ADAPTIVE){
+		value = art_insert(&t->art_root, string, size, t->allocator);
+	}else{
+		struct tnode_t* node = trie_get_node_or_allocate(t, string, size);
+		value = &node->value;
+	}
+
+	if(*value == NULL){
+		*value = GALLOC_ALLOC(t->allocator, t->member_size? t->member_size : 1);
+		t->size++;
+		GSTATS_ADD(t, allocations, 1);
+		GSTATS_PEAK(t, t->size);
+	}
+
+	return *value;
+}
+
 /** Adds the `elem` and maps it with the `string` with size `size`.
   * This function overwrite any data left in the trie mapped with string.
   *
@@ -152,18 +357,35 @@ gerror_t trie_destroy (struct trie_t* t)
 gerror_t trie_add_element (struct trie_t* t, void* string, size_t size, void* elem)
 {
 	if(!t) return GERROR_NULL_STRUCTURE;
-	struct tnode_t* node = trie_get_node_or_allocate(t, string, size);
+	if(t->epoch) return trie_add_concurrent(t, string, size, elem);
 
-	if(node->value == NULL)
-		node->value = malloc(t->member_size);
+	void* value = trie_value_slot(t, string, size);
 
-	if(t->member_size && string)
-		memcpy(node->value, elem, t->member_size);
-	t->size++;
+	if(t->member_size && elem)
+		memcpy(value, elem, t->member_size);
 
 	return GERROR_OK;
 }
 
+/** Maps `string` with size `size` and returns its value, so the
+  * caller writes the element in place instead of copying it from
+  * a temporary. A new value is not initialized; an existing one
+  * keeps the element it had. The readers of a concurrent trie
+  * must never see a value being written, so it has no emplace.
+  *
+  * @param t		pointer to the trie structure;
+  * @param string	pointer to the string of bytes to map elem;
+  * @param size		size of the string of bytes
+  *
+  * @return	pointer to the value of `string` or NULL in case
+  * 		`t` is a NULL pointer or is concurrent
+  */
+void* trie_emplace (struct trie_t* t, void* string, size_t size)
+{
+	if(!t || t->epoch) return NULL;
+	return trie_value_slot(t, string, size);
+}
+
 /** Removes the element mapped by `string`.
   *
   * @param t		pointer to the structure trie_t;
@@ -179,17 +401,37 @@ gerror_t trie_remove_element (struct trie_t* t, void* string, size_t size)
 {
 	if(!t) return GERROR_NULL_STRUCTURE;
 
-	struct tnode_t* node = node_at(t, string, size);
-	if(!node) return GERROR_ACCESS_OUT_OF_BOUND;
+	void* removed_value;
+	if(t->epoch){
+		art_node_t* root = t->art_root;
+		vector_t retired;
+
+		vector_create(&retired, 0, sizeof(art_node_t*));
+		GSTATS_UNREGISTER(&retired);
+		removed_value = art_remove_copy(&root, string, size, &retired);
+		if(!removed_value){
+			vector_destroy(&retired);
+			return GERROR_ACCESS_OUT_OF_BOUND;
+		}
 
-	void* removed_value = node->value;
+		t->size--;
+		epoch_retire(t->epoch, removed_value, free);
+		trie_publish(t, root, &retired);
+		return GERROR_OK;
+	}else if(t->mode == TRIE_ADAPTIVE){
+		removed_value = art_remove(&t->art_root, string, size, t->allocator);
+	}else{
+		struct tnode_t* node = node_at(t, string, size);
+		if(!node) return GERROR_ACCESS_OUT_OF_BOUND;
+
+		removed_value = node->value;
+		node->value = NULL;
+	}
 
-	node->value = NULL;
+	if(!removed_value) return GERROR_ACCESS_OUT_OF_BOUND;
 
 	t->size--;
-	void* ptr = removed_value;
-	if(ptr)
-		free(ptr);
+	GALLOC_FREE(t->allocator, removed_value, t->member_size? t->member_size : 1);
 	return GERROR_OK;
 }
 
@@ -209,13 +451,322 @@ gerror_t trie_get_element (struct trie_t* t, void* string, size_t size, void* el
 {
 	if(!t) return GERROR_NULL_STRUCTURE;
 
-	struct tnode_t* node = node_at(t, string, size);
+	void* value = trie_value_at(t, string, size);
 
-	if(node == NULL)
+	if(value == NULL)
 		return GERROR_ACCESS_OUT_OF_BOUND;
 
-	if(t->member_size)
-		memcpy(elem, node->value, t->member_size);
+	if(t->member_size && elem)
+		memcpy(elem, value, t->member_size);
+
+	return GERROR_OK;
+}
+
+/** Returns a pointer to the element mapped by `string`, without
+  * copying it. The pointer is valid until `string` is removed; in
+  * a concurrent trie it is valid only inside the read section in
+  * which it was taken, and the element must not be changed.
+  *
+  * @param t		pointer to the structure;
+  * @param string	pointer to the string of bytes to map elem;
+  * @param size		size of the string of bytes.
+  *
+  * @return	pointer to the element or NULL in case `t` is a
+  * 		NULL pointer or `string` is not mapped
+  */
+void* trie_get_ref (struct trie_t* t, void* string, size_t size)
+{
+	if(!t) return NULL;
+	return trie_value_at(t, string, size);
+}
+
+/*
+ * auxiliar function;
+ * moves the walk `l` in a dense trie one byte down and
+ * prefetches the slot the next step reads
+ *
+ * @return non-zero in case the walk ended, with the node of
+ * 	   the key or NULL in `l->node`
+ */
+int trie_lane_step_dense (trie_lane_t* l)
+{
+	tnode_t* node = (tnode_t*) l->node;
+
+	if( l->depth == l->size ) return 1;
+
+	node = node->children[l->key[l->depth++]];
+	l->node = node;
+	if( !node ) return 1;
+
+	if( l->depth < l->size )
+		TRIE_PREFETCH(&node->children[l->key[l->depth]]);
+	else
+		TRIE_PREFETCH(&node->value);
+	return 0;
+}
+
+/*
+ * auxiliar function;
+ * moves the walk `l` in an adaptive trie one node down and
+ * prefetches the header of the next node
+ *
+ * @return non-zero in case the walk ended, with the node of
+ * 	   the key or NULL in `l->node`
+ */
+int trie_lane_step_adaptive (trie_lane_t* l)
+{
+	art_node_t* node = (art_node_t*) l->node;
+
+	if( !node ) return 1;
+
+	if( node->prefix_len ){
+		if(	l->size - l->depth < node->prefix_len ||
+			memcmp(node->prefix, l->key + l->depth, node->prefix_len) ){
+			l->node = NULL;
+			return 1;
+		}
+		l->depth += node->prefix_len;
+	}
+	if( l->depth == l->size ) return 1;
+
+	art_node_t** child = art_find_child(node, l->key[l->depth++]);
+	l->node = child? *child : NULL;
+	if( !l->node ) return 1;
+
+	TRIE_PREFETCH(l->node);
+	return 0;
+}
+
+/*
+ * auxiliar function;
+ * writes the result of the ended walk `l` in `out` and `status`
+ */
+void trie_lane_finish (struct trie_t* t, trie_lane_t* l, void* out, gerror_t* status)
+{
+	void* value = NULL;
+
+	if( l->node )
+		value = t->mode == TRIE_ADAPTIVE?
+			((art_node_t*) l->node)->value :
+			((tnode_t*) l->node)->value;
+
+	if( value && out && t->member_size )
+		memcpy(out + l->index*t->member_size, value, t->member_size);
+	if( status )
+		status[l->index] = value? GERROR_OK : GERROR_ACCESS_OUT_OF_BOUND;
+}
+
+/*
+ * auxiliar function;
+ * `trie_get_many` for sorted keys: the walk of every key starts
+ * at the deepest node that the walk of the previous key reached
+ * within their common prefix
+ */
+void trie_get_sorted (struct trie_t* t, void* root, void** keys, size_t* sizes, size_t n,
+		void* out, gerror_t* status)
+{
+	int (*step)(trie_lane_t*) = t->mode == TRIE_ADAPTIVE?
+		trie_lane_step_adaptive : trie_lane_step_dense;
+	trie_lane_t lane;
+	vector_t path;
+	size_t i, common = 0;
+
+	vector_create(&path, 0, sizeof(trie_lane_t));
+	GSTATS_UNREGISTER(&path);
+
+	for(i=0; i<n; i++){
+		lane.key = (unsigned char*) keys[i];
+		lane.size = sizes[i];
+		lane.index = i;
+
+		if( i ){
+			size_t max = sizes[i-1] < sizes[i]? sizes[i-1] : sizes[i];
+			unsigned char* previous = (unsigned char*) keys[i-1];
+			for( common=0; common<max && previous[common] == lane.key[common]; common++ );
+		}
+
+		while( path.size && ((trie_lane_t*) vector_ptr_at(&path, path.size-1))->depth > common )
+			path.size--;
+
+		if( path.size ){
+			trie_lane_t* resume = (trie_lane_t*) vector_ptr_at(&path, path.size-1);
+			lane.node = resume->node;
+			lane.depth = resume->depth;
+			path.size--;
+		}else{
+			lane.node = root;
+			lane.depth = 0;
+		}
+
+		for(;;){
+			if( lane.node )
+				vector_add(&path, &lane);
+			if( step(&lane) )
+				break;
+		}
+
+		trie_lane_finish(t, &lane, out, status);
+	}
+
+	vector_destroy(&path);
+}
+
+/*
+ * auxiliar function;
+ * `trie_get_many` for unsorted keys: TRIE_LANES walks advance
+ * in turns, so the memory access of one walk is prefetched
+ * while the others advance
+ */
+void trie_get_interleaved (struct trie_t* t, void* root, void** keys, size_t* sizes, size_t n,
+		void* out, gerror_t* status)
+{
+	int (*step)(trie_lane_t*) = t->mode == TRIE_ADAPTIVE?
+		trie_lane_step_adaptive : trie_lane_step_dense;
+	trie_lane_t lanes[TRIE_LANES];
+	size_t i, next = 0, active = 0;
+
+	for(i=0; i<TRIE_LANES && next<n; i++, next++, active++){
+		lanes[i].key = (unsigned char*) keys[next];
+		lanes[i].size = sizes[next];
+		lanes[i].depth = 0;
+		lanes[i].node = root;
+		lanes[i].index = next;
+	}
+
+	while( active ){
+		for(i=0; i<active; i++){
+			if( !step(&lanes[i]) )
+				continue;
+
+			trie_lane_finish(t, &lanes[i], out, status);
+
+			if( next < n ){
+				lanes[i].key = (unsigned char*) keys[next];
+				lanes[i].size = sizes[next];
+				lanes[i].depth = 0;
+				lanes[i].node = root;
+				lanes[i].index = next++;
+			}else{
+				lanes[i--] = lanes[--active];
+			}
+		}
+	}
+}
+
+/** Looks up the `n` keys `keys[i]` of `sizes[i]` bytes and writes
+  * the element of every key in `out[i]`, as `n` calls of
+  * `trie_get_element` would. When the keys are sorted the walk of
+  * every key reuses the path of the previous key along their
+  * common prefix; otherwise several walks are interleaved, so the
+  * latency of the node accesses overlaps.
+  *
+  * @param t		pointer to the structure;
+  * @param keys		array of `n` pointers to the keys;
+  * @param sizes	array of the sizes of the keys;
+  * @param n		number of keys;
+  * @param out		room for `n` elements, or NULL; the
+  * 			elements of missing keys are not written
+  * @param status	array that receives GERROR_OK or
+  * 			GERROR_ACCESS_OUT_OF_BOUND for every key,
+  * 			or NULL
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `t`, `keys` or
+  * 		`sizes` is a NULL pointer
+  */
+gerror_t trie_get_many (struct trie_t* t, void** keys, size_t* sizes, size_t n,
+		void* out, gerror_t* status)
+{
+	if(!t || !keys || !sizes) return GERROR_NULL_STRUCTURE;
+
+	void* root = t->mode == TRIE_ADAPTIVE?
+		(void*) __atomic_load_n(&t->art_root, __ATOMIC_ACQUIRE) :
+		(void*) &t->root;
+
+	size_t i;
+	for(i=1; i<n; i++){
+		size_t max = sizes[i-1] < sizes[i]? sizes[i-1] : sizes[i];
+		int order = max? memcmp(keys[i-1], keys[i], max) : 0;
+		if( order > 0 || (order == 0 && sizes[i-1] > sizes[i]) )
+			break;
+	}
+
+	if( i >= n )
+		trie_get_sorted(t, root, keys, sizes, n, out, status);
+	else
+		trie_get_interleaved(t, root, keys, sizes, n, out, status);
+
+	return GERROR_OK;
+}
+
+/** Finds the longest key mapped in `t` that is a prefix of the
+  * `size` bytes of `string`, and writes its element in `elem`
+  * and its size in `match_size`.
+  *
+  * @param t		pointer to the structure;
+  * @param string	pointer to the string of bytes;
+  * @param size		size of the string of bytes;
+  * @param match_size	pointer that receives the size of the
+  * 			key found, or NULL
+  * @param elem		pointer to the memory allocated that will
+  * 			be write with the element, or NULL
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `t` is a NULL
+  * 		GERROR_ACCESS_OUT_OF_BOUND in case no key of `t`
+  * 		is a prefix of `string`
+  */
+gerror_t trie_longest_prefix_match (struct trie_t* t, void* string, size_t size,
+		size_t* match_size, void* elem)
+{
+	if(!t) return GERROR_NULL_STRUCTURE;
+
+	unsigned char* key = (unsigned char*) string;
+	void* value = NULL;
+	size_t match = 0, depth = 0;
+
+	if(t->mode == TRIE_ADAPTIVE){
+		art_node_t* node = __atomic_load_n(&t->art_root, __ATOMIC_ACQUIRE);
+
+		while( node ){
+			if( node->prefix_len ){
+				if(	size - depth < node->prefix_len ||
+					memcmp(node->prefix, key + depth, node->prefix_len) )
+					break;
+				depth += node->prefix_len;
+			}
+
+			if( node->value ){
+				value = node->value;
+				match = depth;
+			}
+			if( depth == size )
+				break;
+
+			art_node_t** child = art_find_child(node, key[depth++]);
+			node = child? *child : NULL;
+		}
+	}else{
+		struct tnode_t* node = &t->root;
+
+		for(;;){
+			if( node->value ){
+				value = node->value;
+				match = depth;
+			}
+			if( depth == size || !node->children[key[depth]] )
+				break;
+
+			node = node->children[key[depth++]];
+		}
+	}
+
+	if(!value) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	if(match_size)
+		*match_size = match;
+	if(t->member_size && elem)
+		memcpy(elem, value, t->member_size);
 
 	return GERROR_OK;
 }
@@ -233,12 +784,171 @@ gerror_t trie_set_element (struct trie_t* t, void* string, size_t size, void* el
 
 	if(!t) return GERROR_NULL_STRUCTURE;
 		
-	struct tnode_t* node = node_at(t, string, size);
-	if(node){
-		if(t->member_size)
-			memcpy(node->value, elem, t->member_size);
+	void* value = trie_value_at(t, string, size);
+	if(value && t->epoch)
+		return trie_add_concurrent(t, string, size, elem);
+	if(value){
+		if(t->member_size && elem)
+			memcpy(value, elem, t->member_size);
+
+	}
+
+	return GERROR_OK;
+}
+
+/*
+ * auxiliar function;
+ * counts the nodes of the dense subtree `node` in `stats`,
+ * `depth` is the number of nodes above `node`
+ */
+void trie_count_tnode (struct tnode_t* node, size_t depth, gstats_t* stats)
+{
+	int i;
+
+	stats->nodes++;
+	if( depth + 1 > stats->depth )
+		stats->depth = depth + 1;
+
+	for(i=0; i<NBYTE; i++)
+		if( node->children[i] )
+			trie_count_tnode(node->children[i], depth + 1, stats);
+}
+
+/*
+ * auxiliar function;
+ * counts the nodes of the adaptive subtree `node` in `stats`,
+ * `depth` is the number of nodes above `node`
+ */
+void trie_count_art (art_node_t* node, size_t depth, gstats_t* stats)
+{
+	unsigned char keys[NBYTE];
+	art_node_t* children[NBYTE];
+	size_t i, n = art_children(node, keys, children);
+
+	stats->nodes++;
+	if( depth + 1 > stats->depth )
+		stats->depth = depth + 1;
+
+	for(i=0; i<n; i++)
+		trie_count_art(children[i], depth + 1, stats);
+}
+
+/*
+ * auxiliar function;
+ * `art_walk` for the dense nodes: `key` holds the bytes of the
+ * path to `node`
+ *
+ * @return non-zero in case `visit` stopped the walk
+ */
+int trie_walk_tnode (struct tnode_t* node, vector_t* key, trie_visit_function visit, void* argument)
+{
+	size_t depth = key->size;
+	int i;
+
+	if( node->value && visit(key->data, depth, node->value, argument) )
+		return 1;
+
+	for(i=0; i<NBYTE; i++){
+		unsigned char byte = (unsigned char)i;
+		if( !node->children[i] ) continue;
 
+		key->size = depth;
+		vector_append_n(key, &byte, 1);
+		if( trie_walk_tnode(node->children[i], key, visit, argument) )
+			return 1;
 	}
 
+	return 0;
+}
+
+/** Calls `visit` on every element of `t` in lexicographic order
+  * of the keys, see `trie_foreach_prefix`.
+  *
+  * @param t		pointer to the structure;
+  * @param visit	function called on every element
+  * @param argument	argument passed to `visit`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `t` or `visit` is
+  * 		a NULL pointer
+  */
+gerror_t trie_foreach (struct trie_t* t, trie_visit_function visit, void* argument)
+{
+	return trie_foreach_prefix(t, NULL, 0, visit, argument);
+}
+
+/** Calls `visit` on every element of `t` whose key starts with
+  * the `size` bytes of `string`, in lexicographic order of the
+  * keys, with the key and a pointer to the element in the trie.
+  * A key is visited before the longer keys that start with it.
+  * `visit` may change the elements but not add or remove them.
+  * A concurrent trie may be walked inside a read section.
+  *
+  * @param t		pointer to the structure;
+  * @param string	pointer to the prefix of the keys;
+  * @param size		size of the prefix, 0 for every key;
+  * @param visit	function called on every element
+  * @param argument	argument passed to `visit`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `t` or `visit` is
+  * 		a NULL pointer
+  */
+gerror_t trie_foreach_prefix (struct trie_t* t, void* string, size_t size,
+		trie_visit_function visit, void* argument)
+{
+	if(!t || !visit) return GERROR_NULL_STRUCTURE;
+
+	if(t->mode == TRIE_ADAPTIVE){
+		art_foreach(__atomic_load_n(&t->art_root, __ATOMIC_ACQUIRE),
+				string, size, visit, argument);
+		return GERROR_OK;
+	}
+
+	struct tnode_t* node = size? node_at(t, string, size) : &t->root;
+	if(!node) return GERROR_OK;
+
+	vector_t key;
+	vector_create(&key, 0, sizeof(unsigned char));
+	GSTATS_UNREGISTER(&key);
+	vector_append_n(&key, string, size);
+
+	trie_walk_tnode(node, &key, visit, argument);
+	vector_destroy(&key);
+
+	return GERROR_OK;
+}
+
+/** Writes the counters of `t` in `stats`, see gstats.h. The
+  * nodes and the depth are counted walking the trie, the root
+  * is included in both.
+  *
+  * @param t		pointer to the structure;
+  * @param stats	pointer to the structure that receives
+  * 			the counters
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `t` or `stats` is a NULL
+  * 		GERROR_UNSUPPORTED_OPERATION in case the library
+  * 		was built without GENERICS_STATS
+  */
+gerror_t trie_get_stats (struct trie_t* t, gstats_t* stats)
+{
+	if(!t || !stats) return GERROR_NULL_STRUCTURE;
+
+#ifdef GENERICS_STATS
+	*stats = t->stats.counters;
+	stats->size = t->size;
+	stats->nodes = stats->depth = 0;
+
+	if(t->mode == TRIE_ADAPTIVE){
+		if(t->art_root)
+			trie_count_art(t->art_root, 0, stats);
+	}else{
+		trie_count_tnode(&t->root, 0, stats);
+	}
 	return GERROR_OK;
+#else
+	return GERROR_UNSUPPORTED_OPERATION;
+#endif
 }
@@ -0,0 +1,454 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "trie_map.h"
+#include "vector.h"
+
+#define TRIE_MAP_ALIGN(n) (((n) + 7) & ~(size_t)7)
+
+/*
+ * fixed part of a node record
+ */
+typedef struct trie_map_node_t{
+	uint64_t value;
+	uint32_t prefix_len;
+	uint32_t n_children;
+}trie_map_node_t;
+
+/*
+ * auxiliar function;
+ * appends to `out` the record of a node and returns its offset
+ */
+uint64_t trie_map_write (vector_t* out, size_t member_size, void* value,
+		unsigned char* prefix, size_t prefix_len,
+		unsigned char* keys, uint64_t* children, size_t n)
+{
+	size_t at = out->size;
+	size_t bytes = sizeof(trie_map_node_t) + n*sizeof(uint64_t) + prefix_len + n;
+	size_t value_at = TRIE_MAP_ALIGN(bytes);
+
+	if( value )
+		bytes = value_at + member_size;
+
+	vector_append_n(out, NULL, TRIE_MAP_ALIGN(bytes));
+
+	void* record = out->data + at;
+	memset(record, 0, TRIE_MAP_ALIGN(bytes));
+
+	trie_map_node_t node;
+	node.value = value? at + value_at : TRIE_MAP_NONE;
+	node.prefix_len = (uint32_t)prefix_len;
+	node.n_children = (uint32_t)n;
+
+	memcpy(record, &node, sizeof(node));
+	record += sizeof(node);
+	memcpy(record, children, n*sizeof(uint64_t));
+	record += n*sizeof(uint64_t);
+	if( prefix_len )
+		memcpy(record, prefix, prefix_len);
+	record += prefix_len;
+	memcpy(record, keys, n);
+
+	if( value )
+		memcpy(out->data + at + value_at, value, member_size);
+
+	return at;
+}
+
+/*
+ * auxiliar function;
+ * appends the record of a node whose children were already
+ * written. A node with no element and a single child is not
+ * written at all: its prefix and the byte of the child are
+ * prepended to the prefix of the child, whose record is the
+ * last one of `out` and is written again.
+ *
+ * @return the offset of the record or TRIE_MAP_NONE in case
+ * 	   the node maps no element.
+ */
+uint64_t trie_map_emit (vector_t* out, size_t member_size, void* value,
+		unsigned char* prefix, size_t prefix_len,
+		unsigned char* keys, uint64_t* children, size_t n)
+{
+	if( !value && !n ) return TRIE_MAP_NONE;
+	if( value || n > 1 )
+		return trie_map_write(out, member_size, value, prefix, prefix_len, keys, children, n);
+
+	size_t at = (size_t)children[0];
+	size_t bytes = out->size - at;
+	void* copy = malloc(bytes);
+	memcpy(copy, out->data + at, bytes);
+
+	trie_map_node_t child;
+	memcpy(&child, copy, sizeof(child));
+
+	uint64_t* child_children = (uint64_t*)(copy + sizeof(child));
+	unsigned char* child_prefix = (unsigned char*)(child_children + child.n_children);
+	unsigned char* child_keys = child_prefix + child.prefix_len;
+	void* child_value = NULL;
+	if( child.value != TRIE_MAP_NONE )
+		child_value = copy + (size_t)(child.value - at);
+
+	size_t merged_len = prefix_len + 1 + child.prefix_len;
+	unsigned char* merged = (unsigned char*) malloc(merged_len);
+	if( prefix_len )
+		memcpy(merged, prefix, prefix_len);
+	merged[prefix_len] = keys[0];
+	memcpy(merged + prefix_len + 1, child_prefix, child.prefix_len);
+
+	out->size = at;
+	uint64_t offset = trie_map_write(out, member_size, child_value,
+			merged, merged_len, child_keys, child_children, child.n_children);
+
+	free(merged);
+	free(copy);
+	return offset;
+}
+
+/*
+ * auxiliar function;
+ * writes the subtree of a dense node in post-order
+ */
+uint64_t trie_map_emit_dense (vector_t* out, size_t member_size, tnode_t* node)
+{
+	unsigned char keys[NBYTE];
+	uint64_t* children = (uint64_t*) malloc(NBYTE*sizeof(uint64_t));
+	size_t n = 0;
+	int i;
+
+	for( i=0; i<NBYTE; i++ ){
+		if( !node->children[i] ) continue;
+
+		uint64_t offset = trie_map_emit_dense(out, member_size, node->children[i]);
+		if( offset != TRIE_MAP_NONE ){
+			keys[n] = (unsigned char)i;
+			children[n++] = offset;
+		}
+	}
+
+	uint64_t offset = trie_map_emit(out, member_size, node->value, NULL, 0, keys, children, n);
+	free(children);
+	return offset;
+}
+
+/*
+ * auxiliar function;
+ * writes the subtree of an adaptive node in post-order
+ */
+uint64_t trie_map_emit_adaptive (vector_t* out, size_t member_size, art_node_t* node)
+{
+	unsigned char keys[NBYTE];
+	art_node_t** nodes = (art_node_t**) malloc(NBYTE*sizeof(art_node_t*));
+	uint64_t* children = (uint64_t*) malloc(NBYTE*sizeof(uint64_t));
+	size_t i, n = 0;
+	size_t n_nodes = art_children(node, keys, nodes);
+
+	for( i=0; i<n_nodes; i++ ){
+		uint64_t offset = trie_map_emit_adaptive(out, member_size, nodes[i]);
+		if( offset != TRIE_MAP_NONE ){
+			keys[n] = keys[i];
+			children[n++] = offset;
+		}
+	}
+
+	uint64_t offset = trie_map_emit(out, member_size, node->value,
+			node->prefix, node->prefix_len, keys, children, n);
+	free(children);
+	free(nodes);
+	return offset;
+}
+
+/** Freezes the trie `t`: writes to the file `path` a compact,
+  * pointer-free and read-only image of `t` that can be opened
+  * with `trie_map_open`. Chains of nodes with only one child
+  * are collapsed and the children are stored as sorted arrays
+  * of bytes. The trie `t` is not changed.
+  *
+  * @param t		pointer to the trie structure;
+  * @param path		path of the file to be written
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `t` is a NULL
+  * 		GERROR_IO in case the file could not be written
+  */
+gerror_t trie_freeze (struct trie_t* t, const char* path)
+{
+	if(!t) return GERROR_NULL_STRUCTURE;
+
+	vector_t out;
+	vector_create(&out, 0, 1);
+	GSTATS_UNREGISTER(&out);
+	vector_append_n(&out, NULL, TRIE_MAP_ALIGN(sizeof(trie_map_header_t)));
+
+	trie_map_header_t header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, TRIE_MAP_MAGIC, sizeof(header.magic));
+	header.version = TRIE_MAP_VERSION;
+	header.member_size = t->member_size;
+	header.size = t->size;
+
+	if( t->mode == TRIE_ADAPTIVE )
+		header.root = t->art_root?
+			trie_map_emit_adaptive(&out, t->member_size, t->art_root) :
+			TRIE_MAP_NONE;
+	else
+		header.root = trie_map_emit_dense(&out, t->member_size, &t->root);
+
+	header.length = out.size;
+	memcpy(out.data, &header, sizeof(header));
+
+	gerror_t s = GERROR_OK;
+	FILE* file = fopen(path, "wb");
+	if( !file || fwrite(out.data, 1, out.size, file) != out.size )
+		s = GERROR_IO;
+	if( file && fclose(file) )
+		s = GERROR_IO;
+
+	vector_destroy(&out);
+	return s;
+}
+
+/*
+ * auxiliar function;
+ * the record at `offset` of the mapping of `m` or NULL in case
+ * the record, its arrays or its element do not fit in the
+ * mapping. The lengths are bound by 32 bits, so none of the
+ * sums below overflows.
+ */
+trie_map_node_t* trie_map_node_at (struct trie_map_t* m, uint64_t offset)
+{
+	uint64_t length = m->length;
+
+	if(	offset % 8 || offset < TRIE_MAP_ALIGN(sizeof(trie_map_header_t)) ||
+		offset > length - sizeof(trie_map_node_t) )
+		return NULL;
+
+	trie_map_node_t* node = (trie_map_node_t*)(m->base + offset);
+	uint64_t bytes = (uint64_t)node->n_children*(sizeof(uint64_t) + 1) + node->prefix_len;
+	if( bytes > length - offset - sizeof(trie_map_node_t) )
+		return NULL;
+
+	if(	node->value != TRIE_MAP_NONE &&
+		(node->value > length || m->member_size > length - node->value) )
+		return NULL;
+
+	return node;
+}
+
+/*
+ * auxiliar function;
+ * points `value` to the element mapped by `string` or to NULL.
+ * Every record is checked against the bounds of the mapping on
+ * the way, and the children come before their parent, so a
+ * corrupt image can neither read out of the mapping nor loop.
+ *
+ * @return	GERROR_OK in case the walk ended;
+ * 		GERROR_INVALID_FORMAT in case a record is corrupt
+ */
+gerror_t trie_map_lookup (struct trie_map_t* m, void* string, size_t size, void** value)
+{
+	unsigned char* key = (unsigned char*) string;
+	uint64_t offset = m->root;
+	size_t depth = 0;
+
+	*value = NULL;
+	if( offset == TRIE_MAP_NONE ) return GERROR_OK;
+
+	for(;;){
+		trie_map_node_t* node = trie_map_node_at(m, offset);
+		if( !node ) return GERROR_INVALID_FORMAT;
+
+		uint64_t* children = (uint64_t*)(node + 1);
+		unsigned char* prefix = (unsigned char*)(children + node->n_children);
+		unsigned char* keys = prefix + node->prefix_len;
+
+		if( node->prefix_len ){
+			if(	size - depth < node->prefix_len ||
+				memcmp(prefix, key + depth, node->prefix_len) )
+				return GERROR_OK;
+			depth += node->prefix_len;
+		}
+
+		if( depth == size ){
+			if( node->value != TRIE_MAP_NONE )
+				*value = m->base + node->value;
+			return GERROR_OK;
+		}
+
+		size_t low = 0, high = node->n_children;
+		while( low < high ){
+			size_t middle = (low + high)/2;
+			if( keys[middle] < key[depth] )
+				low = middle + 1;
+			else
+				high = middle;
+		}
+		if( low == node->n_children || keys[low] != key[depth] )
+			return GERROR_OK;
+
+		if( children[low] >= offset ) return GERROR_INVALID_FORMAT;
+		offset = children[low];
+		depth++;
+	}
+}
+
+/** Maps read-only the frozen trie in the file `path`. The pages
+  * of the file are shared by every process that maps it and no
+  * node is built: the lookups run directly on the mapping.
+  *
+  * Only the header and the root are checked here, so the pages
+  * are not read up front; the lookups check every record they
+  * reach against the bounds of the mapping.
+  *
+  * @param m		pointer to a trie_map_t structure;
+  * @param path		path of a file written by `trie_freeze`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `m` is a NULL
+  * 		GERROR_IO in case the file could not be mapped
+  * 		GERROR_INVALID_FORMAT in case the file is not a
+  * 		frozen trie of this version
+  */
+gerror_t trie_map_open (struct trie_map_t* m, const char* path)
+{
+	if(!m) return GERROR_NULL_STRUCTURE;
+
+	int fd = open(path, O_RDONLY);
+	if( fd < 0 ) return GERROR_IO;
+
+	struct stat st;
+	if( fstat(fd, &st) ){
+		close(fd);
+		return GERROR_IO;
+	}
+
+	size_t length = (size_t)st.st_size;
+	if( length < sizeof(trie_map_header_t) ){
+		close(fd);
+		return GERROR_INVALID_FORMAT;
+	}
+
+	void* base = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if( base == MAP_FAILED ) return GERROR_IO;
+
+	trie_map_header_t header;
+	memcpy(&header, base, sizeof(header));
+	if(	memcmp(header.magic, TRIE_MAP_MAGIC, sizeof(header.magic)) ||
+		header.version != TRIE_MAP_VERSION ||
+		header.length != length ){
+		munmap(base, length);
+		return GERROR_INVALID_FORMAT;
+	}
+
+	m->base = base;
+	m->length = length;
+	m->size = (size_t)header.size;
+	m->member_size = (size_t)header.member_size;
+	m->root = header.root;
+
+	if(	header.member_size > length ||
+		(m->root != TRIE_MAP_NONE && !trie_map_node_at(m, m->root)) ){
+		trie_map_close(m);
+		return GERROR_INVALID_FORMAT;
+	}
+
+	return GERROR_OK;
+}
+
+/** Unmaps the frozen trie `m`. The pointer `m` is not freed.
+  *
+  * @param m		pointer to a trie_map_t structure;
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `m` is a NULL
+  */
+gerror_t trie_map_close (struct trie_map_t* m)
+{
+	if(!m) return GERROR_NULL_STRUCTURE;
+
+	if( m->base )
+		munmap(m->base, m->length);
+
+	m->base = NULL;
+	m->length = m->size = m->member_size = 0;
+	m->root = TRIE_MAP_NONE;
+
+	return GERROR_OK;
+}
+
+/** Returns a pointer to the element mapped by `string` inside
+  * the mapping of `m`, without copying it. The element is
+  * read-only and valid until `trie_map_close`.
+  *
+  * @param m		pointer to a trie_map_t structure;
+  * @param string	pointer to the string of bytes;
+  * @param size		size of the string of bytes.
+  *
+  * @return	pointer to the element or NULL in case `string`
+  * 		is not mapped or the image is corrupt
+  */
+void* trie_map_get_ref (struct trie_map_t* m, void* string, size_t size)
+{
+	void* value;
+
+	if( !m || !m->base ) return NULL;
+	if( trie_map_lookup(m, string, size, &value) != GERROR_OK ) return NULL;
+
+	return value;
+}
+
+/** Copies the element mapped by `string` in the frozen trie `m`.
+  *
+  * @param m		pointer to a trie_map_t structure;
+  * @param string	pointer to the string of bytes;
+  * @param size		size of the string of bytes.
+  * @param elem		pointer to the memory allocated that
+  * 			will be write with the elem mapped by `string`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `m` is a NULL
+  * 		GERROR_ACCESS_OUT_OF_BOUND in case `string` is
+  * 		not mapped
+  * 		GERROR_INVALID_FORMAT in case a record on the
+  * 		way is corrupt
+  */
+gerror_t trie_map_get_element (struct trie_map_t* m, void* string, size_t size, void* elem)
+{
+	if(!m) return GERROR_NULL_STRUCTURE;
+	if(!m->base) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	void* value;
+	gerror_t s = trie_map_lookup(m, string, size, &value);
+	if( s != GERROR_OK ) return s;
+	if( !value ) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	if( m->member_size && elem )
+		memcpy(elem, value, m->member_size);
+
+	return GERROR_OK;
+}
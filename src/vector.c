@@ -17,10 +17,65 @@
  * For more information, please refer to <http://unlicense.org/>
  */
 #include "vector.h"
+#include "epoch.h"
 
 #define VECTOR_MIN_SIZ 8
+#define VECTOR_GROWTH_FACTOR 2.0
 size_t	vector_min_siz = VECTOR_MIN_SIZ;
 
+/*
+ * auxiliar function;
+ * reallocates the buffer of `v` to `new_size` bytes
+ */
+void vector_realloc (vector_t* v, size_t new_size)
+{
+	if( new_size == v->buffer_size ) return;
+
+	GSTATS_ADD(v, reallocations, 1);
+	GSTATS_ADD(v, bytes_moved, new_size < v->buffer_size? new_size : v->buffer_size);
+	if( !v->epoch ){
+		v->data = GALLOC_REALLOC(v->allocator, v->data, v->buffer_size, new_size);
+		v->buffer_size = new_size;
+		return;
+	}
+
+	/*
+	 * readers may hold the old buffer, so it is retired instead
+	 * of reallocated; a reader that sees the old size may also
+	 * see the new buffer, hence the buffer never shrinks
+	 */
+	if( new_size < v->buffer_size ) return;
+
+	void* data = GALLOC_ALLOC(v->allocator, new_size);
+	memcpy(data, v->data, v->buffer_size);
+	void* old = v->data;
+	__atomic_store_n(&v->data, data, __ATOMIC_RELEASE);
+	v->buffer_size = new_size;
+
+	epoch_retire(v->epoch, old, free);
+	epoch_try_advance(v->epoch);
+}
+
+/*
+ * auxiliar function;
+ * sets the number of elements of `v`, the elements below
+ * `size` must be written before
+ */
+void vector_set_size (vector_t* v, size_t size)
+{
+	__atomic_store_n(&v->size, size, __ATOMIC_RELEASE);
+	GSTATS_PEAK(v, size);
+}
+
+/*
+ * auxiliar function;
+ * `vector_get_stats` for the registry
+ */
+gerror_t vector_stats_of (void* v, gstats_t* stats)
+{
+	return vector_get_stats((vector_t*) v, stats);
+}
+
 /** Populate the `vetor_t` structure pointed by `v`
   * and allocates `member_size`*`initial_size` for initial buffer_size.
   *
@@ -37,16 +92,47 @@ size_t	vector_min_siz = VECTOR_MIN_SIZ;
   */
 gerror_t vector_create (vector_t* v, size_t initial_buf_siz, size_t member_size)
 {
-	if(!v) return GERROR_NULL_STRUCTURE;
+	return vector_create_with_allocator(v, initial_buf_siz, member_size, &galloc_default);
+}
+
+/** Populate the `vetor_t` structure pointed by `v` as
+  * `vector_create` does, but the buffer comes from `allocator`.
+  *
+  * @param v			a pointer to `vector_t` structure
+  *				already allocated;
+  * @param inicial_buf_size	number of the members of the initial
+  * 				allocated buffer;
+  * @param member_size		size of every member indexed by `v`;
+  * @param allocator		allocator of the buffer.
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `v` or `allocator`
+  * 		is a NULL pointer
+  */
+gerror_t vector_create_with_allocator (vector_t* v, size_t initial_buf_siz, size_t member_size,
+		const galloc_t* allocator)
+{
+	if(!v || !allocator) return GERROR_NULL_STRUCTURE;
+
+	size_t min_size = __atomic_load_n(&vector_min_siz, __ATOMIC_RELAXED);
 
 	v->size = 0;
 	v->member_size = member_size;
-	if ( initial_buf_siz < vector_min_siz )
-		v->buffer_size = vector_min_siz*member_size;
+	v->min_size = min_size;
+	v->growth_factor = VECTOR_GROWTH_FACTOR;
+	v->growth_cap = 0;
+	v->epoch = NULL;
+	v->allocator = allocator;
+	if ( initial_buf_siz < min_size )
+		v->buffer_size = min_size*member_size;
 	else
 		v->buffer_size = initial_buf_siz*member_size;
 
-	v->data = malloc(v->buffer_size);
+	v->data = GALLOC_ALLOC(v->allocator, v->buffer_size);
+
+	GSTATS_INIT(v);
+	GSTATS_ADD(v, allocations, 1);
+	GSTATS_REGISTER(v, "vector", vector_stats_of);
 	return GERROR_OK;
 }
 
@@ -63,7 +149,8 @@ gerror_t vector_destroy (vector_t* v)
 	
 	if( !v ) return GERROR_NULL_STRUCTURE;
 
-	free(v->data);
+	GSTATS_UNREGISTER(v);
+	GALLOC_FREE(v->allocator, v->data, v->buffer_size);
 	v->buffer_size = 0;
 	v->member_size = 0;
 	v->data = NULL;
@@ -72,8 +159,39 @@ gerror_t vector_destroy (vector_t* v)
 
 }
 
+/** Lets readers run concurrently with a single writer of `v`:
+  * `vector_ptr_at` and `vector_at` need no lock as long as the
+  * reader is inside a read section of `e`, and the old buffers
+  * are freed by `e` when no reader can hold them anymore. The
+  * buffer of `v` never shrinks while `e` is set, and it must
+  * come from the default allocator.
+  *
+  * The elements are published by `vector_add` and
+  * `vector_append_n`; the other changes write the elements in
+  * place, so readers may see them half written.
+  *
+  * @param v	a pointer to `vector_t` structure
+  * @param e	the epoch domain of the readers or NULL to
+  * 		leave the concurrent mode
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `v` is a NULL
+  * 		pointer
+  * 		GERROR_UNSUPPORTED_OPERATION in case `v` has
+  * 		another allocator
+  */
+gerror_t vector_set_epoch (vector_t* v, struct epoch_t* e)
+{
+	if( !v ) return GERROR_NULL_STRUCTURE;
+	if( v->allocator != &galloc_default ) return GERROR_UNSUPPORTED_OPERATION;
+
+	v->epoch = e;
+
+	return GERROR_OK;
+}
+
 /** Returns the `vector_min_siz`: a private variable that holds
-  * the minimal number of elements that `vector_t` will index.
+  * the minimal number of elements that a new `vector_t` will index.
   * This variable is important for avoid multiple small resizes
   * in the `vector_t` container.
   *
@@ -81,19 +199,21 @@ gerror_t vector_destroy (vector_t* v)
   */
 size_t vector_get_min_buf_siz (void)
 {
-	return vector_min_siz;
+	return __atomic_load_n(&vector_min_siz, __ATOMIC_RELAXED);
 }
 
 /** Set the `vector_min_siz`: a private variable that holds
-  * the minimal number of elements that `vector_t` will index.
+  * the minimal number of elements that a new `vector_t` will index.
   * This variable is important for avoid multiple small resizes
-  * in the `vector_t` container.
+  * in the `vector_t` container. The vectors already created keep
+  * their own `min_size`, so the threads may create vectors
+  * while it changes.
   *
   * @param new_min_buf_siz the new size of `vector_min_siz`
   */
 void vector_set_min_buf_siz (size_t new_min_buf_siz)
 {
-	vector_min_siz = new_min_buf_siz;
+	__atomic_store_n(&vector_min_siz, new_min_buf_siz, __ATOMIC_RELAXED);
 }
 
 /** Resize the buffer in the `vector_t` strucuture
@@ -108,41 +228,128 @@ gerror_t vector_resize_buffer (vector_t* v, size_t n_elements)
 	if(!v) return GERROR_NULL_STRUCTURE;
 
 	size_t new_proposed_size = n_elements*v->member_size;
-	size_t new_actual_size;
+	size_t room_size = v->buffer_size/v->member_size;
 
 	/*
 	 * update the size if need
 	 */
 	if( n_elements < v->size )
-		v->size = n_elements;
+		vector_set_size(v, n_elements);
 
 	/*
-	 * resize the buffer if the size proposed is bigger.
-	 * if the size proposed is not much bigger than member
-	 * size so a bigger resize value is set. This is to
-	 * prevent multiple small resizes.
+	 * the growth follows the growth policy of `v`, so
+	 * multiple small resizes cost amortized O(1) each.
 	 *
 	 * if the size proposed is less than buffer the buffer
-	 * is resized if the less is bigger than vector_min_siz
-	 * else vector_min_siz will be the newsize.
+	 * is resized if the less is bigger than `v->min_size`
+	 * else `v->min_size` will be the newsize.
 	 */
-	size_t min_resize = vector_min_siz*v->member_size;
-	if( new_proposed_size >= v->buffer_size ){
-		size_t buffer_size_diff = new_proposed_size - v->buffer_size;
-		if(	buffer_size_diff < min_resize )
-			new_actual_size = v->buffer_size + min_resize;
-		else
-			new_actual_size = new_proposed_size;
-	}else{
-		if(new_proposed_size < min_resize )
-			new_actual_size = min_resize;
-		else
-			new_actual_size = new_proposed_size;
-	}
-	if( new_actual_size != v->buffer_size ){
-		v->data = realloc(v->data, new_actual_size);
-		v->buffer_size = new_actual_size;
-	}
+	if( n_elements > room_size )
+		return vector_grow(v, n_elements);
+
+	size_t min_resize = v->min_size*v->member_size;
+	if( new_proposed_size < min_resize )
+		new_proposed_size = min_resize;
+	vector_realloc(v, new_proposed_size);
+
+	return GERROR_OK;
+}
+
+/** Sets the growth policy of the vector `v`. When `v` is full
+  * the buffer is multiplied by `growth_factor`, but it never
+  * grows more than `growth_cap` elements at once.
+  *
+  * @param v		a pointer to `vector_t`
+  * @param growth_factor	factor by which the buffer grows,
+  * 			it has to be bigger than 1
+  * @param growth_cap	maximum number of elements added by a
+  * 			single growth or 0 for no limit
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `v` is a NULL
+  * 		pointer
+  * 		GERROR_INVALID_ARGUMENT in case `growth_factor`
+  * 		is not bigger than 1
+  */
+gerror_t vector_set_growth_policy (vector_t* v, double growth_factor, size_t growth_cap)
+{
+	if(!v) return GERROR_NULL_STRUCTURE;
+	if(!(growth_factor > 1.0)) return GERROR_INVALID_ARGUMENT;
+
+	v->growth_factor = growth_factor;
+	v->growth_cap = growth_cap;
+
+	return GERROR_OK;
+}
+
+/** Makes room for at least `n_elements` in the buffer of `v`
+  * following the growth policy of `v`, so a sequence of small
+  * growths costs amortized O(1) per element. The buffer is
+  * never shrunk.
+  *
+  * @param v		a pointer to `vector_t`
+  * @param n_elements	number of elements that must fit
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `v` is a NULL
+  * 		pointer
+  */
+gerror_t vector_grow (vector_t* v, size_t n_elements)
+{
+	if(!v) return GERROR_NULL_STRUCTURE;
+
+	size_t room_size = v->buffer_size/v->member_size;
+	if( n_elements <= room_size ) return GERROR_OK;
+
+	size_t new_room = (size_t)(room_size*v->growth_factor);
+	if( v->growth_cap && new_room - room_size > v->growth_cap )
+		new_room = room_size + v->growth_cap;
+	if( new_room < n_elements )
+		new_room = n_elements;
+	if( new_room < v->min_size )
+		new_room = v->min_size;
+
+	vector_realloc(v, new_room*v->member_size);
+
+	return GERROR_OK;
+}
+
+/** Makes room for exactly `n_elements` in the buffer of `v`,
+  * if it does not have that room yet. A loader that knows how
+  * many elements it will add may allocate all of them at once.
+  *
+  * @param v		a pointer to `vector_t`
+  * @param n_elements	number of elements that must fit
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `v` is a NULL
+  * 		pointer
+  */
+gerror_t vector_reserve (vector_t* v, size_t n_elements)
+{
+	if(!v) return GERROR_NULL_STRUCTURE;
+
+	if( n_elements*v->member_size > v->buffer_size )
+		vector_realloc(v, n_elements*v->member_size);
+
+	return GERROR_OK;
+}
+
+/** Shrinks the buffer of `v` to its number of elements, giving
+  * the unused memory back. An empty vector keeps room for one
+  * element.
+  *
+  * @param v		a pointer to `vector_t`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCURE in case `v` is a NULL
+  * 		pointer
+  */
+gerror_t vector_shrink_to_fit (vector_t* v)
+{
+	if(!v) return GERROR_NULL_STRUCTURE;
+
+	vector_realloc(v, (v->size? v->size : 1)*v->member_size);
 
 	return GERROR_OK;
 }
@@ -161,11 +368,12 @@ gerror_t vector_resize_buffer (vector_t* v, size_t n_elements)
   */
 gerror_t vector_at (vector_t* v, size_t index, void* elem)
 {
-	size_t at = index*v->member_size;
 	if( !v ) return GERROR_NULL_STRUCTURE;
-	if( !v->buffer_size || at >= v->buffer_size ) return GERROR_ACCESS_OUT_OF_BOUND;
 
-	if(elem) memcpy(elem, (v->data + at), v->member_size);
+	void* ptr = vector_ptr_at(v, index);
+	if( !ptr ) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	if(elem) memcpy(elem, ptr, v->member_size);
 
 	return GERROR_OK;
 }
@@ -210,15 +418,188 @@ gerror_t vector_add (vector_t* v, void* elem)
 	size_t room_size = v->buffer_size/v->member_size;
 
 	if( room_size < (v->size+1) )
-		vector_resize_buffer(v, v->size+1);
+		vector_grow(v, v->size+1);
 
 	gerror_t s = vector_set_elem_at(v, v->size, elem);
-	v->size++;
+	vector_set_size(v, v->size + 1);
 
 	if(s != GERROR_OK) return s;
 	return GERROR_OK;
 }
 
+/** adds an element at the end of the structure `vector_t` pointed
+  * by `v` and returns its slot, so the caller writes it in place
+  * instead of copying it from a temporary. The slot is not
+  * initialized. The readers of a vector with an epoch must never
+  * see an element being written, so it has no emplace.
+  *
+  * @param v	a pointer to `vector_t`
+  *
+  * @return	pointer to the slot of the new element or NULL in
+  * 		case `v` is a NULL pointer or has an epoch
+  */
+void* vector_emplace (vector_t* v)
+{
+	if( !v || v->epoch ) return NULL;
+
+	vector_append_n(v, NULL, 1);
+	return v->data + (v->size - 1)*v->member_size;
+}
+
+/** adds the `n` elements of the array `elems` at the end of the
+  * structure `vector_t` pointed by `v`, with a single capacity
+  * check and a single memcpy.
+  *
+  * @param v	a pointer to `vector_t`
+  * @param elems	pointer to `n` contiguous elements or NULL,
+  * 		in which case the new elements are not written
+  * @param n	number of elements to add
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCTURE in case `v` is a NULL
+  * 		pointer
+  */
+gerror_t vector_append_n (vector_t* v, void* elems, size_t n)
+{
+	if( !v ) return GERROR_NULL_STRUCTURE;
+
+	vector_grow(v, v->size + n);
+	if( elems )
+		memcpy(v->data + v->size*v->member_size, elems, n*v->member_size);
+	vector_set_size(v, v->size + n);
+
+	return GERROR_OK;
+}
+
+/** inserts the `n` elements of the array `elems` before the
+  * position `index` of the structure `vector_t` pointed by `v`.
+  * The elements after `index` are moved with a single memmove.
+  *
+  * @param v	a pointer to `vector_t`
+  * @param index	position of the first inserted element,
+  * 		`v->size` appends the elements
+  * @param elems	pointer to `n` contiguous elements or NULL,
+  * 		in which case the new elements are not written
+  * @param n	number of elements to insert
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCTURE in case `v` is a NULL
+  * 		pointer
+  * 		GERROR_ACCESS_OUT_OF_BOUND in case `index` is
+  * 		bigger than `v->size`
+  */
+gerror_t vector_insert_range (vector_t* v, size_t index, void* elems, size_t n)
+{
+	if( !v ) return GERROR_NULL_STRUCTURE;
+	if( index > v->size ) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	vector_grow(v, v->size + n);
+
+	void* at = v->data + index*v->member_size;
+	memmove(at + n*v->member_size, at, (v->size - index)*v->member_size);
+	GSTATS_ADD(v, bytes_moved, (v->size - index)*v->member_size);
+	if( elems )
+		memcpy(at, elems, n*v->member_size);
+	vector_set_size(v, v->size + n);
+
+	return GERROR_OK;
+}
+
+/** removes the `n` elements starting at the position `index`
+  * of the structure `vector_t` pointed by `v`. The elements after
+  * the range are moved with a single memmove and the buffer is
+  * not shrunk.
+  *
+  * @param v	a pointer to `vector_t`
+  * @param index	position of the first removed element
+  * @param n	number of elements to remove
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCTURE in case `v` is a NULL
+  * 		pointer
+  * 		GERROR_ACCESS_OUT_OF_BOUND in case the range is
+  * 		not inside the vector
+  */
+gerror_t vector_erase_range (vector_t* v, size_t index, size_t n)
+{
+	if( !v ) return GERROR_NULL_STRUCTURE;
+	if( index > v->size || n > v->size - index )
+		return GERROR_ACCESS_OUT_OF_BOUND;
+
+	void* at = v->data + index*v->member_size;
+	memmove(at, at + n*v->member_size, (v->size - index - n)*v->member_size);
+	GSTATS_ADD(v, bytes_moved, (v->size - index - n)*v->member_size);
+	vector_set_size(v, v->size - n);
+
+	return GERROR_OK;
+}
+
+/** removes all the elements of the structure `vector_t` pointed
+  * by `v`, keeping the buffer for the next elements.
+  *
+  * @param v	a pointer to `vector_t`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCTURE in case `v` is a NULL
+  * 		pointer
+  */
+gerror_t vector_clear (vector_t* v)
+{
+	if( !v ) return GERROR_NULL_STRUCTURE;
+
+	vector_set_size(v, 0);
+
+	return GERROR_OK;
+}
+
+/** Calls `visit` on every element of `v`, from the first to the
+  * last, with a pointer to the element in the buffer. `visit`
+  * may change the elements but not add or remove them.
+  *
+  * @param v		a pointer to `vector_t`
+  * @param visit	function called on every element
+  * @param argument	argument passed to `visit`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCTURE in case `v` or `visit` is
+  * 		a NULL pointer
+  */
+gerror_t vector_foreach (vector_t* v, vector_visit_function visit, void* argument)
+{
+	if( !v || !visit ) return GERROR_NULL_STRUCTURE;
+
+	size_t i;
+	for( i=0; i<v->size; i++ )
+		if( visit(v->data + i*v->member_size, i, argument) )
+			break;
+
+	return GERROR_OK;
+}
+
+/** Writes the counters of `v` in `stats`, see gstats.h.
+  *
+  * @param v		a pointer to `vector_t`
+  * @param stats	pointer to the structure that receives
+  * 			the counters
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCTURE in case `v` or `stats` is
+  * 		a NULL pointer
+  * 		GERROR_UNSUPPORTED_OPERATION in case the library
+  * 		was built without GENERICS_STATS
+  */
+gerror_t vector_get_stats (vector_t* v, gstats_t* stats)
+{
+	if( !v || !stats ) return GERROR_NULL_STRUCTURE;
+
+#ifdef GENERICS_STATS
+	*stats = v->stats.counters;
+	stats->size = v->size;
+	return GERROR_OK;
+#else
+	return GERROR_UNSUPPORTED_OPERATION;
+#endif
+}
 
 /** Calculate the pointer at `index` position.
   *
@@ -230,7 +611,12 @@ gerror_t vector_add (vector_t* v, void* elem)
   */
 void* vector_ptr_at (vector_t* v, size_t index)
 {
-	if(index >= v->size || index >= v->buffer_size)
+	/*
+	 * the size is read before the buffer: a buffer published
+	 * before the size holds at least `size` elements
+	 */
+	size_t size = __atomic_load_n(&v->size, __ATOMIC_ACQUIRE);
+	if(index >= size)
 		return NULL;
-	return v->data + (index*v->member_size);
+	return __atomic_load_n(&v->data, __ATOMIC_ACQUIRE) + (index*v->member_size);
 }
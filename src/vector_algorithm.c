@@ -0,0 +1,961 @@
+/*
+ * This is free and unencumbered software released into the public domain.
+ *
+ * Anyone is free to copy, modify, publish, use, compile, sell, or
+ * distribute this software, either in source code form or as a compiled
+ * binary, for any purpose, commercial or non-commercial, and by any
+ * means.
+ *
+ * In jurisdictions that recognize copyright laws, the author or authors
+ * of this software dedicate any and all copyright interest in the
+ * software to the public domain. We make this dedication for the benefit
+ * of the public at large and to the detriment of our heirs and
+ * successors. We intend this dedication to be an overt act of
+ * relinquishment in perpetuity of all present and future rights to this
+ * software under copyright law.
+ *
+ * For more information, please refer to <http://unlicense.org/>
+ */
+#include <string.h>
+#include "vector_algorithm.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VECTOR_AVX2 __attribute__((target("avx2")))
+#define VECTOR_HAS_AVX2() __builtin_cpu_supports("avx2")
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define VECTOR_NEON
+#endif
+
+#define VECTOR_RADIX 256
+#define VECTOR_INSERTION_SORT 16
+#define VECTOR_SIGN32 ((uint32_t)1 << 31)
+#define VECTOR_SIGN64 ((uint64_t)1 << 63)
+
+/*
+ * auxiliar function;
+ * size in bytes of the elements of `type`, 0 for VECTOR_GENERIC
+ */
+size_t vector_type_size (vector_type_t type)
+{
+	switch( type ){
+	case VECTOR_INT32:
+	case VECTOR_UINT32:
+	case VECTOR_FLOAT:
+		return 4;
+	case VECTOR_INT64:
+	case VECTOR_UINT64:
+	case VECTOR_DOUBLE:
+		return 8;
+	default:
+		return 0;
+	}
+}
+
+/*
+ * auxiliar function;
+ * whether the elements of `v` can be of `type`, or can be
+ * compared by `compare` for VECTOR_GENERIC
+ */
+gerror_t vector_check_type (vector_t* v, vector_type_t type, compare_function compare)
+{
+	if( type == VECTOR_GENERIC )
+		return compare? GERROR_OK : GERROR_INVALID_ARGUMENT;
+	if( vector_type_size(type) != v->member_size )
+		return GERROR_INVALID_ARGUMENT;
+	return GERROR_OK;
+}
+
+#ifdef VECTOR_AVX2
+/*
+ * auxiliar function;
+ * index of the first block of 8 elements of `data` that has `x`,
+ * or of the first element after the last whole block
+ */
+VECTOR_AVX2 size_t vector_find32_avx2 (const uint32_t* data, size_t n, uint32_t x)
+{
+	__m256i key = _mm256_set1_epi32((int)x);
+	size_t i;
+
+	for( i=0; i+8<=n; i+=8 ){
+		__m256i cmp = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(data + i)), key);
+		if( _mm256_movemask_ps(_mm256_castsi256_ps(cmp)) )
+			break;
+	}
+	return i;
+}
+
+/*
+ * auxiliar function;
+ * as `vector_find32_avx2`, for blocks of 4 elements of 8 bytes
+ */
+VECTOR_AVX2 size_t vector_find64_avx2 (const uint64_t* data, size_t n, uint64_t x)
+{
+	__m256i key = _mm256_set1_epi64x((long long)x);
+	size_t i;
+
+	for( i=0; i+4<=n; i+=4 ){
+		__m256i cmp = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)(data + i)), key);
+		if( _mm256_movemask_pd(_mm256_castsi256_pd(cmp)) )
+			break;
+	}
+	return i;
+}
+#endif
+
+/*
+ * auxiliar function;
+ * index of the first `x` in the `n` elements of `data`, `n` in
+ * case there is none
+ */
+size_t vector_find32 (const uint32_t* data, size_t n, uint32_t x)
+{
+	size_t i = 0;
+
+#if defined(VECTOR_AVX2)
+	if( VECTOR_HAS_AVX2() )
+		i = vector_find32_avx2(data, n, x);
+#elif defined(VECTOR_NEON)
+	uint32x4_t key = vdupq_n_u32(x);
+	for( ; i+4<=n; i+=4 )
+		if( vmaxvq_u32(vceqq_u32(vld1q_u32(data + i), key)) )
+			break;
+#endif
+	for( ; i<n; i++ )
+		if( data[i] == x )
+			return i;
+	return n;
+}
+
+/*
+ * auxiliar function;
+ * as `vector_find32`, for elements of 8 bytes
+ */
+size_t vector_find64 (const uint64_t* data, size_t n, uint64_t x)
+{
+	size_t i = 0;
+
+#if defined(VECTOR_AVX2)
+	if( VECTOR_HAS_AVX2() )
+		i = vector_find64_avx2(data, n, x);
+#elif defined(VECTOR_NEON)
+	uint64x2_t key = vdupq_n_u64(x);
+	for( ; i+2<=n; i+=2 )
+		if( vmaxvq_u32(vreinterpretq_u32_u64(vceqq_u64(vld1q_u64(data + i), key))) )
+			break;
+#endif
+	for( ; i<n; i++ )
+		if( data[i] == x )
+			return i;
+	return n;
+}
+
+/** Finds the first element of `v` with the same bytes as `elem`.
+  * The floating types are compared by their bits, so 0.0 is not
+  * -0.0 and a NaN is found.
+  *
+  * @param v		a pointer to `vector_t`
+  * @param elem		pointer to the element to find
+  * @param index	pointer that receives the index of the
+  * 			element
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCTURE in case `v`, `elem` or
+  * 		`index` is a NULL pointer
+  * 		GERROR_ACCESS_OUT_OF_BOUND in case `elem` is not
+  * 		in `v`
+  */
+gerror_t vector_find (vector_t* v, void* elem, size_t* index)
+{
+	if( !v || !elem || !index ) return GERROR_NULL_STRUCTURE;
+
+	size_t i;
+	if( v->member_size == 4 ){
+		uint32_t x;
+		memcpy(&x, elem, 4);
+		i = vector_find32((const uint32_t*) v->data, v->size, x);
+	}else if( v->member_size == 8 ){
+		uint64_t x;
+		memcpy(&x, elem, 8);
+		i = vector_find64((const uint64_t*) v->data, v->size, x);
+	}else{
+		for( i=0; i<v->size; i++ )
+			if( !memcmp((char*) v->data + i*v->member_size, elem, v->member_size) )
+				break;
+	}
+
+	if( i == v->size ) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	*index = i;
+	return GERROR_OK;
+}
+
+/** Counts the elements of `v` for which `predicate` is non-zero.
+  *
+  * @param v		a pointer to `vector_t`
+  * @param predicate	function called on every element
+  * @param argument	last argument of `predicate`
+  * @param count	pointer that receives the count
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCTURE in case `v`, `predicate`
+  * 		or `count` is a NULL pointer
+  */
+gerror_t vector_count_if (vector_t* v, vector_predicate_function predicate, void* argument,
+		size_t* count)
+{
+	if( !v || !predicate || !count ) return GERROR_NULL_STRUCTURE;
+
+	size_t i, c = 0;
+	for( i=0; i<v->size; i++ )
+		if( predicate((char*) v->data + i*v->member_size, argument) )
+			c++;
+
+	*count = c;
+	return GERROR_OK;
+}
+
+#ifdef VECTOR_AVX2
+/*
+ * auxiliar function;
+ * counts the elements of the whole blocks of 8 of `data` in
+ * [`low`, `high`], compared as signed after a xor with `flip`
+ *
+ * @return the number of elements read
+ */
+VECTOR_AVX2 size_t vector_count32_avx2 (const uint32_t* data, size_t n, uint32_t low,
+		uint32_t high, uint32_t flip, size_t* count)
+{
+	__m256i f = _mm256_set1_epi32((int)flip);
+	__m256i l = _mm256_set1_epi32((int)(low ^ flip));
+	__m256i h = _mm256_set1_epi32((int)(high ^ flip));
+	size_t i, c = 0;
+
+	for( i=0; i+8<=n; i+=8 ){
+		__m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(data + i)), f);
+		__m256i out = _mm256_or_si256(_mm256_cmpgt_epi32(l, x), _mm256_cmpgt_epi32(x, h));
+		c += 8 - __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(out)));
+	}
+	*count += c;
+	return i;
+}
+
+/*
+ * auxiliar function;
+ * as `vector_count32_avx2`, for blocks of 4 elements of 8 bytes
+ */
+VECTOR_AVX2 size_t vector_count64_avx2 (const uint64_t* data, size_t n, uint64_t low,
+		uint64_t high, uint64_t flip, size_t* count)
+{
+	__m256i f = _mm256_set1_epi64x((long long)flip);
+	__m256i l = _mm256_set1_epi64x((long long)(low ^ flip));
+	__m256i h = _mm256_set1_epi64x((long long)(high ^ flip));
+	size_t i, c = 0;
+
+	for( i=0; i+4<=n; i+=4 ){
+		__m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(data + i)), f);
+		__m256i out = _mm256_or_si256(_mm256_cmpgt_epi64(l, x), _mm256_cmpgt_epi64(x, h));
+		c += 4 - __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(out)));
+	}
+	*count += c;
+	return i;
+}
+
+/*
+ * auxiliar function;
+ * as `vector_count32_avx2`, for floats
+ */
+VECTOR_AVX2 size_t vector_count_float_avx2 (const float* data, size_t n, float low,
+		float high, size_t* count)
+{
+	__m256 l = _mm256_set1_ps(low), h = _mm256_set1_ps(high);
+	size_t i, c = 0;
+
+	for( i=0; i+8<=n; i+=8 ){
+		__m256 x = _mm256_loadu_ps(data + i);
+		__m256 in = _mm256_and_ps(_mm256_cmp_ps(x, l, _CMP_GE_OQ), _mm256_cmp_ps(x, h, _CMP_LE_OQ));
+		c += __builtin_popcount(_mm256_movemask_ps(in));
+	}
+	*count += c;
+	return i;
+}
+
+/*
+ * auxiliar function;
+ * as `vector_count32_avx2`, for doubles
+ */
+VECTOR_AVX2 size_t vector_count_double_avx2 (const double* data, size_t n, double low,
+		double high, size_t* count)
+{
+	__m256d l = _mm256_set1_pd(low), h = _mm256_set1_pd(high);
+	size_t i, c = 0;
+
+	for( i=0; i+4<=n; i+=4 ){
+		__m256d x = _mm256_loadu_pd(data + i);
+		__m256d in = _mm256_and_pd(_mm256_cmp_pd(x, l, _CMP_GE_OQ), _mm256_cmp_pd(x, h, _CMP_LE_OQ));
+		c += __builtin_popcount(_mm256_movemask_pd(in));
+	}
+	*count += c;
+	return i;
+}
+#endif
+
+/*
+ * auxiliar function;
+ * counts the elements of type `T` of `data` from `i` to `n` in
+ * [`low`, `high`]
+ */
+#define VECTOR_COUNT_RANGE(T, data, i, n, low, high, c) do{ \
+		const T* d_ = (const T*)(data); \
+		T l_, h_; \
+		memcpy(&l_, (low), sizeof(T)); \
+		memcpy(&h_, (high), sizeof(T)); \
+		for( ; (i)<(n); (i)++ ) \
+			(c) += d_[i] >= l_ && d_[i] <= h_; \
+	}while(0)
+
+/** Counts the elements of `v`, of `type`, that are at least
+  * `low` and at most `high`. `low` equal to `high` counts the
+  * elements equal to it.
+  *
+  * @param v		a pointer to `vector_t`
+  * @param type		type of the elements, not VECTOR_GENERIC
+  * @param low		pointer to the lower bound
+  * @param high		pointer to the upper bound
+  * @param count	pointer that receives the count
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCTURE in case `v`, `low`, `high`
+  * 		or `count` is a NULL pointer
+  * 		GERROR_INVALID_ARGUMENT in case `type` is not
+  * 		the type of the elements of `v`
+  */
+gerror_t vector_count_range (vector_t* v, vector_type_t type, void* low, void* high,
+		size_t* count)
+{
+	if( !v || !low || !high || !count ) return GERROR_NULL_STRUCTURE;
+	if( type == VECTOR_GENERIC ) return GERROR_INVALID_ARGUMENT;
+
+	gerror_t s = vector_check_type(v, type, NULL);
+	if( s != GERROR_OK ) return s;
+
+	size_t i = 0, n = v->size, c = 0;
+	void* data = v->data;
+
+#if defined(VECTOR_AVX2)
+	if( VECTOR_HAS_AVX2() ){
+		uint32_t l32, h32;
+		uint64_t l64, h64;
+		float lf, hf;
+		double ld, hd;
+
+		switch( type ){
+		case VECTOR_INT32:
+		case VECTOR_UINT32:
+			memcpy(&l32, low, 4);
+			memcpy(&h32, high, 4);
+			i = vector_count32_avx2((const uint32_t*) data, n, l32, h32,
+					type == VECTOR_UINT32? VECTOR_SIGN32 : 0, &c);
+			break;
+		case VECTOR_INT64:
+		case VECTOR_UINT64:
+			memcpy(&l64, low, 8);
+			memcpy(&h64, high, 8);
+			i = vector_count64_avx2((const uint64_t*) data, n, l64, h64,
+					type == VECTOR_UINT64? VECTOR_SIGN64 : 0, &c);
+			break;
+		case VECTOR_FLOAT:
+			memcpy(&lf, low, 4);
+			memcpy(&hf, high, 4);
+			i = vector_count_float_avx2((const float*) data, n, lf, hf, &c);
+			break;
+		case VECTOR_DOUBLE:
+			memcpy(&ld, low, 8);
+			memcpy(&hd, high, 8);
+			i = vector_count_double_avx2((const double*) data, n, ld, hd, &c);
+			break;
+		default:
+			break;
+		}
+	}
+#elif defined(VECTOR_NEON)
+	if( type == VECTOR_INT32 ){
+		int32x4_t l = vld1q_dup_s32((const int32_t*) low), h = vld1q_dup_s32((const int32_t*) high);
+		for( ; i+4<=n; i+=4 ){
+			int32x4_t x = vld1q_s32((const int32_t*) data + i);
+			c += vaddvq_u32(vshrq_n_u32(vandq_u32(vcgeq_s32(x, l), vcleq_s32(x, h)), 31));
+		}
+	}else if( type == VECTOR_FLOAT ){
+		float32x4_t l = vld1q_dup_f32((const float*) low), h = vld1q_dup_f32((const float*) high);
+		for( ; i+4<=n; i+=4 ){
+			float32x4_t x = vld1q_f32((const float*) data + i);
+			c += vaddvq_u32(vshrq_n_u32(vandq_u32(vcgeq_f32(x, l), vcleq_f32(x, h)), 31));
+		}
+	}
+#endif
+
+	switch( type ){
+	case VECTOR_INT32: VECTOR_COUNT_RANGE(int32_t, data, i, n, low, high, c); break;
+	case VECTOR_UINT32: VECTOR_COUNT_RANGE(uint32_t, data, i, n, low, high, c); break;
+	case VECTOR_INT64: VECTOR_COUNT_RANGE(int64_t, data, i, n, low, high, c); break;
+	case VECTOR_UINT64: VECTOR_COUNT_RANGE(uint64_t, data, i, n, low, high, c); break;
+	case VECTOR_FLOAT: VECTOR_COUNT_RANGE(float, data, i, n, low, high, c); break;
+	case VECTOR_DOUBLE: VECTOR_COUNT_RANGE(double, data, i, n, low, high, c); break;
+	default: break;
+	}
+
+	*count = c;
+	return GERROR_OK;
+}
+
+/** Writes `elem` in every element of `v`. The elements of 4 and
+  * 8 bytes are stored by a loop the compiler vectorizes, the
+  * others by copies that double in size.
+  *
+  * @param v		a pointer to `vector_t`
+  * @param elem		pointer to the element to write
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCTURE in case `v` or `elem` is a
+  * 		NULL pointer
+  * 		GERROR_UNSUPPORTED_OPERATION in case `v` has an
+  * 		epoch
+  */
+gerror_t vector_fill (vector_t* v, void* elem)
+{
+	if( !v || !elem ) return GERROR_NULL_STRUCTURE;
+	if( v->epoch ) return GERROR_UNSUPPORTED_OPERATION;
+
+	size_t i, n = v->size;
+	if( !n || !v->member_size ) return GERROR_OK;
+
+	if( v->member_size == 4 ){
+		uint32_t x, *d = (uint32_t*) v->data;
+		memcpy(&x, elem, 4);
+		for( i=0; i<n; i++ )
+			d[i] = x;
+	}else if( v->member_size == 8 ){
+		uint64_t x, *d = (uint64_t*) v->data;
+		memcpy(&x, elem, 8);
+		for( i=0; i<n; i++ )
+			d[i] = x;
+	}else{
+		char* d = (char*) v->data;
+		size_t done = v->member_size, total = n*v->member_size;
+
+		/* `elem` may be an element of `v` */
+		memmove(d, elem, v->member_size);
+		while( done < total ){
+			size_t k = done < total - done? done : total - done;
+			memcpy(d + done, d, k);
+			done += k;
+		}
+	}
+
+	return GERROR_OK;
+}
+
+#ifdef VECTOR_AVX2
+/*
+ * auxiliar function;
+ * smallest and largest element of the whole blocks of 8 of
+ * `data`, compared as signed after a xor with `flip`; `n` is at
+ * least 8
+ *
+ * @return the number of elements read
+ */
+VECTOR_AVX2 size_t vector_min_max32_avx2 (const uint32_t* data, size_t n, uint32_t flip,
+		uint32_t* min, uint32_t* max)
+{
+	__m256i f = _mm256_set1_epi32((int)flip);
+	__m256i lo = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*) data), f), hi = lo;
+	int32_t l[8], h[8];
+	size_t i;
+
+	for( i=8; i+8<=n; i+=8 ){
+		__m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(data + i)), f);
+		lo = _mm256_min_epi32(lo, x);
+		hi = _mm256_max_epi32(hi, x);
+	}
+
+	_mm256_storeu_si256((__m256i*) l, lo);
+	_mm256_storeu_si256((__m256i*) h, hi);
+	int32_t a = l[0], b = h[0];
+	int k;
+	for( k=1; k<8; k++ ){
+		if( l[k] < a ) a = l[k];
+		if( h[k] > b ) b = h[k];
+	}
+	*min = (uint32_t)a ^ flip;
+	*max = (uint32_t)b ^ flip;
+	return i;
+}
+
+/*
+ * auxiliar function;
+ * as `vector_min_max32_avx2`, for blocks of 4 elements of 8
+ * bytes; `n` is at least 4
+ */
+VECTOR_AVX2 size_t vector_min_max64_avx2 (const uint64_t* data, size_t n, uint64_t flip,
+		uint64_t* min, uint64_t* max)
+{
+	__m256i f = _mm256_set1_epi64x((long long)flip);
+	__m256i lo = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*) data), f), hi = lo;
+	int64_t l[4], h[4];
+	size_t i;
+
+	for( i=4; i+4<=n; i+=4 ){
+		__m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(data + i)), f);
+		lo = _mm256_blendv_epi8(lo, x, _mm256_cmpgt_epi64(lo, x));
+		hi = _mm256_blendv_epi8(hi, x, _mm256_cmpgt_epi64(x, hi));
+	}
+
+	_mm256_storeu_si256((__m256i*) l, lo);
+	_mm256_storeu_si256((__m256i*) h, hi);
+	int64_t a = l[0], b = h[0];
+	int k;
+	for( k=1; k<4; k++ ){
+		if( l[k] < a ) a = l[k];
+		if( h[k] > b ) b = h[k];
+	}
+	*min = (uint64_t)a ^ flip;
+	*max = (uint64_t)b ^ flip;
+	return i;
+}
+
+/*
+ * auxiliar function;
+ * as `vector_min_max32_avx2`, for floats
+ */
+VECTOR_AVX2 size_t vector_min_max_float_avx2 (const float* data, size_t n, float* min, float* max)
+{
+	__m256 lo = _mm256_loadu_ps(data), hi = lo;
+	float l[8], h[8];
+	size_t i;
+
+	for( i=8; i+8<=n; i+=8 ){
+		__m256 x = _mm256_loadu_ps(data + i);
+		lo = _mm256_min_ps(lo, x);
+		hi = _mm256_max_ps(hi, x);
+	}
+
+	_mm256_storeu_ps(l, lo);
+	_mm256_storeu_ps(h, hi);
+	float a = l[0], b = h[0];
+	int k;
+	for( k=1; k<8; k++ ){
+		if( l[k] < a ) a = l[k];
+		if( h[k] > b ) b = h[k];
+	}
+	*min = a;
+	*max = b;
+	return i;
+}
+
+/*
+ * auxiliar function;
+ * as `vector_min_max32_avx2`, for doubles
+ */
+VECTOR_AVX2 size_t vector_min_max_double_avx2 (const double* data, size_t n, double* min, double* max)
+{
+	__m256d lo = _mm256_loadu_pd(data), hi = lo;
+	double l[4], h[4];
+	size_t i;
+
+	for( i=4; i+4<=n; i+=4 ){
+		__m256d x = _mm256_loadu_pd(data + i);
+		lo = _mm256_min_pd(lo, x);
+		hi = _mm256_max_pd(hi, x);
+	}
+
+	_mm256_storeu_pd(l, lo);
+	_mm256_storeu_pd(h, hi);
+	double a = l[0], b = h[0];
+	int k;
+	for( k=1; k<4; k++ ){
+		if( l[k] < a ) a = l[k];
+		if( h[k] > b ) b = h[k];
+	}
+	*min = a;
+	*max = b;
+	return i;
+}
+#endif
+
+/*
+ * auxiliar function;
+ * smallest and largest elements of type `T` of `data`, the ones
+ * before `i` already in `min` and `max`
+ */
+#define VECTOR_MIN_MAX(T, data, i, n, min, max) do{ \
+		const T* d_ = (const T*)(data); \
+		T l_, h_; \
+		if( !(i) ){ \
+			l_ = h_ = d_[0]; \
+			(i) = 1; \
+		}else{ \
+			memcpy(&l_, (min), sizeof(T)); \
+			memcpy(&h_, (max), sizeof(T)); \
+		} \
+		for( ; (i)<(n); (i)++ ){ \
+			if( d_[i] < l_ ) l_ = d_[i]; \
+			if( d_[i] > h_ ) h_ = d_[i]; \
+		} \
+		memcpy((min), &l_, sizeof(T)); \
+		memcpy((max), &h_, sizeof(T)); \
+	}while(0)
+
+/** Finds the smallest and the largest elements of `v`, of `type`,
+  * or the first and the last in the order of `compare` for
+  * VECTOR_GENERIC. The result of the floating types is
+  * unspecified when `v` has NaNs.
+  *
+  * @param v		a pointer to `vector_t`
+  * @param type		type of the elements
+  * @param compare	compare function of VECTOR_GENERIC, it
+  * 			is ignored for the other types
+  * @param argument	last argument of `compare`
+  * @param min		pointer that receives the smallest
+  * 			element or NULL
+  * @param max		pointer that receives the largest
+  * 			element or NULL
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCTURE in case `v` is a NULL
+  * 		pointer
+  * 		GERROR_INVALID_ARGUMENT in case `type` is not
+  * 		the type of the elements of `v` or there is no
+  * 		`compare` for VECTOR_GENERIC
+  * 		GERROR_ACCESS_OUT_OF_BOUND in case `v` is empty
+  */
+gerror_t vector_min_max (vector_t* v, vector_type_t type, compare_function compare,
+		void* argument, void* min, void* max)
+{
+	if( !v ) return GERROR_NULL_STRUCTURE;
+
+	gerror_t s = vector_check_type(v, type, compare);
+	if( s != GERROR_OK ) return s;
+	if( !v->size ) return GERROR_ACCESS_OUT_OF_BOUND;
+
+	size_t i = 0, n = v->size, ms = v->member_size;
+	char* data = (char*) v->data;
+
+	if( type == VECTOR_GENERIC ){
+		char* lo = data, *hi = data;
+		for( i=1; i<n; i++ ){
+			char* x = data + i*ms;
+			if( compare(x, lo, argument) < 0 ) lo = x;
+			if( compare(x, hi, argument) > 0 ) hi = x;
+		}
+		if( min ) memcpy(min, lo, ms);
+		if( max ) memcpy(max, hi, ms);
+		return GERROR_OK;
+	}
+
+	/* 8 bytes of room for the elements of any numeric type */
+	uint64_t lo, hi;
+
+#if defined(VECTOR_AVX2)
+	if( VECTOR_HAS_AVX2() && n >= 32/ms ){
+		switch( type ){
+		case VECTOR_INT32:
+		case VECTOR_UINT32:
+			i = vector_min_max32_avx2((const uint32_t*) data, n,
+					type == VECTOR_UINT32? VECTOR_SIGN32 : 0,
+					(uint32_t*) &lo, (uint32_t*) &hi);
+			break;
+		case VECTOR_INT64:
+		case VECTOR_UINT64:
+			i = vector_min_max64_avx2((const uint64_t*) data, n,
+					type == VECTOR_UINT64? VECTOR_SIGN64 : 0, &lo, &hi);
+			break;
+		case VECTOR_FLOAT:
+			i = vector_min_max_float_avx2((const float*) data, n, (float*) &lo, (float*) &hi);
+			break;
+		case VECTOR_DOUBLE:
+			i = vector_min_max_double_avx2((const double*) data, n, (double*) &lo, (double*) &hi);
+			break;
+		default:
+			break;
+		}
+	}
+#elif defined(VECTOR_NEON)
+	if( n >= 4 && (type == VECTOR_INT32 || type == VECTOR_FLOAT) ){
+		if( type == VECTOR_INT32 ){
+			int32x4_t l = vld1q_s32((const int32_t*) data), h = l;
+			for( i=4; i+4<=n; i+=4 ){
+				int32x4_t x = vld1q_s32((const int32_t*) data + i);
+				l = vminq_s32(l, x);
+				h = vmaxq_s32(h, x);
+			}
+			*(int32_t*) &lo = vminvq_s32(l);
+			*(int32_t*) &hi = vmaxvq_s32(h);
+		}else{
+			float32x4_t l = vld1q_f32((const float*) data), h = l;
+			for( i=4; i+4<=n; i+=4 ){
+				float32x4_t x = vld1q_f32((const float*) data + i);
+				l = vminq_f32(l, x);
+				h = vmaxq_f32(h, x);
+			}
+			*(float*) &lo = vminvq_f32(l);
+			*(float*) &hi = vmaxvq_f32(h);
+		}
+	}
+#endif
+
+	switch( type ){
+	case VECTOR_INT32: VECTOR_MIN_MAX(int32_t, data, i, n, &lo, &hi); break;
+	case VECTOR_UINT32: VECTOR_MIN_MAX(uint32_t, data, i, n, &lo, &hi); break;
+	case VECTOR_INT64: VECTOR_MIN_MAX(int64_t, data, i, n, &lo, &hi); break;
+	case VECTOR_UINT64: VECTOR_MIN_MAX(uint64_t, data, i, n, &lo, &hi); break;
+	case VECTOR_FLOAT: VECTOR_MIN_MAX(float, data, i, n, &lo, &hi); break;
+	case VECTOR_DOUBLE: VECTOR_MIN_MAX(double, data, i, n, &lo, &hi); break;
+	default: break;
+	}
+
+	if( min ) memcpy(min, &lo, ms);
+	if( max ) memcpy(max, &hi, ms);
+	return GERROR_OK;
+}
+
+/*
+ * auxiliar function;
+ * maps the elements of 4 bytes of `type` to unsigned keys in
+ * the same order, or back in case `inverse` is set
+ */
+void vector_radix_keys32 (uint32_t* data, size_t n, vector_type_t type, int inverse)
+{
+	size_t i;
+
+	if( type == VECTOR_INT32 ){
+		for( i=0; i<n; i++ )
+			data[i] ^= VECTOR_SIGN32;
+	}else if( type == VECTOR_FLOAT ){
+		/* the negative floats are in the reverse order of their bits */
+		for( i=0; i<n; i++ ){
+			uint32_t x = data[i];
+			if( inverse )
+				data[i] = (x & VECTOR_SIGN32)? x ^ VECTOR_SIGN32 : ~x;
+			else
+				data[i] = (x & VECTOR_SIGN32)? ~x : x ^ VECTOR_SIGN32;
+		}
+	}
+}
+
+/*
+ * auxiliar function;
+ * as `vector_radix_keys32`, for elements of 8 bytes
+ */
+void vector_radix_keys64 (uint64_t* data, size_t n, vector_type_t type, int inverse)
+{
+	size_t i;
+
+	if( type == VECTOR_INT64 ){
+		for( i=0; i<n; i++ )
+			data[i] ^= VECTOR_SIGN64;
+	}else if( type == VECTOR_DOUBLE ){
+		for( i=0; i<n; i++ ){
+			uint64_t x = data[i];
+			if( inverse )
+				data[i] = (x & VECTOR_SIGN64)? x ^ VECTOR_SIGN64 : ~x;
+			else
+				data[i] = (x & VECTOR_SIGN64)? ~x : x ^ VECTOR_SIGN64;
+		}
+	}
+}
+
+/*
+ * auxiliar function;
+ * LSD radix sort of the unsigned keys of `data`, a byte at a
+ * time, through `buffer` of `n` keys; the bytes equal in all the
+ * keys are skipped
+ */
+void vector_radix_sort32 (uint32_t* data, uint32_t* buffer, size_t n)
+{
+	size_t count[4][VECTOR_RADIX];
+	uint32_t* from = data, *to = buffer, *swap;
+	size_t i, sum;
+	int d, shift;
+
+	memset(count, 0, sizeof(count));
+	for( i=0; i<n; i++ )
+		for( d=0; d<4; d++ )
+			count[d][(data[i] >> 8*d) & 0xFF]++;
+
+	for( d=0; d<4; d++ ){
+		shift = 8*d;
+		if( count[d][(from[0] >> shift) & 0xFF] == n )
+			continue;
+
+		for( i=0, sum=0; i<VECTOR_RADIX; i++ ){
+			size_t c = count[d][i];
+			count[d][i] = sum;
+			sum += c;
+		}
+		for( i=0; i<n; i++ )
+			to[count[d][(from[i] >> shift) & 0xFF]++] = from[i];
+
+		swap = from;
+		from = to;
+		to = swap;
+	}
+
+	if( from != data )
+		memcpy(data, from, n*sizeof(uint32_t));
+}
+
+/*
+ * auxiliar function;
+ * as `vector_radix_sort32`, for keys of 8 bytes
+ */
+void vector_radix_sort64 (uint64_t* data, uint64_t* buffer, size_t n)
+{
+	size_t count[8][VECTOR_RADIX];
+	uint64_t* from = data, *to = buffer, *swap;
+	size_t i, sum;
+	int d, shift;
+
+	memset(count, 0, sizeof(count));
+	for( i=0; i<n; i++ )
+		for( d=0; d<8; d++ )
+			count[d][(data[i] >> 8*d) & 0xFF]++;
+
+	for( d=0; d<8; d++ ){
+		shift = 8*d;
+		if( count[d][(from[0] >> shift) & 0xFF] == n )
+			continue;
+
+		for( i=0, sum=0; i<VECTOR_RADIX; i++ ){
+			size_t c = count[d][i];
+			count[d][i] = sum;
+			sum += c;
+		}
+		for( i=0; i<n; i++ )
+			to[count[d][(from[i] >> shift) & 0xFF]++] = from[i];
+
+		swap = from;
+		from = to;
+		to = swap;
+	}
+
+	if( from != data )
+		memcpy(data, from, n*sizeof(uint64_t));
+}
+
+/*
+ * auxiliar function;
+ * stable insertion sort of the `n` elements of `data`, `tmp`
+ * has room for one element
+ */
+void vector_insertion_sort (char* data, size_t n, size_t ms, char* tmp,
+		compare_function compare, void* argument)
+{
+	size_t i, j;
+
+	for( i=1; i<n; i++ ){
+		char* x = data + i*ms;
+		for( j=i; j>0 && compare(x, data + (j-1)*ms, argument) < 0; j-- )
+			;
+		if( j == i ) continue;
+
+		memcpy(tmp, x, ms);
+		memmove(data + (j+1)*ms, data + j*ms, (i-j)*ms);
+		memcpy(data + j*ms, tmp, ms);
+	}
+}
+
+/*
+ * auxiliar function;
+ * stable bottom-up merge sort of the `n` elements of `data`
+ * through `buffer`, that has room for `n` + 1 elements; the
+ * runs of VECTOR_INSERTION_SORT elements are sorted by insertion
+ */
+void vector_merge_sort (char* data, char* buffer, size_t n, size_t ms,
+		compare_function compare, void* argument)
+{
+	char* from = data, *to = buffer, *swap;
+	size_t width, lo;
+
+	for( lo=0; lo<n; lo+=VECTOR_INSERTION_SORT )
+		vector_insertion_sort(data + lo*ms,
+				n - lo < VECTOR_INSERTION_SORT? n - lo : VECTOR_INSERTION_SORT,
+				ms, buffer + n*ms, compare, argument);
+
+	for( width=VECTOR_INSERTION_SORT; width<n; width*=2 ){
+		for( lo=0; lo<n; lo+=2*width ){
+			size_t mid = lo + width < n? lo + width : n;
+			size_t hi = lo + 2*width < n? lo + 2*width : n;
+			size_t a = lo, b = mid, k = lo;
+
+			while( a < mid && b < hi ){
+				if( compare(from + b*ms, from + a*ms, argument) < 0 )
+					memcpy(to + (k++)*ms, from + (b++)*ms, ms);
+				else
+					memcpy(to + (k++)*ms, from + (a++)*ms, ms);
+			}
+			memcpy(to + k*ms, from + a*ms, (mid - a)*ms);
+			k += mid - a;
+			memcpy(to + k*ms, from + b*ms, (hi - b)*ms);
+		}
+
+		swap = from;
+		from = to;
+		to = swap;
+	}
+
+	if( from != data )
+		memcpy(data, from, n*ms);
+}
+
+/** Sorts the elements of `v` in ascending order. The numeric
+  * types are sorted by an LSD radix sort of their bits, a byte
+  * at a time; VECTOR_GENERIC elements by a stable merge sort in
+  * the order of `compare`. It uses a buffer of the size of the
+  * elements, from the allocator of `v`.
+  *
+  * @param v		a pointer to `vector_t`
+  * @param type		type of the elements
+  * @param compare	compare function of VECTOR_GENERIC, it
+  * 			is ignored for the other types
+  * @param argument	last argument of `compare`
+  *
+  * @return	GERROR_OK in case of success operation;
+  * 		GERROR_NULL_STRUCTURE in case `v` is a NULL
+  * 		pointer
+  * 		GERROR_INVALID_ARGUMENT in case `type` is not
+  * 		the type of the elements of `v` or there is no
+  * 		`compare` for VECTOR_GENERIC
+  * 		GERROR_UNSUPPORTED_OPERATION in case `v` has an
+  * 		epoch
+  */
+gerror_t vector_sort (vector_t* v, vector_type_t type, compare_function compare,
+		void* argument)
+{
+	if( !v ) return GERROR_NULL_STRUCTURE;
+	if( v->epoch ) return GERROR_UNSUPPORTED_OPERATION;
+
+	gerror_t s = vector_check_type(v, type, compare);
+	if( s != GERROR_OK ) return s;
+
+	size_t n = v->size, ms = v->member_size;
+	if( n < 2 || !ms ) return GERROR_OK;
+
+	size_t bytes = (type == VECTOR_GENERIC? n + 1 : n)*ms;
+	void* buffer = GALLOC_ALLOC(v->allocator, bytes);
+
+	if( type == VECTOR_GENERIC ){
+		vector_merge_sort((char*) v->data, (char*) buffer, n, ms, compare, argument);
+	}else if( ms == 4 ){
+		vector_radix_keys32((uint32_t*) v->data, n, type, 0);
+		vector_radix_sort32((uint32_t*) v->data, (uint32_t*) buffer, n);
+		vector_radix_keys32((uint32_t*) v->data, n, type, 1);
+	}else{
+		vector_radix_keys64((uint64_t*) v->data, n, type, 0);
+		vector_radix_sort64((uint64_t*) v->data, (uint64_t*) buffer, n);
+		vector_radix_keys64((uint64_t*) v->data, n, type, 1);
+	}
+
+	GALLOC_FREE(v->allocator, buffer, bytes);
+	return GERROR_OK;
+}